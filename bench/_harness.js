@@ -0,0 +1,74 @@
+// Timing helpers shared by the benchmarks in this directory.
+//
+// A benchmark file exports an object of cases, keyed by name:
+//
+//   module.exports = {
+//     'read 256x256': {
+//       setup: function() { return context; },     // optional, not timed
+//       beforeSample: function(context) { ... },   // optional, not timed, called before each fn call
+//       fn: function(context) { ... },             // timed
+//       ops: 1,                                    // operations done by one call of fn (or function(context))
+//       teardown: function(context) { ... }        // optional, not timed
+//     }
+//   };
+
+'use strict';
+
+var DEFAULT_TIME = 1;         // seconds spent sampling each case
+var DEFAULT_MIN_SAMPLES = 20;
+
+function now() {
+	var t = process.hrtime();
+	return t[0] + t[1] / 1e9;
+}
+
+function percentile(sorted, p) {
+	if (!sorted.length) return 0;
+	var i = Math.min(sorted.length - 1, Math.max(0, Math.ceil(p * sorted.length) - 1));
+	return sorted[i];
+}
+
+function rss() {
+	if (typeof gc === 'function') gc();
+	return process.memoryUsage().rss;
+}
+
+// runs a single case and returns its statistics (times are in microseconds per op)
+exports.run = function(name, bench, options) {
+	options = options || {};
+	var max_time = options.time || DEFAULT_TIME;
+	var min_samples = options.minSamples || DEFAULT_MIN_SAMPLES;
+	var ops = bench.ops || 1;
+	var context = bench.setup ? bench.setup() : undefined;
+	if (typeof ops === 'function') ops = ops(context);
+
+	// warm up (lets V8 optimize the JS side and GDAL fill its caches)
+	var warmup_end = now() + Math.min(0.1, max_time / 10);
+	do { bench.fn(context); } while (now() < warmup_end);
+
+	var rss_before = rss();
+	var samples = [];
+	var total = 0;
+	while (total < max_time || samples.length < min_samples) {
+		if (bench.beforeSample) bench.beforeSample(context);
+		var start = now();
+		bench.fn(context);
+		var elapsed = now() - start;
+		samples.push(elapsed / ops * 1e6);
+		total += elapsed;
+	}
+	var rss_after = rss();
+
+	if (bench.teardown) bench.teardown(context);
+
+	samples.sort(function(a, b) { return a - b; });
+	return {
+		name: name,
+		ops_per_sec: samples.length * ops / total,
+		p50_us: percentile(samples, 0.5),
+		p99_us: percentile(samples, 0.99),
+		samples: samples.length,
+		ops: samples.length * ops,
+		rss_delta: rss_after - rss_before
+	};
+};
@@ -0,0 +1,47 @@
+// Iterating a layer with LayerFeatures.next() and converting the attributes
+// with FeatureFields.toJSON(). One op is one feature.
+
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+
+var FILE = __dirname + '/../test/data/shp/sample.shp';
+
+function setup() {
+	var ds = gdal.open(FILE);
+	var layer = ds.layers.get(0);
+	return {ds: ds, layer: layer, count: layer.features.count()};
+}
+
+function teardown(ctx) {
+	ctx.ds.close();
+}
+
+function count(ctx) {
+	return ctx.count;
+}
+
+module.exports = {
+	'features.next': {
+		setup: setup,
+		fn: function(ctx) {
+			var feature;
+			ctx.layer.features.reset();
+			while ((feature = ctx.layer.features.next())) {}
+		},
+		ops: count,
+		teardown: teardown
+	},
+	'features.next + fields.toJSON': {
+		setup: setup,
+		fn: function(ctx) {
+			var feature;
+			ctx.layer.features.reset();
+			while ((feature = ctx.layer.features.next())) {
+				feature.fields.toJSON();
+			}
+		},
+		ops: count,
+		teardown: teardown
+	}
+};
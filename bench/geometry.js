@@ -0,0 +1,40 @@
+// Geometry.fromWKB() / Geometry.toWKB() round trips using the geometries of
+// a test shapefile. One op is one geometry.
+
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+
+var FILE = __dirname + '/../test/data/shp/sample.shp';
+
+function setup() {
+	var ds = gdal.open(FILE);
+	var geometries = [];
+	var wkbs = [];
+	ds.layers.get(0).features.forEach(function(feature) {
+		var geom = feature.getGeometry();
+		if (!geom) return;
+		geom = geom.clone();
+		geometries.push(geom);
+		wkbs.push(geom.toWKB());
+	});
+	ds.close();
+	return {geometries: geometries, wkbs: wkbs};
+}
+
+module.exports = {
+	'fromWKB': {
+		setup: setup,
+		fn: function(ctx) {
+			for (var i = 0; i < ctx.wkbs.length; i++) gdal.Geometry.fromWKB(ctx.wkbs[i]);
+		},
+		ops: function(ctx) { return ctx.wkbs.length; }
+	},
+	'toWKB': {
+		setup: setup,
+		fn: function(ctx) {
+			for (var i = 0; i < ctx.geometries.length; i++) ctx.geometries[i].toWKB();
+		},
+		ops: function(ctx) { return ctx.geometries.length; }
+	}
+};
@@ -0,0 +1,39 @@
+// How fast native objects are wrapped and looked up through the
+// ObjectCache (src/obj_cache.hpp).
+
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+
+var N_LAYERS = 2000;
+
+module.exports = {
+	// lookup of an existing wrapper
+	'lookup': {
+		setup: function() {
+			return gdal.open('temp', 'w', 'MEM', 1, 1, 1, gdal.GDT_Byte);
+		},
+		fn: function(ds) {
+			for (var i = 0; i < 10000; i++) ds.bands.get(1);
+		},
+		ops: 10000
+	},
+
+	// wrapping of objects that haven't been seen yet (wrappers are collected between samples)
+	'wrap': {
+		setup: function() {
+			var ds = gdal.open('', 'w', 'Memory');
+			for (var i = 0; i < N_LAYERS; i++) {
+				ds.layers.create('layer' + i, null, gdal.Point);
+			}
+			return ds;
+		},
+		beforeSample: function() {
+			if (typeof gc === 'function') gc();
+		},
+		fn: function(ds) {
+			for (var i = 0; i < N_LAYERS; i++) ds.layers.get(i);
+		},
+		ops: N_LAYERS
+	}
+};
@@ -0,0 +1,45 @@
+// RasterBandPixels.read() at several window sizes. The same array is reused
+// between reads so the numbers reflect I/O rather than allocation.
+
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+
+var FILE = __dirname + '/../test/data/sample.tif';
+
+function readWindow(size) {
+	return {
+		setup: function() {
+			var ds = gdal.open(FILE);
+			var band = ds.bands.get(1);
+			var w = Math.min(size, band.size.x);
+			var h = Math.min(size, band.size.y);
+			return {
+				ds: ds,
+				band: band,
+				w: w,
+				h: h,
+				max_x: band.size.x - w,
+				max_y: band.size.y - h,
+				data: new Uint8Array(w * h),
+				i: 0
+			};
+		},
+		fn: function(ctx) {
+			// walk the window diagonally so reads aren't all served from the same blocks
+			var x = (ctx.i * 37) % (ctx.max_x + 1);
+			var y = (ctx.i * 53) % (ctx.max_y + 1);
+			ctx.i++;
+			ctx.band.pixels.read(x, y, ctx.w, ctx.h, ctx.data);
+		},
+		teardown: function(ctx) {
+			ctx.ds.close();
+		}
+	};
+}
+
+module.exports = {
+	'pixels.read 16x16': readWindow(16),
+	'pixels.read 256x256': readWindow(256),
+	'pixels.read 1024x1024': readWindow(1024)
+};
@@ -0,0 +1,53 @@
+// Runs the binding benchmarks and writes the results to stdout as JSON.
+//
+//   node --expose-gc bench/run.js [--time=seconds] [filter...]
+//
+// Each filter is matched against "<file>/<case>" (e.g. "raster_io" or "geometry/fromWKB").
+
+'use strict';
+
+var fs = require('fs');
+var path = require('path');
+var gdal = require('../lib/gdal.js');
+var harness = require('./_harness.js');
+
+var options = {};
+var filters = [];
+process.argv.slice(2).forEach(function(arg) {
+	var m = arg.match(/^--time=(.+)$/);
+	if (m) options.time = parseFloat(m[1]);
+	else filters.push(arg);
+});
+
+if (typeof gc !== 'function') {
+	console.error('warning: run with --expose-gc for meaningful rss_delta values');
+}
+
+function selected(id) {
+	if (!filters.length) return true;
+	return filters.some(function(filter) { return id.indexOf(filter) !== -1; });
+}
+
+var results = [];
+fs.readdirSync(__dirname).sort().forEach(function(file) {
+	if (file[0] === '_' || file === 'run.js' || path.extname(file) !== '.js') return;
+	var suite = path.basename(file, '.js');
+	var benches = require(path.join(__dirname, file));
+	Object.keys(benches).forEach(function(name) {
+		var id = suite + '/' + name;
+		if (!selected(id)) return;
+		var result = harness.run(name, benches[name], options);
+		result.suite = suite;
+		results.push(result);
+		console.error(id + ': ' + Math.round(result.ops_per_sec) + ' ops/sec, p50 ' +
+			result.p50_us.toFixed(2) + 'us, p99 ' + result.p99_us.toFixed(2) + 'us');
+	});
+});
+
+console.log(JSON.stringify({
+	node: process.version,
+	gdal: gdal.version,
+	platform: process.platform + '-' + process.arch,
+	date: new Date().toISOString(),
+	results: results
+}, null, 2));
@@ -0,0 +1,40 @@
+// CoordinateTransformation.transformPoint() one point at a time, and the
+// batched transformPoints() for comparison. One op is one point.
+
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+
+var N = 1000;
+
+function setup() {
+	var ct = new gdal.CoordinateTransformation(gdal.SpatialReference.fromEPSG(4326), gdal.SpatialReference.fromEPSG(3857));
+	var xs = new Float64Array(N);
+	var ys = new Float64Array(N);
+	for (var i = 0; i < N; i++) {
+		xs[i] = -180 + 360 * i / N;
+		ys[i] = -80 + 160 * ((i * 7) % N) / N;
+	}
+	return {ct: ct, xs: xs, ys: ys, x: new Float64Array(N), y: new Float64Array(N)};
+}
+
+module.exports = {
+	'transformPoint': {
+		setup: setup,
+		fn: function(ctx) {
+			for (var i = 0; i < N; i++) ctx.ct.transformPoint(ctx.xs[i], ctx.ys[i]);
+		},
+		ops: N
+	},
+	'transformPoints': {
+		setup: setup,
+		beforeSample: function(ctx) {
+			ctx.x.set(ctx.xs);
+			ctx.y.set(ctx.ys);
+		},
+		fn: function(ctx) {
+			ctx.ct.transformPoints(ctx.x, ctx.y);
+		},
+		ops: N
+	}
+};
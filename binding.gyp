@@ -14,6 +14,7 @@
 			"sources": [
 				"src/fast_buffer.cpp",
 				"src/typed_array.cpp",
+				"src/async_worker.cpp",
 				"src/node_gdal.cpp",
 				"src/gdal_common.cpp",
 				"src/gdal_dataset.cpp",
@@ -32,9 +33,14 @@
 				"src/gdal_multipoint.cpp",
 				"src/gdal_multilinestring.cpp",
 				"src/gdal_multipolygon.cpp",
+				"src/gdal_geometry_array.cpp",
+				"src/gdal_prepared_geometry.cpp",
+				"src/gdal_spatial_index.cpp",
 				"src/gdal_layer.cpp",
 				"src/gdal_coordinate_transformation.cpp",
 				"src/gdal_spatial_reference.cpp",
+				"src/gdal_warper.cpp",
+				"src/gdal_algorithms.cpp",
 				"src/collections/dataset_bands.cpp",
 				"src/collections/dataset_layers.cpp",
 				"src/collections/layer_features.cpp",
@@ -46,6 +52,7 @@
 				"src/collections/linestring_points.cpp",
 				"src/collections/rasterband_overviews.cpp",
 				"src/collections/rasterband_pixels.cpp",
+				"src/collections/rasterband_blocks.cpp",
 				"src/collections/gdal_drivers.cpp"
 			],
 			"defines": [
@@ -64,7 +71,12 @@
 				}],
 				["shared_gdal == 'false'", {
 					"dependencies": [
-						"deps/libgdal/libgdal.gyp:libgdal"
+						"deps/libgdal/libgdal.gyp:libgdal",
+						"deps/libgeos/libgeos.gyp:libgeos"
+					],
+					"defines": [
+						"HAVE_GEOS=1",
+						"HAVE_GDAL_ALG_PRIV=1"
 					]
 				}, {
 					"conditions": [
@@ -86,7 +86,6 @@
 				"gdal/alg/gdaldither.cpp",
 				"gdal/alg/gdalgeoloc.cpp",
 				"gdal/alg/gdalgrid.cpp",
-				"gdal/alg/gdalgridavx.cpp",
 				"gdal/alg/gdalmatching.cpp",
 				"gdal/alg/gdalmediancut.cpp",
 				"gdal/alg/gdalproximity.cpp",
@@ -224,6 +223,15 @@
 							"-lws2_32.lib",
 						]
 					}
+				}],
+				# SSE is part of the x86-64 baseline, so the SSE gridding kernel needs no extra flags
+				["target_arch == 'x64'", {
+					"defines": ["HAVE_SSE_AT_COMPILE_TIME"]
+				}],
+				# the AVX kernel is built separately with -mavx and only used if the CPU supports it
+				["target_arch == 'x64' and OS != 'win'", {
+					"defines": ["HAVE_AVX_AT_COMPILE_TIME"],
+					"dependencies": ["libgdal_alg_avx"]
 				}]
 			],
 			"direct_dependent_settings": {
@@ -247,6 +255,23 @@
 					"_FILE_OFFSET_BITS=64"
 				]
 			}
+		},
+		{
+			"target_name": "libgdal_alg_avx",
+			"type": "static_library",
+			"sources": [
+				"gdal/alg/gdalgridavx.cpp"
+			],
+			"conditions": [
+				["target_arch == 'x64' and OS != 'win'", {
+					"defines": ["HAVE_AVX_AT_COMPILE_TIME"],
+					"cflags": ["-mavx"],
+					"xcode_settings": {
+						"OTHER_CFLAGS": ["-mavx"],
+						"OTHER_CPLUSPLUSFLAGS": ["-mavx"]
+					}
+				}]
+			]
 		}
 	]
 }
@@ -78,6 +78,15 @@ gdal.LayerFeatures.prototype.forEach = function(iterator){
 	}
 };
 
+gdal.RasterBandBlocks.prototype.forEach = function(iterator){
+	this.reset();
+	var block = this.next();
+	while (block) {
+		if (iterator(block) === false) return;
+		block = this.next();
+	}
+};
+
 gdal.FeatureFields.prototype.forEach = function(iterator){
 	var obj = this.toJSON();
 	var names = Object.keys(obj);
@@ -97,10 +106,12 @@ gdal.LineStringPoints.prototype.forEach = defaultForEach;
 gdal.GeometryCollectionChildren.prototype.forEach = defaultForEach;
 gdal.RasterBandOverviews.prototype.forEach = defaultForEach;
 gdal.GDALDrivers.prototype.forEach = defaultForEach;
+gdal.GeometryArray.prototype.forEach = defaultForEach;
 
 gdal.GeometryCollectionChildren.prototype.toArray = defaultToArray;
 gdal.LineStringPoints.prototype.toArray = defaultToArray;
 gdal.PolygonRings.prototype.toArray = defaultToArray;
+gdal.GeometryArray.prototype.toArray = defaultToArray;
 
 
 // add 'w' mode to gdal.open() method and also GDAL2-style driver selection
@@ -147,6 +158,36 @@ gdal.open = function(filename, mode, drivers, x_size, y_size, n_bands, datatype,
 	}
 };
 
+// open a dataset from a Buffer (it's used as an in-memory file without copying)
+var openBuffer = gdal.openBuffer;
+gdal.openBuffer = function(buffer, options) {
+	options = options || {};
+
+	var drivers = options.driver;
+	if (typeof drivers === 'string') {
+		drivers = [drivers];
+	} else if (drivers && !(drivers instanceof Array)) {
+		throw new Error('driver(s) must be a string or array of strings');
+	}
+	if (drivers) {
+		drivers = drivers.map(function(driver) {
+			return typeof driver === 'string' ? gdal.drivers.get(driver) : driver;
+		});
+	}
+
+	return openBuffer.call(gdal, buffer, options.mode, drivers, options.filename);
+};
+
+gdal.Dataset.prototype.toBuffer = (function() {
+	var toBuffer = gdal.Dataset.prototype.toBuffer;
+	return function(driver, options) {
+		if (typeof driver === 'string') {
+			driver = gdal.drivers.get(driver);
+		}
+		return toBuffer.call(this, driver, options);
+	};
+})();
+
 function fieldTypeFromValue(val) {
 	var type = typeof val;
 	if (type === 'number') {
@@ -210,6 +251,22 @@ gdal.DatasetLayers.prototype.create = (function() {
 	};
 })();
 
+gdal.LayerFeatures.prototype.readBatch = (function() {
+	var readBatch = gdal.LayerFeatures.prototype.readBatch;
+	return function(count, options) {
+		if (!options) options = {};
+		return readBatch.apply(this, [count, options.fields, options.geometry]);
+	};
+})();
+
+gdal.LayerFeatures.prototype.insertBatch = (function() {
+	var insertBatch = gdal.LayerFeatures.prototype.insertBatch;
+	return function(columns, geometries, options) {
+		if (!options) options = {};
+		return insertBatch.apply(this, [columns, geometries, options.transactionSize]);
+	};
+})();
+
 gdal.RasterBandPixels.prototype.read = (function() {
 	var read = gdal.RasterBandPixels.prototype.read;
 	return function(x, y, width, height, data, options) {
@@ -224,4 +281,163 @@ gdal.RasterBandPixels.prototype.write = (function() {
 		if (!options) options = {};
 		return write.apply(this, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.pixel_space, options.line_space]);
 	};
-})();
\ No newline at end of file
+})();
+
+gdal.Dataset.prototype.readBands = (function() {
+	var readBands = gdal.Dataset.prototype.readBands;
+	return function(x, y, width, height, bands, data, options) {
+		if (!options) options = {};
+		return readBands.apply(this, [x, y, width, height, bands, data, options.buffer_width, options.buffer_height, options.type, options.pixel_space, options.line_space, options.band_space]);
+	};
+})();
+
+// --- async methods ---
+
+// invokes an async binding method with a node-style callback appended,
+// returning a promise instead when no callback is given
+function callAsync(self, method, args, callback) {
+	if (typeof callback === 'function') {
+		method.apply(self, args.concat([callback]));
+		return;
+	}
+	if (typeof Promise !== 'function') {
+		throw new Error('callback must be given');
+	}
+	return new Promise(function(resolve, reject) {
+		method.apply(self, args.concat([function(err, result) {
+			if (err) reject(err);
+			else resolve(result);
+		}]));
+	});
+}
+
+gdal.RasterBandPixels.prototype.readAsync = (function() {
+	var readAsync = gdal.RasterBandPixels.prototype.readAsync;
+	return function(x, y, width, height, data, options, callback) {
+		if (typeof data === 'function') {
+			callback = data;
+			data = undefined;
+		} else if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		}
+		if (!options) options = {};
+		return callAsync(this, readAsync, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.type, options.pixel_space, options.line_space], callback);
+	};
+})();
+
+gdal.RasterBandPixels.prototype.writeAsync = (function() {
+	var writeAsync = gdal.RasterBandPixels.prototype.writeAsync;
+	return function(x, y, width, height, data, options, callback) {
+		if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		}
+		if (!options) options = {};
+		return callAsync(this, writeAsync, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.pixel_space, options.line_space], callback);
+	};
+})();
+
+gdal.CoordinateTransformation.prototype.transformPointsAsync = (function() {
+	var transformPointsAsync = gdal.CoordinateTransformation.prototype.transformPointsAsync;
+	return function() {
+		var args = Array.prototype.slice.call(arguments);
+		var callback;
+		if (typeof args[args.length - 1] === 'function') {
+			callback = args.pop();
+		}
+		while (args.length < 3) args.push(undefined);
+		return callAsync(this, transformPointsAsync, args.slice(0, 3), callback);
+	};
+})();
+
+gdal.RasterBand.prototype.computeStatisticsAsync = (function() {
+	var computeStatisticsAsync = gdal.RasterBand.prototype.computeStatisticsAsync;
+	return function(allow_approx, options, callback) {
+		if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		}
+		return callAsync(this, computeStatisticsAsync, [allow_approx, options], callback);
+	};
+})();
+
+gdal.RasterBand.prototype.getHistogramAsync = (function() {
+	var getHistogramAsync = gdal.RasterBand.prototype.getHistogramAsync;
+	return function(options, callback) {
+		if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		}
+		return callAsync(this, getHistogramAsync, [options], callback);
+	};
+})();
+
+gdal.Dataset.prototype.buildOverviewsAsync = (function() {
+	var buildOverviewsAsync = gdal.Dataset.prototype.buildOverviewsAsync;
+	return function(resampling, overviews, bands, options, callback) {
+		if (typeof bands === 'function') {
+			callback = bands;
+			bands = undefined;
+		} else if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		}
+		return callAsync(this, buildOverviewsAsync, [resampling, overviews, bands, options], callback);
+	};
+})();
+
+gdal.Driver.prototype.createCopyAsync = (function() {
+	var createCopyAsync = gdal.Driver.prototype.createCopyAsync;
+	return function(filename, src, options, params, callback) {
+		if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		} else if (typeof params === 'function') {
+			callback = params;
+			params = undefined;
+		}
+		return callAsync(this, createCopyAsync, [filename, src, options, params], callback);
+	};
+})();
+
+// gdal.<algorithm>Async(options, [callback])
+[
+	'reprojectImageAsync',
+	'polygonizeAsync',
+	'rasterizeAsync',
+	'contourGenerateAsync',
+	'computeProximityAsync',
+	'sieveFilterAsync',
+	'fillNodataAsync',
+	'gridAsync'
+].forEach(function(name) {
+	var method = gdal[name];
+	gdal[name] = function(options, callback) {
+		return callAsync(gdal, method, [options], callback);
+	};
+});
+
+// gdal.zonalStatistics(band, layer, [options])
+// gdal.zonalStatisticsAsync(band, layer, [options], [callback])
+(function() {
+	var zonalStatistics = gdal.zonalStatistics;
+	var zonalStatisticsAsync = gdal.zonalStatisticsAsync;
+	var toOptions = function(band, layer, options) {
+		var result = {src: band, layer: layer};
+		for (var key in options) {
+			if (options.hasOwnProperty(key)) result[key] = options[key];
+		}
+		return result;
+	};
+	gdal.zonalStatistics = function(band, layer, options) {
+		return zonalStatistics(toOptions(band, layer, options));
+	};
+	gdal.zonalStatisticsAsync = function(band, layer, options, callback) {
+		if (typeof options === 'function') {
+			callback = options;
+			options = undefined;
+		}
+		return callAsync(gdal, zonalStatisticsAsync, [toOptions(band, layer, options)], callback);
+	};
+})();
@@ -0,0 +1,213 @@
+
+#include "gdal_common.hpp"
+#include "async_worker.hpp"
+
+namespace node_gdal {
+
+AsyncWorker::AsyncWorker(Handle<Function> cb)
+	: error_msg("")
+{
+	HandleScope scope;
+
+	request.data = this;
+	persistent   = Persistent<Object>::New(Object::New());
+	callback     = Persistent<Function>::New(cb);
+}
+
+AsyncWorker::~AsyncWorker()
+{
+	if (!persistent.IsEmpty()) {
+		persistent.Dispose();
+		persistent.Clear();
+	}
+	if (!callback.IsEmpty()) {
+		callback.Dispose();
+		callback.Clear();
+	}
+}
+
+void AsyncWorker::SaveToPersistent(const char *key, Handle<Value> value)
+{
+	HandleScope scope;
+	persistent->Set(String::NewSymbol(key), value);
+}
+
+Handle<Value> AsyncWorker::GetFromPersistent(const char *key)
+{
+	HandleScope scope;
+	return scope.Close(persistent->Get(String::NewSymbol(key)));
+}
+
+void AsyncWorker::SetErrorMessage(const char *msg)
+{
+	//CPLGetLastErrorMsg() returns an empty string if nothing was reported
+	error_msg = (msg && *msg) ? msg : "Unknown error";
+}
+
+Handle<Value> AsyncWorker::GetResult()
+{
+	return Undefined();
+}
+
+void AsyncWorker::Flush()
+{
+}
+
+void AsyncWorker::Destroy()
+{
+	delete this;
+}
+
+void AsyncWorker::Queue(AsyncWorker *worker)
+{
+	LOG("Queueing AsyncWorker [%p]", worker);
+	uv_queue_work(uv_default_loop(), &worker->request, AsyncWorker::Work, (uv_after_work_cb)AsyncWorker::After);
+}
+
+void AsyncWorker::Work(uv_work_t *req)
+{
+	AsyncWorker *worker = static_cast<AsyncWorker*>(req->data);
+	worker->Execute();
+}
+
+void AsyncWorker::After(uv_work_t *req, int status)
+{
+	HandleScope scope;
+	AsyncWorker *worker = static_cast<AsyncWorker*>(req->data);
+
+	LOG("AsyncWorker finished [%p]", worker);
+
+	//deliver anything still pending before the final callback
+	worker->Flush();
+
+	Handle<Value> argv[2];
+	int argc = 1;
+
+	if (worker->error_msg.empty()) {
+		TryCatch try_catch;
+		Handle<Value> result = worker->GetResult();
+		if (try_catch.HasCaught()) {
+			argv[0] = try_catch.Exception();
+		} else {
+			argv[0] = Null();
+			argv[1] = result;
+			argc = 2;
+		}
+	} else {
+		argv[0] = Exception::Error(String::New(worker->error_msg.c_str()));
+	}
+
+	node::MakeCallback(worker->persistent, worker->callback, argc, argv);
+
+	worker->Destroy();
+}
+
+AsyncProgressWorker::AsyncProgressWorker(Handle<Function> callback, Handle<Function> progress_cb)
+	: AsyncWorker(callback), progress(0), pending(false), cancelled(false)
+{
+	HandleScope scope;
+
+	if (!progress_cb.IsEmpty()) {
+		this->progress_cb = Persistent<Function>::New(progress_cb);
+	}
+	progress_async.data = this;
+	uv_async_init(uv_default_loop(), &progress_async, AsyncProgressWorker::SendProgress);
+	uv_mutex_init(&progress_lock);
+}
+
+AsyncProgressWorker::~AsyncProgressWorker()
+{
+	if (!progress_cb.IsEmpty()) {
+		progress_cb.Dispose();
+		progress_cb.Clear();
+	}
+	uv_mutex_destroy(&progress_lock);
+}
+
+void AsyncProgressWorker::Flush()
+{
+	SendProgress(&progress_async, 0);
+}
+
+void AsyncProgressWorker::Destroy()
+{
+	//the worker is deleted once libuv is done with the async handle
+	uv_close((uv_handle_t*) &progress_async, AsyncProgressWorker::Close);
+}
+
+void AsyncProgressWorker::Close(uv_handle_t *handle)
+{
+	delete static_cast<AsyncProgressWorker*>(handle->data);
+}
+
+int CPL_STDCALL AsyncProgressWorker::ProgressFunc(double complete, const char *message, void *arg)
+{
+	//some algorithms drop the argument for part of their work (GDALFillNodata smoothing
+	//passes NULL to GDALCreateScaledProgress), there is nothing to report to then
+	if (!arg) return TRUE;
+
+	AsyncProgressWorker *worker = static_cast<AsyncProgressWorker*>(arg);
+
+	//some algorithms report slightly more than 1 when done
+	if (complete > 1.0) complete = 1.0;
+
+	uv_mutex_lock(&worker->progress_lock);
+	bool cancelled = worker->cancelled;
+	//skip updates smaller than 0.1% so slow callbacks don't get flooded
+	bool send = complete - worker->progress >= 0.001 || (complete >= 1.0 && worker->progress < 1.0);
+	if (send) {
+		worker->progress = complete;
+		worker->pending = true;
+	}
+	uv_mutex_unlock(&worker->progress_lock);
+
+	if (send) uv_async_send(&worker->progress_async);
+
+	return cancelled ? FALSE : TRUE;
+}
+
+void AsyncProgressWorker::SendProgress(uv_async_t *handle, int status)
+{
+	HandleScope scope;
+	AsyncProgressWorker *worker = static_cast<AsyncProgressWorker*>(handle->data);
+
+	if (worker->progress_cb.IsEmpty()) return;
+
+	uv_mutex_lock(&worker->progress_lock);
+	double complete = worker->progress;
+	bool pending = worker->pending;
+	worker->pending = false;
+	uv_mutex_unlock(&worker->progress_lock);
+
+	if (!pending) return;
+
+	Handle<Value> argv[] = { Number::New(complete) };
+	Handle<Value> result = node::MakeCallback(worker->persistent, worker->progress_cb, 1, argv);
+
+	if (!result.IsEmpty() && result->IsFalse()) {
+		uv_mutex_lock(&worker->progress_lock);
+		worker->cancelled = true;
+		uv_mutex_unlock(&worker->progress_lock);
+	}
+}
+
+int CPL_STDCALL SyncProgressFunc(double complete, const char *message, void *arg)
+{
+	//see AsyncProgressWorker::ProgressFunc()
+	if (!arg) return TRUE;
+
+	HandleScope scope;
+	Handle<Function> progress_cb = *static_cast<Handle<Function>*>(arg);
+
+	if (complete > 1.0) complete = 1.0;
+
+	Handle<Value> argv[] = { Number::New(complete) };
+	Handle<Value> result = progress_cb->Call(Context::GetCurrent()->Global(), 1, argv);
+
+	if (result.IsEmpty() || result->IsFalse()) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+} // namespace node_gdal
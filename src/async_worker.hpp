@@ -0,0 +1,88 @@
+#ifndef __NODE_GDAL_ASYNC_WORKER_H__
+#define __NODE_GDAL_ASYNC_WORKER_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+#include <uv.h>
+
+// gdal
+#include <cpl_progress.h>
+
+// std
+#include <string>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Base class for jobs that run on the libuv thread pool.
+// Execute() is called on a worker thread and must not touch V8. Any JS
+// objects the job depends on (typed arrays, parent datasets) must be pinned
+// with SaveToPersistent() so they outlive the job. When the job is done the
+// callback is invoked as callback(err, result) on the main thread.
+
+class AsyncWorker {
+public:
+	AsyncWorker(Handle<Function> callback);
+	virtual ~AsyncWorker();
+
+	virtual void Execute() = 0;
+	virtual Handle<Value> GetResult();
+	virtual void Flush();
+	virtual void Destroy();
+
+	void SaveToPersistent(const char *key, Handle<Value> value);
+	Handle<Value> GetFromPersistent(const char *key);
+	void SetErrorMessage(const char *msg);
+
+	static void Queue(AsyncWorker *worker);
+
+protected:
+	Persistent<Object> persistent;
+	Persistent<Function> callback;
+	std::string error_msg;
+
+private:
+	uv_work_t request;
+	static void Work(uv_work_t *req);
+	static void After(uv_work_t *req, int status);
+};
+
+// AsyncWorker for GDAL calls that take a GDALProgressFunc. Pass ProgressFunc
+// and the worker as pfnProgress / pProgressArg; updates are forwarded to the
+// progress callback as progress(complete) on the main thread, at most once per
+// loop iteration and always before the final callback. Returning false from it
+// cancels the job.
+
+class AsyncProgressWorker : public AsyncWorker {
+public:
+	AsyncProgressWorker(Handle<Function> callback, Handle<Function> progress_cb);
+	virtual ~AsyncProgressWorker();
+
+	virtual void Flush();
+	virtual void Destroy();
+
+	static int CPL_STDCALL ProgressFunc(double complete, const char *message, void *arg);
+
+private:
+	Persistent<Function> progress_cb;
+	uv_async_t progress_async;
+	uv_mutex_t progress_lock;
+	double progress;
+	bool pending;
+	bool cancelled;
+	static void SendProgress(uv_async_t *handle, int status);
+	static void Close(uv_handle_t *handle);
+};
+
+// GDALProgressFunc for synchronous calls made on the JS thread. pProgressArg
+// must point to the Handle<Function> to call. Returning false from it (or
+// throwing) cancels the operation; callers should check for a caught exception.
+int CPL_STDCALL SyncProgressFunc(double complete, const char *message, void *arg);
+
+}
+#endif
@@ -87,6 +87,9 @@ Handle<Value> DatasetBands::get(const Arguments& args)
 		if (!raw) {
 			return NODE_THROW("Dataset object has already been destroyed");
 		}
+
+		DatasetLock lock(ds);
+
 		int band_id;
 		NODE_ARG_INT(0, "band id", band_id);
 	
@@ -112,6 +115,8 @@ Handle<Value> DatasetBands::create(const Arguments& args)
 		return NODE_THROW("Dataset object has already been destroyed");
 	}
 
+	DatasetLock lock(ds);
+
 	GDALDataType type;
 	Handle<Array> band_options = Array::New(0);
 	char **options = NULL;
@@ -171,6 +176,9 @@ Handle<Value> DatasetBands::count(const Arguments& args)
 		if (!raw) {
 			return NODE_THROW("Dataset object has already been destroyed");
 		}
+
+		DatasetLock lock(ds);
+
 		return scope.Close(Integer::New(raw->GetRasterCount()));
 	}
 }
@@ -92,6 +92,8 @@ Handle<Value> DatasetLayers::get(const Arguments& args)
 		return NODE_THROW("Dataset object already destroyed");
 	}
 
+	DatasetLock lock(ds);
+
 	if(args.Length() < 1) {
 		return NODE_THROW("method must be given integer or string")
 	}
@@ -130,6 +132,8 @@ Handle<Value> DatasetLayers::create(const Arguments& args)
 		return NODE_THROW("Dataset object already destroyed");
 	}
 
+	DatasetLock lock(ds);
+
 	std::string layer_name;
 	SpatialReference *spatial_ref = NULL;
 	OGRwkbGeometryType geom_type = wkbUnknown;
@@ -189,7 +193,9 @@ Handle<Value> DatasetLayers::count(const Arguments& args)
 	if (!raw) {
 		return NODE_THROW("Dataset object already destroyed");
 	}
-	
+
+	DatasetLock lock(ds);
+
 	return scope.Close(Integer::New(raw->GetLayerCount()));
 }
 
@@ -213,6 +219,8 @@ Handle<Value> DatasetLayers::copy(const Arguments& args)
 		return NODE_THROW("Dataset object already destroyed");
 	}
 
+	DatasetLock lock(ds);
+
 	Layer *layer_to_copy;
 	std::string new_name = "";
 	Handle<Array> layer_options = Array::New(0);
@@ -230,6 +238,9 @@ Handle<Value> DatasetLayers::copy(const Arguments& args)
 		}
 	}
 
+	//the source layer may belong to another dataset
+	DatasetLock src_lock(Layer::parentDataset(args[0]->ToObject()));
+
 	OGRLayer *layer = raw->CopyLayer(layer_to_copy->get(),
 										   new_name.c_str(),
 										   options);
@@ -266,7 +277,8 @@ Handle<Value> DatasetLayers::remove(const Arguments& args)
 		return NODE_THROW("Dataset object already destroyed");
 	}
 
-	
+	DatasetLock lock(ds);
+
 	int i;
 	NODE_ARG_INT(0, "layer index", i);
 	OGRErr err = raw->DeleteLayer(i);
@@ -75,7 +75,7 @@ Handle<Value> FeatureFields::toString(const Arguments& args)
 }
 
 
-inline bool setField(OGRFeature* f, int field_index, Handle<Value> val){
+bool FeatureFields::setField(OGRFeature* f, int field_index, Handle<Value> val){
 	if (val->IsInt32()) {
 		f->SetField(field_index, val->Int32Value());
 	} else if (val->IsNumber()) {
@@ -35,6 +35,7 @@ public:
 	static Handle<Value> indexOf(const Arguments &args);
 
 	static Handle<Value> get(OGRFeature *f, int field_index);
+	static bool setField(OGRFeature *f, int field_index, Handle<Value> val);
 	static Handle<Value> getFieldAsIntegerList(OGRFeature* feature, int field_index);
 	static Handle<Value> getFieldAsDoubleList(OGRFeature* feature, int field_index);
 	static Handle<Value> getFieldAsStringList(OGRFeature* feature, int field_index);
@@ -1,6 +1,8 @@
 #include "../gdal_common.hpp"
 #include "../gdal_geometry.hpp"
 #include "../gdal_geometrycollection.hpp"
+#include "../typed_array.hpp"
+#include "linestring_points.hpp"
 #include "geometry_collection_children.hpp"
 
 namespace node_gdal {
@@ -20,6 +22,8 @@ void GeometryCollectionChildren::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "get", get);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "remove", remove);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "add", add);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toFloat64Array", toFloat64Array);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "setFromArray", setFromArray);
 
 	target->Set(String::NewSymbol("GeometryCollectionChildren"), constructor->GetFunction());
 }
@@ -150,4 +154,204 @@ Handle<Value> GeometryCollectionChildren::add(const Arguments& args)
 	return Undefined();
 }
 
-} // namespace node_gdal
\ No newline at end of file
+//number of offset levels the children of a collection need: 0 for points, 1 for lines, 2 for polygons.
+//-1 if the children are of mixed or unsupported types
+static int offsetLevels(OGRGeometryCollection *collection)
+{
+	switch (wkbFlatten(collection->getGeometryType())) {
+		case wkbMultiPoint:      return 0;
+		case wkbMultiLineString: return 1;
+		case wkbMultiPolygon:    return 2;
+		default: break;
+	}
+
+	int levels = -1;
+	for (int i = 0; i < collection->getNumGeometries(); i++) {
+		int child_levels;
+		switch (wkbFlatten(collection->getGeometryRef(i)->getGeometryType())) {
+			case wkbPoint:      child_levels = 0; break;
+			case wkbLineString:
+			case wkbLinearRing: child_levels = 1; break;
+			case wkbPolygon:    child_levels = 2; break;
+			default:            return -1;
+		}
+		if (levels != -1 && levels != child_levels) return -1;
+		levels = child_levels;
+	}
+	return levels == -1 ? 0 : levels;
+}
+
+Handle<Value> GeometryCollectionChildren::toFloat64Array(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	GeometryCollection *geom = ObjectWrap::Unwrap<GeometryCollection>(parent);
+	OGRGeometryCollection *collection = geom->get();
+
+	int dims;
+	std::string err = LineStringPoints::parseDims(args[0], collection, dims);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	int levels = offsetLevels(collection);
+	if (levels < 0) {
+		return NODE_THROW("Children must all be points, all be linestrings or all be polygons");
+	}
+
+	//lines to copy, in order, and the offsets into them
+	int n_children = collection->getNumGeometries();
+	std::vector<OGRLineString*> lines;
+	std::vector<unsigned int> geom_offsets(1, 0);
+	std::vector<unsigned int> point_offsets(1, 0);
+	for (int i = 0; i < n_children; i++) {
+		OGRGeometry *child = collection->getGeometryRef(i);
+		if (levels == 1) {
+			lines.push_back((OGRLineString*) child);
+		} else if (levels == 2) {
+			OGRPolygon *polygon = (OGRPolygon*) child;
+			if (polygon->getExteriorRing()) {
+				lines.push_back(polygon->getExteriorRing());
+				for (int j = 0; j < polygon->getNumInteriorRings(); j++) {
+					lines.push_back(polygon->getInteriorRing(j));
+				}
+			}
+			geom_offsets.push_back(lines.size());
+		}
+	}
+	for (unsigned int i = 0; i < lines.size(); i++) {
+		point_offsets.push_back(point_offsets.back() + lines[i]->getNumPoints());
+	}
+	unsigned int n_points = levels == 0 ? n_children : point_offsets.back();
+
+	Handle<Value> coordinates = TypedArray::New(GDT_Float64, n_points * dims);
+	if (coordinates.IsEmpty() || !coordinates->IsObject()) {
+		return scope.Close(coordinates); //TypedArray::New threw
+	}
+	double *data = static_cast<double*>(TypedArray::Data(coordinates->ToObject()));
+	if (levels == 0) {
+		for (int i = 0; i < n_children; i++) {
+			OGRPoint *point = (OGRPoint*) collection->getGeometryRef(i);
+			data[i * dims]     = point->getX();
+			data[i * dims + 1] = point->getY();
+			if (dims == 3) data[i * dims + 2] = point->getZ();
+		}
+	} else {
+		for (unsigned int i = 0; i < lines.size(); i++) {
+			if (lines[i]->getNumPoints()) {
+				LineStringPoints::readPoints(lines[i], data + point_offsets[i] * dims, dims);
+			}
+		}
+	}
+
+	Local<Array> offsets = Array::New(levels);
+	if (levels == 2) {
+		Handle<Value> array = LineStringPoints::newOffsets(geom_offsets);
+		if (array.IsEmpty()) return scope.Close(array);
+		offsets->Set(0, array);
+	}
+	if (levels >= 1) {
+		Handle<Value> array = LineStringPoints::newOffsets(point_offsets);
+		if (array.IsEmpty()) return scope.Close(array);
+		offsets->Set(levels - 1, array);
+	}
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("coordinates"), coordinates);
+	result->Set(String::NewSymbol("offsets"), offsets);
+	return scope.Close(result);
+}
+
+Handle<Value> GeometryCollectionChildren::setFromArray(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	GeometryCollection *geom = ObjectWrap::Unwrap<GeometryCollection>(parent);
+	OGRGeometryCollection *collection = geom->get();
+
+	//default to the dimension of the geometry, so toArray() output round-trips
+	int dims;
+	std::string err = LineStringPoints::parseDims(args[2], collection, dims);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	double *data;
+	int n;
+	err = LineStringPoints::parseCoordinates(args[0], dims, data, n);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	//[] for points, [lineOffsets] for lines, [polygonOffsets, ringOffsets] for polygons
+	int levels = 0;
+	Handle<Array> offset_list;
+	if (!args[1]->IsUndefined() && !args[1]->IsNull()) {
+		if (!args[1]->IsArray()) {
+			return NODE_THROW("Offsets must be an array of offset arrays");
+		}
+		offset_list = Handle<Array>::Cast(args[1]);
+		levels = offset_list->Length();
+		if (levels > 2) {
+			return NODE_THROW("Offsets must have at most 2 levels");
+		}
+	}
+
+	OGRwkbGeometryType type = wkbFlatten(collection->getGeometryType());
+	if ((type == wkbMultiPoint && levels != 0) || (type == wkbMultiLineString && levels != 1) || (type == wkbMultiPolygon && levels != 2)) {
+		return NODE_THROW("Number of offset levels does not match the collection type");
+	}
+
+	std::vector<unsigned int> point_offsets;
+	std::vector<unsigned int> geom_offsets;
+	if (levels >= 1) {
+		//the last level indexes points, the one before it indexes rings
+		Handle<Value> last = offset_list->Get(levels - 1);
+		if (!last->IsObject()) {
+			return NODE_THROW("Offsets must be Uint32Arrays or arrays of integers");
+		}
+		int n_last = last->IsArray() ? Handle<Array>::Cast(last)->Length() : TypedArray::Length(last->ToObject());
+		if (levels == 2) {
+			err = LineStringPoints::parseOffsets(offset_list->Get(0), n_last > 0 ? n_last - 1 : 0, geom_offsets);
+			if (!err.empty()) {
+				return NODE_THROW(err.c_str());
+			}
+		}
+		err = LineStringPoints::parseOffsets(last, n, point_offsets);
+		if (!err.empty()) {
+			return NODE_THROW(err.c_str());
+		}
+	}
+
+	collection->empty();
+
+	if (levels == 0) {
+		for (int i = 0; i < n; i++) {
+			const double *pt = data + i * dims;
+			OGRPoint *point = dims == 3 ? new OGRPoint(pt[0], pt[1], pt[2]) : new OGRPoint(pt[0], pt[1]);
+			collection->addGeometryDirectly(point);
+		}
+	} else if (levels == 1) {
+		for (unsigned int i = 0; i + 1 < point_offsets.size(); i++) {
+			OGRLineString *line = new OGRLineString();
+			LineStringPoints::writePoints(line, data + point_offsets[i] * dims, point_offsets[i + 1] - point_offsets[i], dims);
+			collection->addGeometryDirectly(line);
+		}
+	} else {
+		for (unsigned int i = 0; i + 1 < geom_offsets.size(); i++) {
+			OGRPolygon *polygon = new OGRPolygon();
+			for (unsigned int j = geom_offsets[i]; j < geom_offsets[i + 1]; j++) {
+				OGRLinearRing *ring = new OGRLinearRing();
+				LineStringPoints::writePoints(ring, data + point_offsets[j] * dims, point_offsets[j + 1] - point_offsets[j], dims);
+				polygon->addRingDirectly(ring);
+			}
+			collection->addGeometryDirectly(polygon);
+		}
+	}
+
+	return Undefined();
+}
+
+} // namespace node_gdal
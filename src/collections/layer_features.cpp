@@ -1,7 +1,17 @@
 #include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
 #include "../gdal_layer.hpp"
 #include "../gdal_feature.hpp"
 #include "layer_features.hpp"
+#include "feature_fields.hpp"
+#include "../typed_array.hpp"
+#include "../fast_buffer.hpp"
+
+#include <vector>
+#include <algorithm>
+
+//features reserved up front by readBatch() when the layer can't count them cheaply
+#define READ_BATCH_RESERVE 1024
 
 namespace node_gdal {
 
@@ -22,6 +32,8 @@ void LayerFeatures::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "set", set);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "first", first);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "next", next);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "readBatch", readBatch);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "insertBatch", insertBatch);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "remove", remove);
 
 	ATTR_DONT_ENUM(constructor, "layer", layerGetter, READ_ONLY_SETTER);
@@ -83,6 +95,8 @@ Handle<Value> LayerFeatures::get(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	int feature_id;
 	NODE_ARG_INT(0, "feature id", feature_id);
 	OGRFeature *feature = layer->get()->GetFeature(feature_id);
@@ -100,6 +114,8 @@ Handle<Value> LayerFeatures::first(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	layer->get()->ResetReading();
 	OGRFeature *feature = layer->get()->GetNextFeature();
 
@@ -116,6 +132,8 @@ Handle<Value> LayerFeatures::next(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	OGRFeature *feature = layer->get()->GetNextFeature();
 
 	return scope.Close(Feature::New(feature));
@@ -131,6 +149,8 @@ Handle<Value> LayerFeatures::add(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	Feature *f;
 	NODE_ARG_WRAPPED(0, "feature", Feature, f)
 	
@@ -151,6 +171,8 @@ Handle<Value> LayerFeatures::count(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	int force = 1;
 	NODE_ARG_BOOL_OPT(0, "force", force);
 
@@ -167,6 +189,8 @@ Handle<Value> LayerFeatures::set(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	int err;
 	Feature *f;
 	int argc = args.Length();
@@ -205,6 +229,8 @@ Handle<Value> LayerFeatures::remove(const Arguments& args)
 	if (!layer->get()) {
 		return NODE_THROW("Layer object already destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(parent));
 	
 	int i;
 	NODE_ARG_INT(0, "feature id", i);
@@ -216,6 +242,460 @@ Handle<Value> LayerFeatures::remove(const Arguments& args)
 	return Undefined();
 }
 
+//appends the x, y of every vertex of the geometry to coords
+static void collectCoordinates(OGRGeometry *geom, std::vector<double> &coords)
+{
+	switch (wkbFlatten(geom->getGeometryType())) {
+		case wkbPoint: {
+			OGRPoint *pt = static_cast<OGRPoint*>(geom);
+			coords.push_back(pt->getX());
+			coords.push_back(pt->getY());
+			break;
+		}
+		case wkbLineString:
+		case wkbLinearRing: {
+			OGRLineString *line = static_cast<OGRLineString*>(geom);
+			int n = line->getNumPoints();
+			for (int i = 0; i < n; i++) {
+				coords.push_back(line->getX(i));
+				coords.push_back(line->getY(i));
+			}
+			break;
+		}
+		case wkbPolygon: {
+			OGRPolygon *poly = static_cast<OGRPolygon*>(geom);
+			if (poly->getExteriorRing()) {
+				collectCoordinates(poly->getExteriorRing(), coords);
+			}
+			int n = poly->getNumInteriorRings();
+			for (int i = 0; i < n; i++) {
+				collectCoordinates(poly->getInteriorRing(i), coords);
+			}
+			break;
+		}
+		case wkbMultiPoint:
+		case wkbMultiLineString:
+		case wkbMultiPolygon:
+		case wkbGeometryCollection: {
+			OGRGeometryCollection *coll = static_cast<OGRGeometryCollection*>(geom);
+			int n = coll->getNumGeometries();
+			for (int i = 0; i < n; i++) {
+				collectCoordinates(coll->getGeometryRef(i), coords);
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static void destroyFeatures(std::vector<OGRFeature*> &features)
+{
+	for (unsigned int i = 0; i < features.size(); i++) {
+		OGRFeature::DestroyFeature(features[i]);
+	}
+	features.clear();
+}
+
+Handle<Value> LayerFeatures::readBatch(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	Layer *layer = ObjectWrap::Unwrap<Layer>(parent);
+	if (!layer->get()) {
+		return NODE_THROW("Layer object already destroyed");
+	}
+
+	DatasetLock lock(Layer::parentDataset(parent));
+
+	int max_count;
+	Handle<Array> field_names;
+	std::string geom_mode = "wkb";
+
+	NODE_ARG_INT(0, "count", max_count);
+	NODE_ARG_ARRAY_OPT(1, "fields", field_names);
+	NODE_ARG_OPT_STR(2, "geometry", geom_mode);
+
+	if (max_count < 0) {
+		return NODE_THROW("count must not be negative");
+	}
+	if (geom_mode != "wkb" && geom_mode != "coords" && geom_mode != "none") {
+		return NODE_THROW("geometry must be 'wkb', 'coords' or 'none'");
+	}
+
+	OGRFeatureDefn *defn = layer->get()->GetLayerDefn();
+	std::vector<int> field_indices;
+
+	if (field_names.IsEmpty()) {
+		for (int i = 0; i < defn->GetFieldCount(); i++) {
+			field_indices.push_back(i);
+		}
+	} else {
+		for (unsigned int i = 0; i < field_names->Length(); i++) {
+			std::string name = TOSTR(field_names->Get(i));
+			int field_index = defn->GetFieldIndex(name.c_str());
+			if (field_index < 0) {
+				return NODE_THROW(("Field \"" + name + "\" not found").c_str());
+			}
+			field_indices.push_back(field_index);
+		}
+	}
+
+	//pull the features first so the columns can be allocated at their final size
+	std::vector<OGRFeature*> features;
+	//count is only an upper bound, don't let it allocate more than the layer can deliver
+	int available = layer->get()->GetFeatureCount(FALSE);
+	features.reserve(std::min(max_count, available >= 0 ? available : READ_BATCH_RESERVE));
+	while ((int) features.size() < max_count) {
+		OGRFeature *feature = layer->get()->GetNextFeature();
+		if (!feature) break;
+		features.push_back(feature);
+	}
+
+	int n = features.size();
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("count"), Integer::New(n));
+
+	Handle<Value> fids = TypedArray::New(GDT_Float64, n);
+	if (fids.IsEmpty() || !fids->IsObject()) {
+		destroyFeatures(features);
+		return fids; //TypedArray::New threw an error
+	}
+	double *fid_data = static_cast<double*>(TypedArray::Data(fids->ToObject()));
+	for (int i = 0; i < n; i++) {
+		fid_data[i] = features[i]->GetFID();
+	}
+	result->Set(String::NewSymbol("fids"), fids);
+
+	//fields
+	Local<Object> columns = Object::New();
+	for (unsigned int j = 0; j < field_indices.size(); j++) {
+		int field_index = field_indices[j];
+		OGRFieldDefn *field_defn = defn->GetFieldDefn(field_index);
+		Handle<Value> column;
+
+		switch (field_defn->GetType()) {
+			case OFTInteger: {
+				column = TypedArray::New(GDT_Int32, n);
+				if (column.IsEmpty() || !column->IsObject()) break;
+				int *data = static_cast<int*>(TypedArray::Data(column->ToObject()));
+				for (int i = 0; i < n; i++) {
+					data[i] = features[i]->IsFieldSet(field_index) ? features[i]->GetFieldAsInteger(field_index) : 0;
+				}
+				break;
+			}
+			case OFTReal: {
+				column = TypedArray::New(GDT_Float64, n);
+				if (column.IsEmpty() || !column->IsObject()) break;
+				double *data = static_cast<double*>(TypedArray::Data(column->ToObject()));
+				for (int i = 0; i < n; i++) {
+					data[i] = features[i]->IsFieldSet(field_index) ? features[i]->GetFieldAsDouble(field_index) : NAN;
+				}
+				break;
+			}
+			default: {
+				Local<Array> values = Array::New(n);
+				for (int i = 0; i < n; i++) {
+					Handle<Value> val = FeatureFields::get(features[i], field_index);
+					if (val.IsEmpty()) {
+						column = val; //get method threw an exception
+						break;
+					}
+					values->Set(i, val);
+				}
+				if (!column.IsEmpty()) break;
+				column = values;
+				break;
+			}
+		}
+
+		if (column.IsEmpty() || !column->IsObject()) {
+			destroyFeatures(features);
+			return column;
+		}
+		columns->Set(SafeString::New(field_defn->GetNameRef()), column);
+	}
+	result->Set(String::NewSymbol("fields"), columns);
+
+	//geometry
+	if (geom_mode != "none") {
+		Handle<Value> offsets = TypedArray::New(GDT_UInt32, n + 1);
+		if (offsets.IsEmpty() || !offsets->IsObject()) {
+			destroyFeatures(features);
+			return offsets; //TypedArray::New threw an error
+		}
+		unsigned int *offset_data = static_cast<unsigned int*>(TypedArray::Data(offsets->ToObject()));
+		Local<Object> geometry = Object::New();
+
+		if (geom_mode == "wkb") {
+			size_t size = 0;
+			offset_data[0] = 0;
+			for (int i = 0; i < n; i++) {
+				OGRGeometry *geom = features[i]->GetGeometryRef();
+				if (geom) size += geom->WkbSize();
+				offset_data[i + 1] = size;
+			}
+
+			unsigned char *data;
+			Handle<Value> wkb = FastBuffer::New((int) size, &data);
+			for (int i = 0; i < n; i++) {
+				OGRGeometry *geom = features[i]->GetGeometryRef();
+				if (geom) geom->exportToWkb(wkbNDR, data + offset_data[i]);
+			}
+			geometry->Set(String::NewSymbol("wkb"), wkb);
+		} else {
+			std::vector<double> coords;
+			offset_data[0] = 0;
+			for (int i = 0; i < n; i++) {
+				OGRGeometry *geom = features[i]->GetGeometryRef();
+				if (geom) collectCoordinates(geom, coords);
+				offset_data[i + 1] = coords.size() / 2;
+			}
+
+			Handle<Value> coord_array = TypedArray::New(GDT_Float64, coords.size());
+			if (coord_array.IsEmpty() || !coord_array->IsObject()) {
+				destroyFeatures(features);
+				return coord_array; //TypedArray::New threw an error
+			}
+			if (!coords.empty()) {
+				memcpy(TypedArray::Data(coord_array->ToObject()), &coords[0], coords.size() * sizeof(double));
+			}
+			geometry->Set(String::NewSymbol("coords"), coord_array);
+		}
+
+		geometry->Set(String::NewSymbol("offsets"), offsets);
+		result->Set(String::NewSymbol("geometry"), geometry);
+	}
+
+	destroyFeatures(features);
+
+	return scope.Close(result);
+}
+
+//a column passed to insertBatch(), resolved once up front
+struct InsertColumn {
+	int field_index;
+	GDALDataType type; //GDT_Unknown for plain arrays
+	void *data;
+	Handle<Array> values;
+};
+
+static double typedArrayValue(GDALDataType type, void *data, int i)
+{
+	switch (type) {
+		case GDT_Byte:    return static_cast<GByte*>(data)[i];
+		case GDT_UInt16:  return static_cast<GUInt16*>(data)[i];
+		case GDT_Int16:   return static_cast<GInt16*>(data)[i];
+		case GDT_UInt32:  return static_cast<GUInt32*>(data)[i];
+		case GDT_Int32:   return static_cast<GInt32*>(data)[i];
+		case GDT_Float32: return static_cast<float*>(data)[i];
+		case GDT_Float64: return static_cast<double*>(data)[i];
+		default:          return 0;
+	}
+}
+
+Handle<Value> LayerFeatures::insertBatch(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	Layer *layer = ObjectWrap::Unwrap<Layer>(parent);
+	if (!layer->get()) {
+		return NODE_THROW("Layer object already destroyed");
+	}
+
+	DatasetLock lock(Layer::parentDataset(parent));
+
+	Handle<Object> column_obj;
+	int transaction_size = 0;
+	NODE_ARG_OBJECT(0, "columns", column_obj);
+	NODE_ARG_INT_OPT(2, "transaction size", transaction_size);
+
+	OGRLayer *raw = layer->get();
+	OGRFeatureDefn *defn = raw->GetLayerDefn();
+	int n = -1;
+
+	//resolve field indices once
+	std::vector<InsertColumn> columns;
+	Handle<Array> names = column_obj->GetOwnPropertyNames();
+	for (unsigned int i = 0; i < names->Length(); i++) {
+		std::string name = TOSTR(names->Get(i));
+		Handle<Value> val = column_obj->Get(names->Get(i));
+
+		InsertColumn column;
+		column.field_index = defn->GetFieldIndex(name.c_str());
+		if (column.field_index < 0) {
+			return NODE_THROW(("Field \"" + name + "\" not found").c_str());
+		}
+
+		int length;
+		if (val->IsArray()) {
+			column.type   = GDT_Unknown;
+			column.data   = NULL;
+			column.values = Handle<Array>::Cast(val);
+			length = column.values->Length();
+		} else if (val->IsObject() && TypedArray::Identify(val->ToObject()) != GDT_Unknown) {
+			column.type = TypedArray::Identify(val->ToObject());
+			column.data = TypedArray::Data(val->ToObject());
+			length = TypedArray::Length(val->ToObject());
+		} else {
+			return NODE_THROW(("Column \"" + name + "\" must be an array or TypedArray").c_str());
+		}
+
+		if (n >= 0 && length != n) {
+			return NODE_THROW("All columns must have the same length");
+		}
+		n = length;
+		columns.push_back(column);
+	}
+
+	//geometry: either an array of WKB buffers or {wkb, offsets} as returned by readBatch()
+	Handle<Array> geom_buffers;
+	unsigned char *wkb = NULL;
+	unsigned int *wkb_offsets = NULL;
+	bool has_geometry = false;
+
+	if (args.Length() > 1 && !args[1]->IsNull() && !args[1]->IsUndefined()) {
+		int length;
+		if (args[1]->IsArray()) {
+			geom_buffers = Handle<Array>::Cast(args[1]);
+			length = geom_buffers->Length();
+		} else if (args[1]->IsObject()) {
+			Handle<Object> geom_obj = args[1]->ToObject();
+			Handle<Value> wkb_obj = geom_obj->Get(String::NewSymbol("wkb"));
+			Handle<Value> offsets_obj = geom_obj->Get(String::NewSymbol("offsets"));
+			if (!Buffer::HasInstance(wkb_obj)) {
+				return NODE_THROW("geometry.wkb must be a Buffer");
+			}
+			if (!offsets_obj->IsObject() || TypedArray::Identify(offsets_obj->ToObject()) != GDT_UInt32) {
+				return NODE_THROW("geometry.offsets must be a Uint32Array");
+			}
+			wkb = (unsigned char *) Buffer::Data(wkb_obj->ToObject());
+			wkb_offsets = static_cast<unsigned int*>(TypedArray::Data(offsets_obj->ToObject()));
+			length = TypedArray::Length(offsets_obj->ToObject()) - 1;
+			if (length < 0) {
+				return NODE_THROW("geometry.offsets must not be empty");
+			}
+			size_t wkb_length = Buffer::Length(wkb_obj->ToObject());
+			for (int i = 0; i < length; i++) {
+				if (wkb_offsets[i] > wkb_offsets[i + 1] || wkb_offsets[i + 1] > wkb_length) {
+					return NODE_THROW("geometry.offsets are out of range");
+				}
+			}
+		} else {
+			return NODE_THROW("geometry must be an array of Buffers or an object with wkb and offsets");
+		}
+
+		if (n >= 0 && length != n) {
+			return NODE_THROW("Geometry count must match the column length");
+		}
+		n = length;
+		has_geometry = true;
+	}
+
+	if (n <= 0) {
+		return scope.Close(Integer::New(0));
+	}
+	if (transaction_size <= 0) {
+		transaction_size = n;
+	}
+
+	bool use_transactions = raw->TestCapability(OLCTransactions);
+	OGRSpatialReference *srs = raw->GetSpatialRef();
+	OGRFeature *feature = OGRFeature::CreateFeature(defn);
+	int inserted = 0;
+	std::string error;
+
+	for (int start = 0; start < n && error.empty(); start += transaction_size) {
+		int end = std::min(n, start + transaction_size);
+
+		if (use_transactions && raw->StartTransaction() != OGRERR_NONE) {
+			error = "Error starting transaction";
+			break;
+		}
+
+		for (int i = start; i < end; i++) {
+			feature->SetFID(OGRNullFID);
+
+			for (unsigned int j = 0; j < columns.size(); j++) {
+				InsertColumn &column = columns[j];
+				if (column.type == GDT_Unknown) {
+					if (FeatureFields::setField(feature, column.field_index, column.values->Get(i))) {
+						error = "Unsupported type of field value";
+						break;
+					}
+				} else {
+					double val = typedArrayValue(column.type, column.data, i);
+					if (column.type == GDT_Float32 || column.type == GDT_Float64 || column.type == GDT_UInt32) {
+						feature->SetField(column.field_index, val);
+					} else {
+						feature->SetField(column.field_index, static_cast<int>(val));
+					}
+				}
+			}
+			if (!error.empty()) break;
+
+			if (has_geometry) {
+				unsigned char *data = NULL;
+				int size = 0;
+				if (wkb) {
+					data = wkb + wkb_offsets[i];
+					size = wkb_offsets[i + 1] - wkb_offsets[i];
+				} else {
+					Handle<Value> buffer = geom_buffers->Get(i);
+					if (Buffer::HasInstance(buffer)) {
+						data = (unsigned char *) Buffer::Data(buffer->ToObject());
+						size = Buffer::Length(buffer->ToObject());
+					} else if (!buffer->IsNull() && !buffer->IsUndefined()) {
+						error = "Geometry must be a Buffer or null";
+						break;
+					}
+				}
+
+				OGRGeometry *geom = NULL;
+				if (size > 0) {
+					OGRErr err = OGRGeometryFactory::createFromWkb(data, srs, &geom, size);
+					if (err) {
+						error = "Error parsing WKB of geometry";
+						break;
+					}
+				}
+				feature->SetGeometryDirectly(geom);
+			}
+
+			if (raw->CreateFeature(feature) != OGRERR_NONE) {
+				error = CPLGetLastErrorMsg();
+				if (error.empty()) error = "Error creating feature";
+				break;
+			}
+			if (!use_transactions) inserted++;
+		}
+
+		if (!error.empty()) {
+			if (use_transactions) raw->RollbackTransaction();
+			break;
+		}
+
+		if (use_transactions && raw->CommitTransaction() != OGRERR_NONE) {
+			error = "Error committing transaction";
+			break;
+		}
+		inserted = end;
+	}
+
+	OGRFeature::DestroyFeature(feature);
+
+	if (!error.empty()) {
+		char msg[64];
+		sprintf(msg, " (%d features inserted)", inserted);
+		return NODE_THROW((error + msg).c_str());
+	}
+
+	return scope.Close(Integer::New(inserted));
+}
+
 Handle<Value> LayerFeatures::layerGetter(Local<String> property, const AccessorInfo &info)
 {
 	HandleScope scope;
@@ -1,4 +1,5 @@
 #include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
 #include "../gdal_field_defn.hpp"
 #include "../gdal_layer.hpp"
 #include "layer_fields.hpp"
@@ -84,6 +85,8 @@ Handle<Value> LayerFields::count(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		return NODE_THROW("Layer has no layer definition set");
@@ -102,6 +105,8 @@ Handle<Value> LayerFields::indexOf(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		return NODE_THROW("Layer has no layer definition set");
@@ -123,6 +128,8 @@ Handle<Value> LayerFields::get(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	if (args.Length() < 1) {
 		return NODE_THROW("Field index or name must be given");
 	}
@@ -148,6 +155,8 @@ Handle<Value> LayerFields::getNames(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		return NODE_THROW("Layer has no layer definition set");
@@ -174,6 +183,8 @@ Handle<Value> LayerFields::remove(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	if (args.Length() < 1) {
 		return NODE_THROW("Field index or name must be given");
 	}
@@ -203,6 +214,8 @@ Handle<Value> LayerFields::add(const Arguments& args)
 	if (!layer->get()) {
 		return NODE_THROW("Layer object already destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(parent));
 	if (args.Length() < 1) {
 		return NODE_THROW("field definition(s) must be given");
 	}
@@ -250,6 +263,8 @@ Handle<Value> LayerFields::reorder(const Arguments& args)
 		return NODE_THROW("Layer object already destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(parent));
+
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		return NODE_THROW("Layer has no layer definition set");
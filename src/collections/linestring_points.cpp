@@ -2,6 +2,7 @@
 #include "../gdal_geometry.hpp"
 #include "../gdal_linestring.hpp"
 #include "../gdal_point.hpp"
+#include "../typed_array.hpp"
 #include "linestring_points.hpp"
 
 namespace node_gdal {
@@ -23,6 +24,8 @@ void LineStringPoints::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "add", add);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "reverse", reverse);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "resize", resize);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toFloat64Array", toFloat64Array);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "setFromArray", setFromArray);
 
 	target->Set(String::NewSymbol("LineStringPoints"), constructor->GetFunction());
 }
@@ -283,4 +286,163 @@ Handle<Value> LineStringPoints::add(const Arguments& args)
 	return Undefined();
 }
 
-} // namespace node_gdal
\ No newline at end of file
+//options: {dims: 2|3}, defaults to the coordinate dimension of the geometry
+std::string LineStringPoints::parseDims(Handle<Value> options, OGRGeometry *geom, int &dims)
+{
+	dims = geom && geom->getCoordinateDimension() == 3 ? 3 : 2;
+
+	if (options.IsEmpty() || options->IsUndefined() || options->IsNull()) return "";
+	Handle<Value> val = options;
+	if (options->IsObject()) {
+		val = options->ToObject()->Get(String::NewSymbol("dims"));
+		if (val->IsUndefined() || val->IsNull()) return "";
+	}
+	if (!val->IsInt32() || (val->Int32Value() != 2 && val->Int32Value() != 3)) {
+		return "dims must be 2 or 3";
+	}
+	dims = val->Int32Value();
+	return "";
+}
+
+std::string LineStringPoints::parseCoordinates(Handle<Value> array, int dims, double *&data, int &n)
+{
+	if (!array->IsObject() || TypedArray::Identify(array->ToObject()) != GDT_Float64) {
+		return "Coordinates must be a Float64Array";
+	}
+	int length = TypedArray::Length(array->ToObject());
+	if (length % dims) {
+		return "Coordinate array length must be a multiple of dims";
+	}
+	data = static_cast<double*>(TypedArray::Data(array->ToObject()));
+	n = length / dims;
+	return "";
+}
+
+//offsets: Uint32Array | Int32Array | number[] of count + 1 increasing indices starting at 0
+std::string LineStringPoints::parseOffsets(Handle<Value> array, unsigned int count, std::vector<unsigned int> &offsets)
+{
+	offsets.clear();
+	if (!array->IsObject()) return "Offsets must be a Uint32Array or an array of integers";
+
+	Handle<Object> obj = array->ToObject();
+	GDALDataType type = TypedArray::Identify(obj);
+	if (type == GDT_UInt32 || type == GDT_Int32) {
+		int length = TypedArray::Length(obj);
+		const char *data = static_cast<const char*>(TypedArray::Data(obj));
+		offsets.resize(length);
+		if (length) memcpy(&offsets[0], data, length * sizeof(unsigned int));
+		if (type == GDT_Int32) {
+			for (int i = 0; i < length; i++) {
+				if ((int) offsets[i] < 0) return "Offsets must not be negative";
+			}
+		}
+	} else if (array->IsArray()) {
+		Handle<Array> list = Handle<Array>::Cast(array);
+		for (unsigned int i = 0; i < list->Length(); i++) {
+			Handle<Value> val = list->Get(i);
+			if (!val->IsUint32()) return "Offsets must be non-negative integers";
+			offsets.push_back(val->Uint32Value());
+		}
+	} else {
+		return "Offsets must be a Uint32Array or an array of integers";
+	}
+
+	if (offsets.empty() || offsets[0] != 0) return "Offsets must start at 0";
+	for (unsigned int i = 1; i < offsets.size(); i++) {
+		if (offsets[i] < offsets[i - 1]) return "Offsets must not decrease";
+	}
+	if (offsets.back() != count) return "Last offset must equal the number of items";
+	return "";
+}
+
+Handle<Value> LineStringPoints::newOffsets(const std::vector<unsigned int> &offsets)
+{
+	HandleScope scope;
+
+	Handle<Value> array = TypedArray::New(GDT_UInt32, offsets.size());
+	if (array.IsEmpty() || !array->IsObject()) return scope.Close(array); //TypedArray::New threw
+	if (!offsets.empty()) {
+		memcpy(TypedArray::Data(array->ToObject()), &offsets[0], offsets.size() * sizeof(unsigned int));
+	}
+	return scope.Close(array);
+}
+
+void LineStringPoints::readPoints(OGRLineString *line, double *dst, int dims)
+{
+	if (dims == 2) {
+		//OGRRawPoint is a pair of doubles, so this is a single memcpy
+		line->getPoints(reinterpret_cast<OGRRawPoint*>(dst), NULL);
+	} else {
+		int stride = 3 * sizeof(double);
+		line->getPoints(dst, stride, dst + 1, stride, dst + 2, stride);
+	}
+}
+
+void LineStringPoints::writePoints(OGRLineString *line, const double *src, int n, int dims)
+{
+	if (dims == 2) {
+		line->setPoints(n, reinterpret_cast<OGRRawPoint*>(const_cast<double*>(src)), NULL);
+	} else {
+		std::vector<OGRRawPoint> xy(n);
+		std::vector<double> z(n);
+		for (int i = 0; i < n; i++) {
+			xy[i].x = src[i * 3];
+			xy[i].y = src[i * 3 + 1];
+			z[i]    = src[i * 3 + 2];
+		}
+		line->setPoints(n, n ? &xy[0] : NULL, n ? &z[0] : NULL);
+	}
+}
+
+Handle<Value> LineStringPoints::toFloat64Array(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	LineString *geom = ObjectWrap::Unwrap<LineString>(parent);
+
+	int dims;
+	std::string err = parseDims(args[0], geom->get(), dims);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	int n = geom->get()->getNumPoints();
+	Handle<Value> array = TypedArray::New(GDT_Float64, n * dims);
+	if (array.IsEmpty() || !array->IsObject()) {
+		return scope.Close(array); //TypedArray::New threw
+	}
+	if (n) {
+		readPoints(geom->get(), static_cast<double*>(TypedArray::Data(array->ToObject())), dims);
+	}
+
+	return scope.Close(array);
+}
+
+Handle<Value> LineStringPoints::setFromArray(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	LineString *geom = ObjectWrap::Unwrap<LineString>(parent);
+
+	//default to the dimension of the geometry, so toArray() output round-trips
+	int dims;
+	std::string err = parseDims(args[1], geom->get(), dims);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	double *data;
+	int n;
+	err = parseCoordinates(args[0], dims, data, n);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	writePoints(geom->get(), data, n, dims);
+
+	return Undefined();
+}
+
+} // namespace node_gdal
@@ -11,6 +11,10 @@
 // gdal
 #include <gdal_priv.h>
 
+// std
+#include <string>
+#include <vector>
+
 using namespace v8;
 using namespace node;
 
@@ -33,6 +37,16 @@ public:
 	static Handle<Value> count(const Arguments &args);
 	static Handle<Value> reverse(const Arguments &args);
 	static Handle<Value> resize(const Arguments &args);
+	static Handle<Value> toFloat64Array(const Arguments &args);
+	static Handle<Value> setFromArray(const Arguments &args);
+
+	//flat coordinate helpers, shared with PolygonRings and GeometryCollectionChildren
+	static std::string parseDims(Handle<Value> options, OGRGeometry *geom, int &dims);
+	static std::string parseCoordinates(Handle<Value> array, int dims, double *&data, int &n);
+	static std::string parseOffsets(Handle<Value> array, unsigned int count, std::vector<unsigned int> &offsets);
+	static Handle<Value> newOffsets(const std::vector<unsigned int> &offsets);
+	static void readPoints(OGRLineString *line, double *dst, int dims);
+	static void writePoints(OGRLineString *line, const double *src, int n, int dims);
 
 	LineStringPoints();
 private:
@@ -2,6 +2,8 @@
 #include "../gdal_geometry.hpp"
 #include "../gdal_polygon.hpp"
 #include "../gdal_linearring.hpp"
+#include "../typed_array.hpp"
+#include "linestring_points.hpp"
 #include "polygon_rings.hpp"
 
 namespace node_gdal {
@@ -20,6 +22,8 @@ void PolygonRings::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "count", count);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "get", get);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "add", add);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toFloat64Array", toFloat64Array);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "setFromArray", setFromArray);
 
 	target->Set(String::NewSymbol("PolygonRings"), constructor->GetFunction());
 }
@@ -133,4 +137,96 @@ Handle<Value> PolygonRings::add(const Arguments& args)
 	return Undefined();
 }
 
-} // namespace node_gdal
\ No newline at end of file
+Handle<Value> PolygonRings::toFloat64Array(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	Polygon *geom = ObjectWrap::Unwrap<Polygon>(parent);
+
+	int dims;
+	std::string err = LineStringPoints::parseDims(args[0], geom->get(), dims);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	std::vector<OGRLinearRing*> rings;
+	if (geom->get()->getExteriorRing()) {
+		rings.push_back(geom->get()->getExteriorRing());
+		for (int i = 0; i < geom->get()->getNumInteriorRings(); i++) {
+			rings.push_back(geom->get()->getInteriorRing(i));
+		}
+	}
+
+	std::vector<unsigned int> ring_offsets(1, 0);
+	for (unsigned int i = 0; i < rings.size(); i++) {
+		ring_offsets.push_back(ring_offsets.back() + rings[i]->getNumPoints());
+	}
+
+	Handle<Value> coordinates = TypedArray::New(GDT_Float64, ring_offsets.back() * dims);
+	if (coordinates.IsEmpty() || !coordinates->IsObject()) {
+		return scope.Close(coordinates); //TypedArray::New threw
+	}
+	double *data = static_cast<double*>(TypedArray::Data(coordinates->ToObject()));
+	for (unsigned int i = 0; i < rings.size(); i++) {
+		if (rings[i]->getNumPoints()) {
+			LineStringPoints::readPoints(rings[i], data + ring_offsets[i] * dims, dims);
+		}
+	}
+
+	Handle<Value> offsets = LineStringPoints::newOffsets(ring_offsets);
+	if (offsets.IsEmpty()) {
+		return scope.Close(offsets);
+	}
+	Local<Array> levels = Array::New(1);
+	levels->Set(0, offsets);
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("coordinates"), coordinates);
+	result->Set(String::NewSymbol("offsets"), levels);
+	return scope.Close(result);
+}
+
+Handle<Value> PolygonRings::setFromArray(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	Polygon *geom = ObjectWrap::Unwrap<Polygon>(parent);
+
+	//default to the dimension of the geometry, so toArray() output round-trips
+	int dims;
+	std::string err = LineStringPoints::parseDims(args[2], geom->get(), dims);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	double *data;
+	int n;
+	err = LineStringPoints::parseCoordinates(args[0], dims, data, n);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	//offsets can be given as returned by toFloat64Array() ([ringOffsets]) or on their own
+	Handle<Value> offsets_arg = args[1];
+	if (offsets_arg->IsArray() && Handle<Array>::Cast(offsets_arg)->Length() == 1 && Handle<Array>::Cast(offsets_arg)->Get(0)->IsObject()) {
+		offsets_arg = Handle<Array>::Cast(offsets_arg)->Get(0);
+	}
+	std::vector<unsigned int> ring_offsets;
+	err = LineStringPoints::parseOffsets(offsets_arg, n, ring_offsets);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	geom->get()->empty();
+	for (unsigned int i = 0; i + 1 < ring_offsets.size(); i++) {
+		OGRLinearRing *ring = new OGRLinearRing();
+		LineStringPoints::writePoints(ring, data + ring_offsets[i] * dims, ring_offsets[i + 1] - ring_offsets[i], dims);
+		geom->get()->addRingDirectly(ring);
+	}
+
+	return Undefined();
+}
+
+} // namespace node_gdal
@@ -31,6 +31,8 @@ public:
 	static Handle<Value> count(const Arguments &args);
 	static Handle<Value> add(const Arguments &args);
 	static Handle<Value> remove(const Arguments &args);
+	static Handle<Value> toFloat64Array(const Arguments &args);
+	static Handle<Value> setFromArray(const Arguments &args);
 
 	PolygonRings();
 private:
@@ -0,0 +1,192 @@
+#include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
+#include "../gdal_rasterband.hpp"
+#include "rasterband_blocks.hpp"
+#include "../typed_array.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+namespace node_gdal {
+
+Persistent<FunctionTemplate> RasterBandBlocks::constructor;
+
+void RasterBandBlocks::Initialize(Handle<Object> target)
+{
+	HandleScope scope;
+
+	constructor = Persistent<FunctionTemplate>::New(FunctionTemplate::New(RasterBandBlocks::New));
+	constructor->InstanceTemplate()->SetInternalFieldCount(1);
+	constructor->SetClassName(String::NewSymbol("RasterBandBlocks"));
+
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toString", toString);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "next", next);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "reset", reset);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "count", count);
+
+	ATTR_DONT_ENUM(constructor, "band", bandGetter, READ_ONLY_SETTER);
+
+	target->Set(String::NewSymbol("RasterBandBlocks"), constructor->GetFunction());
+}
+
+RasterBandBlocks::RasterBandBlocks()
+	: ObjectWrap(), bx(0), by(0), advised_row(-1), pool_index(0)
+{}
+
+RasterBandBlocks::~RasterBandBlocks()
+{}
+
+Handle<Value> RasterBandBlocks::New(const Arguments& args)
+{
+	HandleScope scope;
+
+	if (!args.IsConstructCall()) {
+		return NODE_THROW("Cannot call constructor as function, you need to use 'new' keyword");
+	}
+	if (args[0]->IsExternal()) {
+		Local<External> ext = Local<External>::Cast(args[0]);
+		void* ptr = ext->Value();
+		RasterBandBlocks *f = static_cast<RasterBandBlocks *>(ptr);
+		f->Wrap(args.This());
+		return args.This();
+	} else {
+		return NODE_THROW("Cannot create RasterBandBlocks directly");
+	}
+}
+
+Handle<Value> RasterBandBlocks::New(Handle<Value> band_obj, Handle<Array> pool)
+{
+	HandleScope scope;
+
+	RasterBandBlocks *wrapped = new RasterBandBlocks();
+
+	v8::Handle<v8::Value> ext = v8::External::New(wrapped);
+	v8::Handle<v8::Object> obj = RasterBandBlocks::constructor->GetFunction()->NewInstance(1, &ext);
+	obj->SetHiddenValue(String::NewSymbol("parent_"), band_obj);
+	obj->SetHiddenValue(String::NewSymbol("pool_"), pool);
+
+	return scope.Close(obj);
+}
+
+Handle<Value> RasterBandBlocks::toString(const Arguments& args)
+{
+	HandleScope scope;
+	return scope.Close(String::New("RasterBandBlocks"));
+}
+
+Handle<Value> RasterBandBlocks::next(const Arguments& args)
+{
+	HandleScope scope;
+
+	RasterBandBlocks *blocks = ObjectWrap::Unwrap<RasterBandBlocks>(args.This());
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->get()) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+
+	GDALRasterBand *raw = band->get();
+	int block_w = 0, block_h = 0;
+	raw->GetBlockSize(&block_w, &block_h);
+	int size_x = raw->GetXSize();
+	int size_y = raw->GetYSize();
+	int n_blocks_x = (size_x + block_w - 1) / block_w;
+	int n_blocks_y = (size_y + block_h - 1) / block_h;
+
+	if (blocks->by >= n_blocks_y) {
+		return Null();
+	}
+
+	GDALDataType type = raw->GetRasterDataType();
+	Dataset *ds = RasterBand::parentDataset(parent);
+
+	if (ds) ds->lock();
+
+	//let the driver prefetch the next row of blocks while the current one is consumed
+	if (blocks->advised_row < blocks->by) {
+		int advise_row = blocks->advised_row + 1;
+		int last_row   = std::min(blocks->by + 1, n_blocks_y - 1);
+		int advise_y   = advise_row * block_h;
+		int advise_h   = std::min((last_row + 1) * block_h, size_y) - advise_y;
+		if (advise_h > 0) {
+			raw->AdviseRead(0, advise_y, size_x, advise_h, size_x, advise_h, type, NULL);
+		}
+		blocks->advised_row = last_row;
+	}
+
+	Handle<Array> pool = Handle<Array>::Cast(args.This()->GetHiddenValue(String::NewSymbol("pool_")));
+	Handle<Object> array = pool->Get(blocks->pool_index % pool->Length())->ToObject();
+	char *data = (char*) TypedArray::Data(array);
+
+	CPLErr err = raw->ReadBlock(blocks->bx, blocks->by, data);
+
+	if (ds) ds->unlock();
+
+	if (err) return NODE_THROW_CPLERR(err);
+
+	int width  = std::min(block_w, size_x - blocks->bx * block_w);
+	int height = std::min(block_h, size_y - blocks->by * block_h);
+
+	//pack the valid part of clipped edge blocks to the start of the array
+	if (width < block_w) {
+		int bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+		for (int row = 1; row < height; row++) {
+			memmove(data + row * width * bytes_per_pixel, data + row * block_w * bytes_per_pixel, width * bytes_per_pixel);
+		}
+	}
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("bx"), Integer::New(blocks->bx));
+	result->Set(String::NewSymbol("by"), Integer::New(blocks->by));
+	result->Set(String::NewSymbol("width"), Integer::New(width));
+	result->Set(String::NewSymbol("height"), Integer::New(height));
+	result->Set(String::NewSymbol("data"), array);
+
+	blocks->pool_index++;
+	blocks->bx++;
+	if (blocks->bx >= n_blocks_x) {
+		blocks->bx = 0;
+		blocks->by++;
+	}
+
+	return scope.Close(result);
+}
+
+Handle<Value> RasterBandBlocks::reset(const Arguments& args)
+{
+	HandleScope scope;
+
+	RasterBandBlocks *blocks = ObjectWrap::Unwrap<RasterBandBlocks>(args.This());
+	blocks->bx = 0;
+	blocks->by = 0;
+	blocks->advised_row = -1;
+	blocks->pool_index = 0;
+
+	return Undefined();
+}
+
+Handle<Value> RasterBandBlocks::count(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->get()) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+
+	int block_w = 0, block_h = 0;
+	band->get()->GetBlockSize(&block_w, &block_h);
+	int n_blocks_x = (band->get()->GetXSize() + block_w - 1) / block_w;
+	int n_blocks_y = (band->get()->GetYSize() + block_h - 1) / block_h;
+
+	return scope.Close(Integer::New(n_blocks_x * n_blocks_y));
+}
+
+Handle<Value> RasterBandBlocks::bandGetter(Local<String> property, const AccessorInfo &info)
+{
+	HandleScope scope;
+	return scope.Close(info.This()->GetHiddenValue(String::NewSymbol("parent_")));
+}
+
+} // namespace node_gdal
@@ -0,0 +1,47 @@
+#ifndef __NODE_GDAL_BAND_BLOCKS_H__
+#define __NODE_GDAL_BAND_BLOCKS_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// gdal
+#include <gdal_priv.h>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Cursor over the blocks of a band in on-disk (row-major) order.
+// Blocks are read into a pool of caller-provided arrays that is cycled
+// through, so scanning a raster does not allocate an array per block.
+
+class RasterBandBlocks: public node::ObjectWrap {
+public:
+	static Persistent<FunctionTemplate> constructor;
+
+	static void Initialize(Handle<Object> target);
+	static Handle<Value> New(const Arguments &args);
+	static Handle<Value> New(Handle<Value> band_obj, Handle<Array> pool);
+	static Handle<Value> toString(const Arguments &args);
+
+	static Handle<Value> next(const Arguments &args);
+	static Handle<Value> reset(const Arguments &args);
+	static Handle<Value> count(const Arguments &args);
+
+	static Handle<Value> bandGetter(Local<String> property, const AccessorInfo &info);
+
+	RasterBandBlocks();
+private:
+	~RasterBandBlocks();
+	int bx, by;
+	int advised_row;
+	unsigned int pool_index;
+};
+
+}
+#endif
@@ -1,4 +1,5 @@
 #include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
 #include "../gdal_rasterband.hpp"
 #include "rasterband_overviews.hpp"
 
@@ -76,6 +77,8 @@ Handle<Value> RasterBandOverviews::get(const Arguments& args)
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	int id;
 	NODE_ARG_INT(0, "id", id);
 	
@@ -98,6 +101,8 @@ Handle<Value> RasterBandOverviews::getBySampleCount(const Arguments& args)
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	int n_samples;
 	NODE_ARG_INT(0, "minimum number of samples", n_samples);
 	
@@ -115,7 +120,9 @@ Handle<Value> RasterBandOverviews::count(const Arguments& args)
 	if (!band->get()) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
-	
+
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	return scope.Close(Integer::New(band->get()->GetOverviewCount()));
 }
 
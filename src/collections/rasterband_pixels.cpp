@@ -1,6 +1,9 @@
 #include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
 #include "../gdal_rasterband.hpp"
+#include "../async_worker.hpp"
 #include "rasterband_pixels.hpp"
+#include "rasterband_blocks.hpp"
 #include "../typed_array.hpp"
 
 namespace node_gdal {
@@ -20,8 +23,11 @@ void RasterBandPixels::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "set", set);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "read", read);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "write", write);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "readAsync", readAsync);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "writeAsync", writeAsync);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "readBlock", readBlock);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "writeBlock", writeBlock);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "blocks", blocks);
 
 	target->Set(String::NewSymbol("RasterBandPixels"), constructor->GetFunction());
 }
@@ -80,6 +86,8 @@ Handle<Value> RasterBandPixels::get(const Arguments& args)
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	int x, y;
 	double val;
 
@@ -102,6 +110,8 @@ Handle<Value> RasterBandPixels::set(const Arguments& args)
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	int x, y;
 	double val;
 
@@ -115,7 +125,55 @@ Handle<Value> RasterBandPixels::set(const Arguments& args)
 	return scope.Close(Undefined());
 }
 
-Handle<Value> RasterBandPixels::read(const Arguments& args)
+// --- RasterIO shared by read(), write() and their async counterparts ---
+
+class RasterIOWorker : public AsyncWorker {
+public:
+	RasterIOWorker(Handle<Function> callback, Dataset *ds, RasterBand *band, GDALRWFlag flag,
+	               int x, int y, int w, int h, void *data, int buffer_w, int buffer_h,
+	               GDALDataType type, int pixel_space, int line_space)
+		: AsyncWorker(callback), ds(ds), band(band), flag(flag), x(x), y(y), w(w), h(h), data(data),
+		  buffer_w(buffer_w), buffer_h(buffer_h), type(type), pixel_space(pixel_space), line_space(line_space)
+	{}
+
+	void Execute()
+	{
+		if (ds) ds->lock();
+
+		//the dataset may have been closed while the job was queued
+		GDALRasterBand *raw = band->get();
+		if (!raw) {
+			if (ds) ds->unlock();
+			SetErrorMessage("RasterBand object has already been destroyed");
+			return;
+		}
+
+		CPLErr err = raw->RasterIO(flag, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+
+		if (ds) ds->unlock();
+
+		if (err) SetErrorMessage(CPLGetLastErrorMsg());
+	}
+
+	Handle<Value> GetResult()
+	{
+		HandleScope scope;
+		if (flag == GF_Write) return Undefined();
+		return scope.Close(GetFromPersistent("array"));
+	}
+
+private:
+	Dataset *ds;
+	RasterBand *band;
+	GDALRWFlag flag;
+	int x, y, w, h;
+	void *data;
+	int buffer_w, buffer_h;
+	GDALDataType type;
+	int pixel_space, line_space;
+};
+
+static Handle<Value> readPixels(const Arguments& args, bool async)
 {
 	HandleScope scope;
 
@@ -133,6 +191,7 @@ Handle<Value> RasterBandPixels::read(const Arguments& args)
 	void *data;
 	Handle<Value>  array;
 	Handle<Object> passed_array;
+	Handle<Function> callback;
 	GDALDataType type;
 
 
@@ -165,6 +224,10 @@ Handle<Value> RasterBandPixels::read(const Arguments& args)
 	line_space = pixel_space * buffer_w;
 	NODE_ARG_INT_OPT(9, "line_space", line_space);
 
+	if(async) {
+		NODE_ARG_CALLBACK(10, "callback", callback);
+	}
+
 	if(pixel_space < bytes_per_pixel) {
 		return NODE_THROW("pixel_space must be greater than or equal to size of data_type");
 	}
@@ -192,13 +255,26 @@ Handle<Value> RasterBandPixels::read(const Arguments& args)
  		data = TypedArray::Data(passed_array);
 	}
 
+	Dataset *ds = RasterBand::parentDataset(parent);
+
+	if(async) {
+		RasterIOWorker *worker = new RasterIOWorker(callback, ds, band, GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+		//keep the array and band alive until RasterIO is done with them
+		worker->SaveToPersistent("array", array);
+		worker->SaveToPersistent("band", parent);
+		AsyncWorker::Queue(worker);
+		return Undefined();
+	}
+
+	if (ds) ds->lock();
 	CPLErr err = band->get()->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+	if (ds) ds->unlock();
 	if(err) return NODE_THROW_CPLERR(err);
 
 	return scope.Close(array);
 }
 
-Handle<Value> RasterBandPixels::write(const Arguments& args)
+static Handle<Value> writePixels(const Arguments& args, bool async)
 {
 	HandleScope scope;
 
@@ -215,6 +291,7 @@ Handle<Value> RasterBandPixels::write(const Arguments& args)
 	int size, min_size, min_length;
 	void *data;
 	Handle<Object> passed_array;
+	Handle<Function> callback;
 	GDALDataType type;
 
 	NODE_ARG_INT(0, "x_offset", x);
@@ -239,6 +316,10 @@ Handle<Value> RasterBandPixels::write(const Arguments& args)
 	line_space = pixel_space * buffer_w;
 	NODE_ARG_INT_OPT(8, "line_space", line_space);
 
+	if(async) {
+		NODE_ARG_CALLBACK(9, "callback", callback);
+	}
+
 	size       = line_space * buffer_h; //bytes
 	min_size   = size - (pixel_space - bytes_per_pixel); //subtract away padding on last pixel that wont be read
 	min_length = (min_size+bytes_per_pixel-1)/bytes_per_pixel;
@@ -255,12 +336,44 @@ Handle<Value> RasterBandPixels::write(const Arguments& args)
 
 	data = TypedArray::Data(passed_array);
 
+	Dataset *ds = RasterBand::parentDataset(parent);
+
+	if(async) {
+		RasterIOWorker *worker = new RasterIOWorker(callback, ds, band, GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+		worker->SaveToPersistent("array", passed_array);
+		worker->SaveToPersistent("band", parent);
+		AsyncWorker::Queue(worker);
+		return Undefined();
+	}
+
+	if (ds) ds->lock();
 	CPLErr err = band->get()->RasterIO(GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+	if (ds) ds->unlock();
 	if(err) return NODE_THROW_CPLERR(err);
 
 	return scope.Close(Undefined());
 }
 
+Handle<Value> RasterBandPixels::read(const Arguments& args)
+{
+	return readPixels(args, false);
+}
+
+Handle<Value> RasterBandPixels::write(const Arguments& args)
+{
+	return writePixels(args, false);
+}
+
+Handle<Value> RasterBandPixels::readAsync(const Arguments& args)
+{
+	return readPixels(args, true);
+}
+
+Handle<Value> RasterBandPixels::writeAsync(const Arguments& args)
+{
+	return writePixels(args, true);
+}
+
 Handle<Value> RasterBandPixels::readBlock(const Arguments& args)
 {
 	HandleScope scope;
@@ -271,6 +384,8 @@ Handle<Value> RasterBandPixels::readBlock(const Arguments& args)
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	int x, y, w = 0, h = 0;
 	NODE_ARG_INT(0, "block_x_offset", x);
 	NODE_ARG_INT(1, "block_y_offset", y);
@@ -316,6 +431,8 @@ Handle<Value> RasterBandPixels::writeBlock(const Arguments& args)
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
+	DatasetLock lock(RasterBand::parentDataset(parent));
+
 	int x, y, w = 0, h = 0;
 
 	band->get()->GetBlockSize(&w, &h);
@@ -342,5 +459,47 @@ Handle<Value> RasterBandPixels::writeBlock(const Arguments& args)
 	return scope.Close(Undefined());
 }
 
+Handle<Value> RasterBandPixels::blocks(const Arguments& args)
+{
+	HandleScope scope;
 
-}
\ No newline at end of file
+	Handle<Object> parent = args.This()->GetHiddenValue(String::NewSymbol("parent_"))->ToObject();
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->get()) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+
+	int w = 0, h = 0;
+	band->get()->GetBlockSize(&w, &h);
+	GDALDataType type = band->get()->GetRasterDataType();
+
+	Handle<Array> pool;
+	NODE_ARG_ARRAY_OPT(0, "pool", pool);
+
+	if (pool.IsEmpty() || pool->Length() == 0) {
+		Handle<Value> array = TypedArray::New(type, w * h);
+		if(array.IsEmpty() || !array->IsObject()) {
+			return array; //TypedArray::New threw an error
+		}
+		pool = Array::New(1);
+		pool->Set(0, array);
+	} else {
+		//a copy, so the caller emptying or changing its array can't break the cursor
+		Handle<Array> copy = Array::New(pool->Length());
+		for (unsigned int i = 0; i < pool->Length(); i++) {
+			Handle<Value> val = pool->Get(i);
+			if (!val->IsObject() || TypedArray::Identify(val->ToObject()) != type) {
+				return NODE_THROW("Array type does not match band data type");
+			}
+			if (TypedArray::Length(val->ToObject()) < w*h) {
+				return NODE_THROW("Array length must be greater than or equal to blockSize.x * blockSize.y");
+			}
+			copy->Set(i, val);
+		}
+		pool = copy;
+	}
+
+	return scope.Close(RasterBandBlocks::New(parent, pool));
+}
+
+}
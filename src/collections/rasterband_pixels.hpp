@@ -29,8 +29,11 @@ public:
 	static Handle<Value> set(const Arguments &args);
 	static Handle<Value> read(const Arguments &args);
 	static Handle<Value> write(const Arguments &args);
+	static Handle<Value> readAsync(const Arguments &args);
+	static Handle<Value> writeAsync(const Arguments &args);
 	static Handle<Value> readBlock(const Arguments &args);
 	static Handle<Value> writeBlock(const Arguments &args);
+	static Handle<Value> blocks(const Arguments &args);
 	
 	RasterBandPixels();
 private:
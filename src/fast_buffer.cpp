@@ -3,6 +3,26 @@
 #include <cstring>
 #include "fast_buffer.hpp"
 
+Persistent<Function> FastBuffer::constructor;
+
+//wraps a SlowBuffer in a JS Buffer, looking up the Buffer constructor only once
+Handle<Value> FastBuffer::wrap(node::Buffer *slowBuffer, int length)
+{
+	HandleScope scope;
+
+	if (constructor.IsEmpty()) {
+		v8::Local<v8::Object> globalObj = v8::Context::GetCurrent()->Global();
+		v8::Local<v8::Function> bufferConstructor = v8::Local<v8::Function>::Cast(globalObj->Get(v8::String::New("Buffer")));
+		constructor = v8::Persistent<v8::Function>::New(bufferConstructor);
+	}
+
+	v8::Handle<v8::Value> constructorArgs[3] = { slowBuffer->handle_, v8::Integer::New(length), v8::Integer::New(0) };
+
+	v8::Local<v8::Object> actualBuffer = constructor->NewInstance(3, constructorArgs);
+
+	return scope.Close(actualBuffer);
+}
+
 Handle<Value> FastBuffer::New(unsigned char *data, int length) 
 {
 	HandleScope scope;
@@ -11,11 +31,24 @@ Handle<Value> FastBuffer::New(unsigned char *data, int length)
 
 	memcpy(node::Buffer::Data(slowBuffer), data, length);
 
-	v8::Local<v8::Object> globalObj = v8::Context::GetCurrent()->Global();
-	v8::Local<v8::Function> bufferConstructor = v8::Local<v8::Function>::Cast(globalObj->Get(v8::String::New("Buffer")));
-	v8::Handle<v8::Value> constructorArgs[3] = { slowBuffer->handle_, v8::Integer::New(length), v8::Integer::New(0) };
-	
-	v8::Local<v8::Object> actualBuffer = bufferConstructor->NewInstance(3, constructorArgs);
+	return scope.Close(wrap(slowBuffer, length));
+}
 
-	return scope.Close(actualBuffer);
-}
\ No newline at end of file
+Handle<Value> FastBuffer::New(char *data, int length, node::Buffer::free_callback cb, void *hint)
+{
+	HandleScope scope;
+
+	node::Buffer *slowBuffer = node::Buffer::New(data, length, cb, hint);
+
+	return scope.Close(wrap(slowBuffer, length));
+}
+
+Handle<Value> FastBuffer::New(int length, unsigned char **data)
+{
+	HandleScope scope;
+
+	node::Buffer *slowBuffer = node::Buffer::New(length);
+	*data = (unsigned char*) node::Buffer::Data(slowBuffer);
+
+	return scope.Close(wrap(slowBuffer, length));
+}
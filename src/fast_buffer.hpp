@@ -14,6 +14,14 @@ using namespace node;
 class FastBuffer {
 public:
 	static v8::Handle<v8::Value> New(unsigned char * data, int length);
+	//takes ownership of data instead of copying it, cb is called to free it
+	static v8::Handle<v8::Value> New(char * data, int length, node::Buffer::free_callback cb, void *hint);
+	//allocates an uninitialized buffer and sets data to its memory, so it can be written in place
+	static v8::Handle<v8::Value> New(int length, unsigned char **data);
+
+private:
+	static v8::Handle<v8::Value> wrap(node::Buffer *slowBuffer, int length);
+	static v8::Persistent<v8::Function> constructor;
 };
 
 #endif
@@ -6,12 +6,15 @@
 
 // node
 #include <node.h>
+#include <node_buffer.h>
 
 // ogr
 #include <ogr_api.h>
 #include <ogrsf_frmts.h>
 
 // gdal
+#include <cpl_vsi.h>
+
 #include "gdal_common.hpp"
 #include "gdal_driver.hpp"
 #include "gdal_dataset.hpp"
@@ -51,6 +54,89 @@ namespace node_gdal {
 		return NODE_THROW("Error opening dataset");
 	}
 
+	static Handle<Value> openBuffer(const Arguments &args)
+	{
+		HandleScope scope;
+
+		Handle<Object> buffer;
+		Handle<Array> drivers;
+		std::string mode = "r";
+		std::string filename = "";
+		GDALAccess access = GA_ReadOnly;
+
+		NODE_ARG_OBJECT(0, "buffer", buffer);
+		NODE_ARG_OPT_STR(1, "mode", mode);
+		NODE_ARG_ARRAY_OPT(2, "drivers", drivers);
+		NODE_ARG_OPT_STR(3, "filename", filename);
+
+		if (!Buffer::HasInstance(buffer)) {
+			return NODE_THROW("buffer must be a Buffer");
+		}
+		if (mode == "r+") {
+			access = GA_Update;
+		} else if (mode != "r") {
+			return NODE_THROW("Invalid open mode. Must be \"r\" or \"r+\"");
+		}
+
+		unsigned char *data = (unsigned char*) Buffer::Data(buffer);
+		size_t length = Buffer::Length(buffer);
+
+		//zip archives are opened through /vsizip/ so zipped shapefiles etc. work
+		bool zipped = length >= 4 && memcmp(data, "PK\x03\x04", 4) == 0;
+		if (filename.empty()) {
+			filename = zipped ? "buffer.zip" : "buffer";
+		}
+		std::string mem_path  = Dataset::uniqueMemPath(CPLGetFilename(filename.c_str()));
+		std::string open_path = zipped ? "/vsizip/" + mem_path : mem_path;
+
+		//the file refers to the buffer's memory without copying it
+		VSILFILE *fp = VSIFileFromMemBuffer(mem_path.c_str(), data, length, FALSE);
+		if (!fp) {
+			return NODE_THROW("Error creating in-memory file");
+		}
+		VSIFCloseL(fp);
+
+		OGRDataSource *ogr_ds = NULL;
+		GDALDataset *gdal_ds = NULL;
+
+		if (drivers.IsEmpty()) {
+			ogr_ds = OGRSFDriverRegistrar::Open(open_path.c_str(), static_cast<int>(access));
+			if (!ogr_ds) {
+				gdal_ds = (GDALDataset*) GDALOpen(open_path.c_str(), access);
+			}
+		} else {
+			for (unsigned int i = 0; i < drivers->Length() && !ogr_ds && !gdal_ds; i++) {
+				Handle<Value> val = drivers->Get(i);
+				if (!IS_WRAPPED(val, Driver)) {
+					VSIUnlink(mem_path.c_str());
+					return NODE_THROW("drivers must only contain Driver objects");
+				}
+				Driver *driver = ObjectWrap::Unwrap<Driver>(val->ToObject());
+				if (driver->uses_ogr) {
+					ogr_ds = driver->getOGRSFDriver()->Open(open_path.c_str(), static_cast<int>(access));
+				} else {
+					GDALOpenInfo *info = new GDALOpenInfo(open_path.c_str(), access);
+					gdal_ds = driver->getGDALDriver()->pfnOpen(info);
+					delete info;
+				}
+			}
+		}
+
+		Handle<Value> ds;
+		if (ogr_ds) {
+			ds = Dataset::New(ogr_ds);
+		} else if (gdal_ds) {
+			ds = Dataset::New(gdal_ds);
+		} else {
+			VSIUnlink(mem_path.c_str());
+			return NODE_THROW("Error opening dataset");
+		}
+
+		ObjectWrap::Unwrap<Dataset>(ds->ToObject())->attachMemFile(mem_path, buffer);
+
+		return scope.Close(ds);
+	}
+
 	static Handle<Value> setConfigOption(const Arguments &args)
 	{
 		HandleScope scope;
@@ -0,0 +1,1708 @@
+
+#include "gdal_common.hpp"
+#include "gdal_algorithms.hpp"
+#include "gdal_dataset.hpp"
+#include "gdal_rasterband.hpp"
+#include "gdal_layer.hpp"
+#include "gdal_geometry.hpp"
+#include "typed_array.hpp"
+#include "async_worker.hpp"
+
+// node
+#include <node_buffer.h>
+
+// gdal
+#include <gdalgrid.h>
+#ifdef HAVE_GDAL_ALG_PRIV
+//the scanline rasterizers aren't part of the public API, they are only reachable when building against the bundled GDAL
+#include <gdal_alg_priv.h>
+#endif
+#include <cpl_multiproc.h>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+void Algorithms::Initialize(Handle<Object> target)
+{
+	NODE_SET_METHOD(target, "polygonize", polygonize);
+	NODE_SET_METHOD(target, "polygonizeAsync", polygonizeAsync);
+	NODE_SET_METHOD(target, "rasterize", rasterize);
+	NODE_SET_METHOD(target, "rasterizeAsync", rasterizeAsync);
+	NODE_SET_METHOD(target, "contourGenerate", contourGenerate);
+	NODE_SET_METHOD(target, "contourGenerateAsync", contourGenerateAsync);
+	NODE_SET_METHOD(target, "computeProximity", computeProximity);
+	NODE_SET_METHOD(target, "computeProximityAsync", computeProximityAsync);
+	NODE_SET_METHOD(target, "sieveFilter", sieveFilter);
+	NODE_SET_METHOD(target, "sieveFilterAsync", sieveFilterAsync);
+	NODE_SET_METHOD(target, "fillNodata", fillNodata);
+	NODE_SET_METHOD(target, "fillNodataAsync", fillNodataAsync);
+	NODE_SET_METHOD(target, "grid", grid);
+	NODE_SET_METHOD(target, "gridAsync", gridAsync);
+	NODE_SET_METHOD(target, "zonalStatistics", zonalStatistics);
+	NODE_SET_METHOD(target, "zonalStatisticsAsync", zonalStatisticsAsync);
+}
+
+//locks a set of datasets, always in address order so concurrent jobs can't deadlock
+class DatasetLocks {
+public:
+	void add(Dataset *ds)
+	{
+		if (!ds) return;
+		if (std::find(datasets.begin(), datasets.end(), ds) != datasets.end()) return;
+		datasets.push_back(ds);
+		std::sort(datasets.begin(), datasets.end());
+	}
+
+	void lock()
+	{
+		for (unsigned int i = 0; i < datasets.size(); i++) datasets[i]->lock();
+	}
+
+	void unlock()
+	{
+		for (unsigned int i = datasets.size(); i > 0; i--) datasets[i - 1]->unlock();
+	}
+
+private:
+	std::vector<Dataset*> datasets;
+};
+
+// A single algorithm call. parse() reads the options object on the JS thread,
+// run() does the work with all datasets involved locked (on the JS thread or
+// a worker thread) and result() converts the output back to JS.
+class AlgorithmJob {
+public:
+	AlgorithmJob()
+		: progress(NULL), progress_arg(NULL)
+	{
+		pinned = Persistent<Array>::New(Array::New());
+	}
+
+	virtual ~AlgorithmJob()
+	{
+		pinned.Dispose();
+		pinned.Clear();
+	}
+
+	//returns an error message or ""
+	virtual std::string parse(Handle<Object> options) = 0;
+	//returns an error message or ""
+	virtual std::string run() = 0;
+	virtual Handle<Value> result()
+	{
+		return Undefined();
+	}
+
+	DatasetLocks locks;
+	GDALProgressFunc progress;
+	void *progress_arg;
+
+protected:
+	//keeps the wrapper alive for as long as the job and locks its dataset while running
+	void pin(Handle<Value> value, Dataset *parent)
+	{
+		pinned->Set(pinned->Length(), value);
+		locks.add(parent);
+	}
+
+	std::string getDataset(Handle<Object> options, const char *key, bool required, Dataset *&ds)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol(key));
+		ds = NULL;
+		if (val->IsUndefined() || val->IsNull()) {
+			return required ? std::string(key) + " must be given" : "";
+		}
+		if (!Dataset::constructor->HasInstance(val)) {
+			return std::string(key) + " must be an instance of Dataset";
+		}
+		ds = ObjectWrap::Unwrap<Dataset>(val->ToObject());
+		if (!ds->getDataset() && !ds->getDatasource()) {
+			return "Dataset object has already been destroyed";
+		}
+		pin(val, ds);
+		return "";
+	}
+
+	std::string getBand(Handle<Object> options, const char *key, bool required, RasterBand *&band)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol(key));
+		band = NULL;
+		if (val->IsUndefined() || val->IsNull()) {
+			return required ? std::string(key) + " must be given" : "";
+		}
+		if (!RasterBand::constructor->HasInstance(val)) {
+			return std::string(key) + " must be an instance of RasterBand";
+		}
+		band = ObjectWrap::Unwrap<RasterBand>(val->ToObject());
+		if (!band->get()) {
+			return "RasterBand object has already been destroyed";
+		}
+		pin(val, RasterBand::parentDataset(val->ToObject()));
+		return "";
+	}
+
+	std::string getLayer(Handle<Object> options, const char *key, bool required, Layer *&layer)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol(key));
+		layer = NULL;
+		if (val->IsUndefined() || val->IsNull()) {
+			return required ? std::string(key) + " must be given" : "";
+		}
+		if (!Layer::constructor->HasInstance(val)) {
+			return std::string(key) + " must be an instance of Layer";
+		}
+		layer = ObjectWrap::Unwrap<Layer>(val->ToObject());
+		if (!layer->get()) {
+			return "Layer object has already been destroyed";
+		}
+		pin(val, Layer::parentDataset(val->ToObject()));
+		return "";
+	}
+
+	//resolves a field given by index or name, -1 if not given
+	static std::string getField(Handle<Object> options, const char *key, OGRLayer *layer, int &field)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol(key));
+		field = -1;
+		if (val->IsUndefined() || val->IsNull()) return "";
+
+		OGRFeatureDefn *defn = layer->GetLayerDefn();
+		if (val->IsString()) {
+			field = defn->GetFieldIndex(TOSTR(val));
+			if (field < 0) return std::string(key) + ": field \"" + TOSTR(val) + "\" not found";
+		} else if (val->IsInt32()) {
+			field = val->Int32Value();
+			if (field < 0 || field >= defn->GetFieldCount()) return std::string(key) + ": invalid field index";
+		} else {
+			return std::string(key) + " must be a field name or index";
+		}
+		return "";
+	}
+
+	//reads an optional number. returns an error message or ""
+	static std::string getNumber(Handle<Object> options, const char *key, double &value, bool *found = NULL)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol(key));
+		if (found) *found = false;
+		if (val->IsUndefined() || val->IsNull()) return "";
+		if (!val->IsNumber()) return std::string(key) + " must be a number";
+		value = val->NumberValue();
+		if (found) *found = true;
+		return "";
+	}
+
+	//reads a number, an array of numbers or a typed array
+	static std::string getNumbers(Handle<Value> val, const char *key, std::vector<double> &values)
+	{
+		values.clear();
+		if (val->IsNumber()) {
+			values.push_back(val->NumberValue());
+		} else if (val->IsArray()) {
+			Handle<Array> array = Handle<Array>::Cast(val);
+			for (unsigned int i = 0; i < array->Length(); i++) {
+				Handle<Value> item = array->Get(i);
+				if (!item->IsNumber()) return std::string(key) + " must only contain numbers";
+				values.push_back(item->NumberValue());
+			}
+		} else if (val->IsObject() && TypedArray::Identify(val->ToObject()) != GDT_Unknown) {
+			Handle<Object> array = val->ToObject();
+			int n = TypedArray::Length(array);
+			for (int i = 0; i < n; i++) {
+				values.push_back(array->Get(i)->NumberValue());
+			}
+		} else {
+			return std::string(key) + " must be a number or an array of numbers";
+		}
+		return "";
+	}
+
+	//the message of the error reported by GDAL on this thread
+	static std::string lastError(const char *fallback)
+	{
+		std::string msg = CPLGetLastErrorMsg();
+		return msg.empty() ? fallback : msg;
+	}
+
+private:
+	Persistent<Array> pinned;
+};
+
+class AlgorithmWorker : public AsyncProgressWorker {
+public:
+	AlgorithmWorker(AlgorithmJob *job, Handle<Function> callback, Handle<Function> progress_cb)
+		: AsyncProgressWorker(callback, progress_cb), job(job)
+	{
+		job->progress = AsyncProgressWorker::ProgressFunc;
+		job->progress_arg = this;
+	}
+
+	~AlgorithmWorker()
+	{
+		delete job;
+	}
+
+	void Execute()
+	{
+		CPLErrorReset();
+		job->locks.lock();
+		std::string error = job->run();
+		job->locks.unlock();
+		if (!error.empty()) SetErrorMessage(error.c_str());
+	}
+
+	Handle<Value> GetResult()
+	{
+		return job->result();
+	}
+
+private:
+	AlgorithmJob *job;
+};
+
+static Handle<Function> getProgress(Handle<Object> options)
+{
+	Handle<Value> val = options->Get(String::NewSymbol("progress"));
+	if (val->IsFunction()) {
+		return Handle<Function>::Cast(val);
+	}
+	return Handle<Function>();
+}
+
+//gdal.<algorithm>(options)
+template <typename J>
+static Handle<Value> runSync(const Arguments &args)
+{
+	HandleScope scope;
+
+	Handle<Object> options;
+	NODE_ARG_OBJECT(0, "options", options);
+
+	J job;
+	std::string error = job.parse(options);
+	if (!error.empty()) {
+		return NODE_THROW(error.c_str());
+	}
+
+	Handle<Function> progress_cb = getProgress(options);
+	if (!progress_cb.IsEmpty()) {
+		job.progress = SyncProgressFunc;
+		job.progress_arg = &progress_cb;
+	}
+
+	TryCatch try_catch;
+
+	CPLErrorReset();
+	job.locks.lock();
+	error = job.run();
+	job.locks.unlock();
+
+	if (try_catch.HasCaught()) {
+		return try_catch.ReThrow();
+	}
+	if (!error.empty()) {
+		return NODE_THROW(error.c_str());
+	}
+
+	return scope.Close(job.result());
+}
+
+//gdal.<algorithm>Async(options, callback)
+template <typename J>
+static Handle<Value> runAsync(const Arguments &args)
+{
+	HandleScope scope;
+
+	Handle<Object> options;
+	Handle<Function> callback;
+	NODE_ARG_OBJECT(0, "options", options);
+	NODE_ARG_CALLBACK(1, "callback", callback);
+
+	J *job = new J();
+	std::string error = job->parse(options);
+	if (!error.empty()) {
+		delete job;
+		return NODE_THROW(error.c_str());
+	}
+
+	AsyncWorker::Queue(new AlgorithmWorker(job, callback, getProgress(options)));
+
+	return Undefined();
+}
+
+// ----- polygonize -----
+
+class PolygonizeJob : public AlgorithmJob {
+public:
+	PolygonizeJob()
+		: src(NULL), mask(NULL), dst(NULL), pix_val_field(-1), connectedness(4)
+	{}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getBand(options, "src", true, src)).empty()) return err;
+		if (!(err = getBand(options, "mask", false, mask)).empty()) return err;
+		if (!(err = getLayer(options, "dst", true, dst)).empty()) return err;
+		if (!(err = getField(options, "pixValField", dst->get(), pix_val_field)).empty()) return err;
+
+		Handle<Value> val = options->Get(String::NewSymbol("connectedness"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsInt32() || (val->Int32Value() != 4 && val->Int32Value() != 8)) {
+				return "connectedness must be 4 or 8";
+			}
+			connectedness = val->Int32Value();
+		}
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *src_band  = src->get();
+		GDALRasterBand *mask_band = mask ? mask->get() : NULL;
+		OGRLayer *dst_layer = dst->get();
+
+		//the objects may have been destroyed while the job was queued
+		if (!src_band || (mask && !mask_band)) return "RasterBand object has already been destroyed";
+		if (!dst_layer) return "Layer object has already been destroyed";
+
+		char **options = NULL;
+		if (connectedness == 8) {
+			options = CSLSetNameValue(options, "8CONNECTED", "8");
+		}
+
+		//integer bands are traced with integer comparisons, floating point ones as floats
+		CPLErr err;
+		GDALDataType type = src_band->GetRasterDataType();
+		if (type == GDT_Float32 || type == GDT_Float64 || type == GDT_CFloat32 || type == GDT_CFloat64) {
+			err = GDALFPolygonize(src_band, mask_band, dst_layer, pix_val_field, options, progress, progress_arg);
+		} else {
+			err = GDALPolygonize(src_band, mask_band, dst_layer, pix_val_field, options, progress, progress_arg);
+		}
+		CSLDestroy(options);
+
+		if (err != CE_None) return lastError("Error polygonizing raster");
+		return "";
+	}
+
+private:
+	RasterBand *src;
+	RasterBand *mask;
+	Layer *dst;
+	int pix_val_field;
+	int connectedness;
+};
+
+Handle<Value> Algorithms::polygonize(const Arguments &args)
+{
+	return runSync<PolygonizeJob>(args);
+}
+
+Handle<Value> Algorithms::polygonizeAsync(const Arguments &args)
+{
+	return runAsync<PolygonizeJob>(args);
+}
+
+// ----- rasterize -----
+
+class RasterizeJob : public AlgorithmJob {
+public:
+	RasterizeJob()
+		: dst(NULL), all_touched(false), merge_alg("REPLACE"), attribute("")
+	{}
+
+	~RasterizeJob()
+	{
+		for (unsigned int i = 0; i < shapes.size(); i++) {
+			if (shapes[i].geom) OGRGeometryFactory::destroyGeometry(shapes[i].geom);
+		}
+	}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getDataset(options, "dst", true, dst)).empty()) return err;
+		if (dst->uses_ogr) return "dst must be a raster dataset";
+
+		GDALDataset *ds = dst->getDataset();
+		Handle<Value> val = options->Get(String::NewSymbol("bands"));
+		if (val->IsUndefined() || val->IsNull()) {
+			bands.push_back(1);
+		} else {
+			std::vector<double> list;
+			if (!(err = getNumbers(val, "bands", list)).empty()) return err;
+			for (unsigned int i = 0; i < list.size(); i++) {
+				int band = (int) list[i];
+				if (band < 1 || band > ds->GetRasterCount()) return "bands contains an invalid band number";
+				bands.push_back(band);
+			}
+		}
+		if (bands.empty() || ds->GetRasterCount() < 1) return "dst does not have any bands to burn";
+
+		Handle<Value> layers_obj = options->Get(String::NewSymbol("layers"));
+		Handle<Value> geoms_obj  = options->Get(String::NewSymbol("geometries"));
+		bool has_layers = !layers_obj->IsUndefined() && !layers_obj->IsNull();
+		bool has_geoms  = !geoms_obj->IsUndefined() && !geoms_obj->IsNull();
+		if (has_layers == has_geoms) return "Either layers or geometries must be given";
+
+		unsigned int n_shapes;
+		if (has_layers) {
+			if (!(err = parseLayers(layers_obj)).empty()) return err;
+			n_shapes = layers.size();
+		} else {
+			if (!(err = parseGeometries(geoms_obj)).empty()) return err;
+			n_shapes = shapes.size();
+		}
+
+		val = options->Get(String::NewSymbol("attribute"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!has_layers) return "attribute can only be used with layers";
+			if (!val->IsString()) return "attribute must be a string";
+			attribute = TOSTR(val);
+		}
+
+		//one value for all bands, one per band, or one per band of each layer / geometry
+		val = options->Get(String::NewSymbol("burnValues"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			std::vector<double> values;
+			if (!(err = getNumbers(val, "burnValues", values)).empty()) return err;
+			unsigned int n_bands = bands.size();
+			if (values.size() == 1) {
+				burn_values.assign(n_shapes * n_bands, values[0]);
+			} else if (values.size() == n_bands) {
+				for (unsigned int i = 0; i < n_shapes; i++) {
+					burn_values.insert(burn_values.end(), values.begin(), values.end());
+				}
+			} else if (values.size() == n_shapes * n_bands) {
+				burn_values = values;
+			} else {
+				return "burnValues must have one value, one per band or one per band of each layer / geometry";
+			}
+		} else if (attribute.empty()) {
+			return "Either burnValues or attribute must be given";
+		}
+
+		all_touched = options->Get(String::NewSymbol("allTouched"))->IsTrue();
+
+		val = options->Get(String::NewSymbol("mergeAlg"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			std::string alg = val->IsString() ? TOSTR(val) : "";
+			for (unsigned int i = 0; i < alg.length(); i++) alg[i] = toupper(alg[i]);
+			if (alg != "REPLACE" && alg != "ADD") return "mergeAlg must be 'replace' or 'add'";
+			merge_alg = alg;
+		}
+
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALDataset *ds = dst->getDataset();
+
+		//the objects may have been destroyed while the job was queued
+		if (!ds) return "Dataset object has already been destroyed";
+
+		char **options = NULL;
+		if (all_touched) options = CSLSetNameValue(options, "ALL_TOUCHED", "TRUE");
+		options = CSLSetNameValue(options, "MERGE_ALG", merge_alg.c_str());
+		if (!attribute.empty()) options = CSLSetNameValue(options, "ATTRIBUTE", attribute.c_str());
+
+		double *values = burn_values.empty() ? NULL : &burn_values[0];
+		CPLErr err;
+
+		if (!layers.empty()) {
+			std::vector<OGRLayerH> raw_layers;
+			for (unsigned int i = 0; i < layers.size(); i++) {
+				OGRLayer *layer = layers[i]->get();
+				if (!layer) {
+					CSLDestroy(options);
+					return "Layer object has already been destroyed";
+				}
+				raw_layers.push_back(layer);
+			}
+			err = GDALRasterizeLayers(ds, bands.size(), &bands[0], raw_layers.size(), &raw_layers[0],
+			                          NULL, NULL, values, options, progress, progress_arg);
+		} else {
+			//packed WKB is only decoded here, off the JS thread
+			std::vector<OGRGeometryH> geoms;
+			for (unsigned int i = 0; i < shapes.size(); i++) {
+				Shape &shape = shapes[i];
+				if (!shape.geom && shape.wkb) {
+					OGRErr ogr_err = OGRGeometryFactory::createFromWkb(const_cast<unsigned char*>(shape.wkb), NULL, &shape.geom, shape.size);
+					if (ogr_err) {
+						CSLDestroy(options);
+						return std::string("Invalid WKB at geometry ") + CPLSPrintf("%u", i);
+					}
+				}
+				geoms.push_back(shape.geom);
+			}
+			err = GDALRasterizeGeometries(ds, bands.size(), &bands[0], geoms.size(), geoms.empty() ? NULL : &geoms[0],
+			                              NULL, NULL, values, options, progress, progress_arg);
+		}
+		CSLDestroy(options);
+
+		if (err != CE_None) return lastError("Error rasterizing");
+		return "";
+	}
+
+private:
+	//a geometry to burn: either already built, or WKB to decode when the job runs
+	struct Shape {
+		OGRGeometry *geom;
+		const unsigned char *wkb;
+		size_t size;
+	};
+
+	std::string parseLayers(Handle<Value> val)
+	{
+		Handle<Array> list;
+		if (val->IsArray()) {
+			list = Handle<Array>::Cast(val);
+		} else {
+			list = Array::New(1);
+			list->Set(0, val);
+		}
+		for (unsigned int i = 0; i < list->Length(); i++) {
+			Handle<Value> item = list->Get(i);
+			if (!Layer::constructor->HasInstance(item)) return "layers must only contain Layer objects";
+			Layer *layer = ObjectWrap::Unwrap<Layer>(item->ToObject());
+			if (!layer->get()) return "Layer object has already been destroyed";
+			pin(item, Layer::parentDataset(item->ToObject()));
+			layers.push_back(layer);
+		}
+		if (layers.empty()) return "layers must not be empty";
+		return "";
+	}
+
+	//geometries: an array of Geometry objects / WKB Buffers, or {wkb, offsets} as returned by features.readBatch()
+	std::string parseGeometries(Handle<Value> val)
+	{
+		if (!val->IsObject()) return "geometries must be an array or an object with wkb and offsets";
+
+		if (!val->IsArray()) {
+			Handle<Object> obj = val->ToObject();
+			Handle<Value> wkb_obj = obj->Get(String::NewSymbol("wkb"));
+			Handle<Value> offsets_obj = obj->Get(String::NewSymbol("offsets"));
+			if (!Buffer::HasInstance(wkb_obj)) return "geometries.wkb must be a Buffer";
+			if (!offsets_obj->IsObject() || TypedArray::Identify(offsets_obj->ToObject()) != GDT_UInt32) {
+				return "geometries.offsets must be a Uint32Array";
+			}
+			//pinned themselves, the object may be changed while the job runs
+			pin(wkb_obj, NULL);
+			pin(offsets_obj, NULL);
+			const unsigned char *wkb = (const unsigned char *) Buffer::Data(wkb_obj->ToObject());
+			size_t wkb_length = Buffer::Length(wkb_obj->ToObject());
+			unsigned int *offsets = static_cast<unsigned int*>(TypedArray::Data(offsets_obj->ToObject()));
+			int n = TypedArray::Length(offsets_obj->ToObject()) - 1;
+			for (int i = 0; i < n; i++) {
+				if (offsets[i] > offsets[i + 1] || offsets[i + 1] > wkb_length) return "geometries.offsets are out of range";
+				Shape shape = {NULL, NULL, 0};
+				if (offsets[i + 1] > offsets[i]) {
+					shape.wkb  = wkb + offsets[i];
+					shape.size = offsets[i + 1] - offsets[i];
+				}
+				shapes.push_back(shape);
+			}
+			return "";
+		}
+
+		Handle<Array> list = Handle<Array>::Cast(val);
+		for (unsigned int i = 0; i < list->Length(); i++) {
+			Handle<Value> item = list->Get(i);
+			Shape shape = {NULL, NULL, 0};
+			if (Geometry::constructor->HasInstance(item)) {
+				Geometry *geom = ObjectWrap::Unwrap<Geometry>(item->ToObject());
+				if (!geom->get()) return "Geometry object has already been destroyed";
+				//copied so the JS side can't change it while the job runs
+				shape.geom = geom->get()->clone();
+			} else if (Buffer::HasInstance(item)) {
+				//pinned itself, the array may be changed while the job runs
+				pin(item, NULL);
+				shape.wkb  = (const unsigned char *) Buffer::Data(item->ToObject());
+				shape.size = Buffer::Length(item->ToObject());
+			} else if (!item->IsNull() && !item->IsUndefined()) {
+				return "geometries must only contain Geometry objects or WKB Buffers";
+			}
+			shapes.push_back(shape);
+		}
+		return "";
+	}
+
+	Dataset *dst;
+	std::vector<int> bands;
+	std::vector<Layer*> layers;
+	std::vector<Shape> shapes;
+	std::vector<double> burn_values;
+	bool all_touched;
+	std::string merge_alg;
+	std::string attribute;
+};
+
+Handle<Value> Algorithms::rasterize(const Arguments &args)
+{
+	return runSync<RasterizeJob>(args);
+}
+
+Handle<Value> Algorithms::rasterizeAsync(const Arguments &args)
+{
+	return runAsync<RasterizeJob>(args);
+}
+
+// ----- contours -----
+
+class ContourJob : public AlgorithmJob {
+public:
+	ContourJob()
+		: src(NULL), dst(NULL), interval(0), base(0), has_nodata(false), nodata(0), id_field(-1), elev_field(-1)
+	{}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getBand(options, "src", true, src)).empty()) return err;
+		if (!(err = getLayer(options, "dst", true, dst)).empty()) return err;
+		if (!(err = getField(options, "idField", dst->get(), id_field)).empty()) return err;
+		if (!(err = getField(options, "elevField", dst->get(), elev_field)).empty()) return err;
+
+		Handle<Value> val = options->Get(String::NewSymbol("fixedLevels"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!(err = getNumbers(val, "fixedLevels", fixed_levels)).empty()) return err;
+		}
+
+		val = options->Get(String::NewSymbol("interval"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsNumber() || val->NumberValue() <= 0) return "interval must be a positive number";
+			interval = val->NumberValue();
+		} else if (fixed_levels.empty()) {
+			return "Either interval or fixedLevels must be given";
+		}
+
+		val = options->Get(String::NewSymbol("base"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsNumber()) return "base must be a number";
+			base = val->NumberValue();
+		}
+
+		//like gdal_contour, the band's nodata value is used unless one is given
+		val = options->Get(String::NewSymbol("noData"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsNumber()) return "noData must be a number";
+			has_nodata = true;
+			nodata = val->NumberValue();
+		} else {
+			int success = 0;
+			nodata = src->get()->GetNoDataValue(&success);
+			has_nodata = success != 0;
+		}
+
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *src_band = src->get();
+		OGRLayer *dst_layer = dst->get();
+
+		//the objects may have been destroyed while the job was queued
+		if (!src_band) return "RasterBand object has already been destroyed";
+		if (!dst_layer) return "Layer object has already been destroyed";
+
+		//contours are only written for fixed levels if no interval is given
+		CPLErr err = GDALContourGenerate(src_band, interval, base,
+		                                 fixed_levels.size(), fixed_levels.empty() ? NULL : &fixed_levels[0],
+		                                 has_nodata, nodata, dst_layer, id_field, elev_field,
+		                                 progress, progress_arg);
+
+		if (err != CE_None) return lastError("Error generating contours");
+		return "";
+	}
+
+private:
+	RasterBand *src;
+	Layer *dst;
+	double interval;
+	double base;
+	std::vector<double> fixed_levels;
+	bool has_nodata;
+	double nodata;
+	int id_field;
+	int elev_field;
+};
+
+Handle<Value> Algorithms::contourGenerate(const Arguments &args)
+{
+	return runSync<ContourJob>(args);
+}
+
+Handle<Value> Algorithms::contourGenerateAsync(const Arguments &args)
+{
+	return runAsync<ContourJob>(args);
+}
+
+// ----- raster filters -----
+
+class ProximityJob : public AlgorithmJob {
+public:
+	ProximityJob()
+		: src(NULL), dst(NULL), options(NULL)
+	{}
+
+	~ProximityJob()
+	{
+		CSLDestroy(options);
+	}
+
+	std::string parse(Handle<Object> opts)
+	{
+		std::string err;
+		if (!(err = getBand(opts, "src", true, src)).empty()) return err;
+		if (!(err = getBand(opts, "dst", true, dst)).empty()) return err;
+
+		Handle<Value> val = opts->Get(String::NewSymbol("values"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			std::vector<double> values;
+			if (!(err = getNumbers(val, "values", values)).empty()) return err;
+			std::string list;
+			for (unsigned int i = 0; i < values.size(); i++) {
+				if (i) list += ",";
+				list += CPLSPrintf("%d", (int) values[i]);
+			}
+			options = CSLSetNameValue(options, "VALUES", list.c_str());
+		}
+
+		val = opts->Get(String::NewSymbol("distUnits"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			std::string units = val->IsString() ? TOSTR(val) : "";
+			if (units != "geo" && units != "pixel") return "distUnits must be 'geo' or 'pixel'";
+			options = CSLSetNameValue(options, "DISTUNITS", units == "geo" ? "GEO" : "PIXEL");
+		}
+
+		double num;
+		bool found;
+		if (!(err = getNumber(opts, "maxDist", num, &found)).empty()) return err;
+		if (found) options = CSLSetNameValue(options, "MAXDIST", CPLSPrintf("%.18g", num));
+		if (!(err = getNumber(opts, "noData", num, &found)).empty()) return err;
+		if (found) options = CSLSetNameValue(options, "NODATA", CPLSPrintf("%.18g", num));
+		if (!(err = getNumber(opts, "fixedBufVal", num, &found)).empty()) return err;
+		if (found) options = CSLSetNameValue(options, "FIXED_BUF_VAL", CPLSPrintf("%.18g", num));
+
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *src_band = src->get();
+		GDALRasterBand *dst_band = dst->get();
+
+		//the objects may have been destroyed while the job was queued
+		if (!src_band || !dst_band) return "RasterBand object has already been destroyed";
+
+		CPLErr err = GDALComputeProximity(src_band, dst_band, options, progress, progress_arg);
+		if (err != CE_None) return lastError("Error computing proximity");
+		return "";
+	}
+
+private:
+	RasterBand *src;
+	RasterBand *dst;
+	char **options;
+};
+
+class SieveJob : public AlgorithmJob {
+public:
+	SieveJob()
+		: src(NULL), dst(NULL), mask(NULL), threshold(0), connectedness(4)
+	{}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getBand(options, "src", true, src)).empty()) return err;
+		if (!(err = getBand(options, "dst", true, dst)).empty()) return err;
+		if (!(err = getBand(options, "mask", false, mask)).empty()) return err;
+
+		Handle<Value> val = options->Get(String::NewSymbol("threshold"));
+		if (!val->IsInt32() || val->Int32Value() < 1) return "threshold must be a positive integer";
+		threshold = val->Int32Value();
+
+		val = options->Get(String::NewSymbol("connectedness"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsInt32() || (val->Int32Value() != 4 && val->Int32Value() != 8)) {
+				return "connectedness must be 4 or 8";
+			}
+			connectedness = val->Int32Value();
+		}
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *src_band  = src->get();
+		GDALRasterBand *dst_band  = dst->get();
+		GDALRasterBand *mask_band = mask ? mask->get() : NULL;
+
+		//the objects may have been destroyed while the job was queued
+		if (!src_band || !dst_band || (mask && !mask_band)) return "RasterBand object has already been destroyed";
+
+		CPLErr err = GDALSieveFilter(src_band, mask_band, dst_band, threshold, connectedness, NULL, progress, progress_arg);
+		if (err != CE_None) return lastError("Error running sieve filter");
+		return "";
+	}
+
+private:
+	RasterBand *src;
+	RasterBand *dst;
+	RasterBand *mask;
+	int threshold;
+	int connectedness;
+};
+
+class FillNodataJob : public AlgorithmJob {
+public:
+	FillNodataJob()
+		: src(NULL), mask(NULL), search_dist(100), smoothing_iterations(0)
+	{}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getBand(options, "src", true, src)).empty()) return err;
+		if (!(err = getBand(options, "mask", false, mask)).empty()) return err;
+		if (!(err = getNumber(options, "searchDist", search_dist)).empty()) return err;
+		if (search_dist <= 0) return "searchDist must be a positive number";
+
+		Handle<Value> val = options->Get(String::NewSymbol("smoothingIterations"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsInt32() || val->Int32Value() < 0) return "smoothingIterations must be a positive integer";
+			smoothing_iterations = val->Int32Value();
+		}
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *src_band  = src->get();
+		GDALRasterBand *mask_band = mask ? mask->get() : NULL;
+
+		//the objects may have been destroyed while the job was queued
+		if (!src_band || (mask && !mask_band)) return "RasterBand object has already been destroyed";
+
+		CPLErr err = GDALFillNodata(src_band, mask_band, search_dist, FALSE, smoothing_iterations, NULL, progress, progress_arg);
+		if (err != CE_None) return lastError("Error filling nodata");
+		return "";
+	}
+
+private:
+	RasterBand *src;
+	RasterBand *mask;
+	double search_dist;
+	int smoothing_iterations;
+};
+
+Handle<Value> Algorithms::computeProximity(const Arguments &args)
+{
+	return runSync<ProximityJob>(args);
+}
+
+Handle<Value> Algorithms::computeProximityAsync(const Arguments &args)
+{
+	return runAsync<ProximityJob>(args);
+}
+
+Handle<Value> Algorithms::sieveFilter(const Arguments &args)
+{
+	return runSync<SieveJob>(args);
+}
+
+Handle<Value> Algorithms::sieveFilterAsync(const Arguments &args)
+{
+	return runAsync<SieveJob>(args);
+}
+
+Handle<Value> Algorithms::fillNodata(const Arguments &args)
+{
+	return runSync<FillNodataJob>(args);
+}
+
+Handle<Value> Algorithms::fillNodataAsync(const Arguments &args)
+{
+	return runAsync<FillNodataJob>(args);
+}
+
+// ----- grid -----
+
+class GridJob : public AlgorithmJob {
+public:
+	GridJob()
+		: dst(NULL), type(GDT_Float64), size_x(0), size_y(0), threads(0)
+	{
+		bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0;
+	}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getPoints(options)).empty()) return err;
+		if (!(err = getAlgorithm(options)).empty()) return err;
+		if (!(err = getBand(options, "dst", false, dst)).empty()) return err;
+
+		//the output size and bounds default to the ones of the band being written
+		if (dst) {
+			GDALRasterBand *band = dst->get();
+			type   = band->GetRasterDataType();
+			size_x = band->GetXSize();
+			size_y = band->GetYSize();
+		}
+
+		Handle<Value> val = options->Get(String::NewSymbol("outSize"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsObject()) return "outSize must be an object";
+			Handle<Object> obj = val->ToObject();
+			Handle<Value> x = obj->Get(String::NewSymbol("x"));
+			Handle<Value> y = obj->Get(String::NewSymbol("y"));
+			if (!x->IsInt32() || !y->IsInt32() || x->Int32Value() < 1 || y->Int32Value() < 1) {
+				return "outSize.x and outSize.y must be positive integers";
+			}
+			size_x = x->Int32Value();
+			size_y = y->Int32Value();
+		} else if (!dst) {
+			return "outSize must be given";
+		}
+		if (dst && (size_x != dst->get()->GetXSize() || size_y != dst->get()->GetYSize())) {
+			return "outSize must match the size of the dst band";
+		}
+		if ((double) size_x * size_y > 0x7fffffff) {
+			return "outSize is too large";
+		}
+
+		val = options->Get(String::NewSymbol("outBounds"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsObject()) return "outBounds must be an object";
+			Handle<Object> obj = val->ToObject();
+			const char *keys[] = {"minX", "minY", "maxX", "maxY"};
+			for (int i = 0; i < 4; i++) {
+				Handle<Value> num = obj->Get(String::NewSymbol(keys[i]));
+				if (!num->IsNumber()) return std::string("outBounds.") + keys[i] + " must be a number";
+				bounds[i] = num->NumberValue();
+			}
+			if (bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) return "outBounds must not be empty";
+		} else if (dst) {
+			if (!(err = getBandBounds()).empty()) return err;
+		} else {
+			return "outBounds must be given";
+		}
+
+		val = options->Get(String::NewSymbol("type"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (dst) return "type can not be given with a dst band";
+			if (!val->IsString()) return "type must be a string";
+			type = GDALGetDataTypeByName(TOSTR(val));
+			if (type == GDT_Unknown || GDALDataTypeIsComplex(type)) return "type must be a valid, non-complex data type";
+		}
+
+		val = options->Get(String::NewSymbol("threads"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsInt32() || val->Int32Value() < 1) return "threads must be a positive integer";
+			threads = val->Int32Value();
+		}
+
+		data.resize((size_t) size_x * size_y * (GDALGetDataTypeSize(type) / 8));
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *dst_band = dst ? dst->get() : NULL;
+
+		//the objects may have been destroyed while the job was queued
+		if (dst && !dst_band) return "RasterBand object has already been destroyed";
+
+		GDALGridAlgorithm alg;
+		void *alg_options = NULL;
+		if (ParseAlgorithmAndOptions(algorithm.c_str(), &alg, &alg_options) != CE_None) {
+			CPLFree(alg_options);
+			return "Invalid algorithm options";
+		}
+
+		//GDALGridCreate splits the rows across GDAL_NUM_THREADS threads (all CPUs by default)
+		if (threads) CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", CPLSPrintf("%d", threads));
+
+		//rows are produced from the first y bound to the second, so start at maxY for a north-up grid
+		CPLErr err = GDALGridCreate(alg, alg_options, xs.size(), &xs[0], &ys[0], &zs[0],
+		                            bounds[0], bounds[2], bounds[3], bounds[1],
+		                            size_x, size_y, type, &data[0], progress, progress_arg);
+
+		if (threads) CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", NULL);
+		CPLFree(alg_options);
+
+		if (err != CE_None) return lastError("Error creating grid");
+
+		if (dst_band) {
+			err = dst_band->RasterIO(GF_Write, 0, 0, size_x, size_y, &data[0], size_x, size_y, type, 0, 0);
+			if (err != CE_None) return lastError("Error writing grid to band");
+		}
+		return "";
+	}
+
+	Handle<Value> result()
+	{
+		HandleScope scope;
+
+		if (dst) return Undefined();
+
+		Handle<Value> array = TypedArray::New(type, size_x * size_y);
+		if (array.IsEmpty() || !array->IsObject()) return scope.Close(array);
+		memcpy(TypedArray::Data(array->ToObject()), &data[0], data.size());
+		return scope.Close(array);
+	}
+
+private:
+	//copies the point coordinates so they can't be modified while the job runs
+	std::string getPoints(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getCoordinates(options, "xs", xs)).empty()) return err;
+		if (!(err = getCoordinates(options, "ys", ys)).empty()) return err;
+		if (!(err = getCoordinates(options, "zs", zs)).empty()) return err;
+		if (xs.empty()) return "xs must contain at least one point";
+		if (ys.size() != xs.size() || zs.size() != xs.size()) return "xs, ys and zs must have the same length";
+		return "";
+	}
+
+	static std::string getCoordinates(Handle<Object> options, const char *key, std::vector<double> &values)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol(key));
+		if (val->IsObject() && TypedArray::Identify(val->ToObject()) == GDT_Float64) {
+			Handle<Object> array = val->ToObject();
+			double *src = static_cast<double*>(TypedArray::Data(array));
+			values.assign(src, src + TypedArray::Length(array));
+			return "";
+		}
+		if (val->IsArray()) return getNumbers(val, key, values);
+		return std::string(key) + " must be a Float64Array or an array of numbers";
+	}
+
+	//builds the "name:key=value:..." string understood by ParseAlgorithmAndOptions()
+	std::string getAlgorithm(Handle<Object> options)
+	{
+		Handle<Value> val = options->Get(String::NewSymbol("algorithm"));
+		algorithm = "invdist";
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsString()) return "algorithm must be a string";
+			algorithm = TOSTR(val);
+		}
+		if (algorithm == "linear") {
+			return "The 'linear' algorithm is not supported by this version of GDAL";
+		}
+		const char *names[] = {
+			"invdist", "average", "nearest", "minimum", "maximum", "range",
+			"count", "average_distance", "average_distance_pts"
+		};
+		bool known = false;
+		for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+			if (algorithm == names[i]) known = true;
+		}
+		if (!known) return "Unknown algorithm \"" + algorithm + "\"";
+
+		val = options->Get(String::NewSymbol("options"));
+		if (val->IsUndefined() || val->IsNull()) return "";
+		if (!val->IsObject()) return "options must be an object";
+
+		Handle<Object> obj = val->ToObject();
+		Handle<Array> keys = obj->GetOwnPropertyNames();
+		for (unsigned int i = 0; i < keys->Length(); i++) {
+			Handle<Value> key = keys->Get(i);
+			Handle<Value> item = obj->Get(key);
+			if (!item->IsNumber()) return "options." + std::string(TOSTR(key)) + " must be a number";
+			algorithm += CPLSPrintf(":%s=%.18g", optionName(TOSTR(key)).c_str(), item->NumberValue());
+		}
+		return "";
+	}
+
+	//maxPoints -> max_points
+	static std::string optionName(const std::string &key)
+	{
+		std::string name;
+		for (unsigned int i = 0; i < key.size(); i++) {
+			if (key[i] >= 'A' && key[i] <= 'Z') {
+				name += '_';
+				name += key[i] - 'A' + 'a';
+			} else {
+				name += key[i];
+			}
+		}
+		return name;
+	}
+
+	std::string getBandBounds()
+	{
+		GDALDataset *ds = dst->get()->GetDataset();
+		double gt[6];
+		if (!ds || ds->GetGeoTransform(gt) != CE_None) {
+			return "outBounds must be given if the dst dataset has no geotransform";
+		}
+		if (gt[2] != 0 || gt[4] != 0 || gt[5] >= 0) {
+			return "outBounds must be given if the dst dataset is not north-up";
+		}
+		bounds[0] = gt[0];
+		bounds[1] = gt[3] + gt[5] * size_y;
+		bounds[2] = gt[0] + gt[1] * size_x;
+		bounds[3] = gt[3];
+		return "";
+	}
+
+	std::vector<double> xs;
+	std::vector<double> ys;
+	std::vector<double> zs;
+	std::string algorithm;
+	RasterBand *dst;
+	GDALDataType type;
+	int size_x;
+	int size_y;
+	double bounds[4]; //minX, minY, maxX, maxY
+	int threads;
+	std::vector<unsigned char> data;
+};
+
+Handle<Value> Algorithms::grid(const Arguments &args)
+{
+	return runSync<GridJob>(args);
+}
+
+Handle<Value> Algorithms::gridAsync(const Arguments &args)
+{
+	return runAsync<GridJob>(args);
+}
+
+// ----- zonal statistics -----
+
+#ifdef HAVE_GDAL_ALG_PRIV
+
+//a feature's geometry in pixel coordinates and the statistics of the pixels it covers
+struct Zone {
+	Zone()
+		: fid(OGRNullFID), x0(0), y0(0), w(0), h(0),
+		  min(std::numeric_limits<double>::quiet_NaN()), max(std::numeric_limits<double>::quiet_NaN()),
+		  sum(0), sum_c(0), count(0)
+	{}
+
+	long fid;
+	std::vector<double> xs;
+	std::vector<double> ys;
+	std::vector<int> parts;
+	std::vector<int> kinds; //of each part, 0: polygon rings, 1: lines, 2: points
+	int x0, y0, w, h; //pixel window covering the envelope, clipped to the band
+	double min;
+	double max;
+	double sum;
+	double sum_c;
+	GUIntBig count;
+	std::string field_value;
+	double field_number;
+};
+
+class ZonalStatsJob;
+
+//the zones one thread reduces, zones[order[first]] .. zones[order[last - 1]]
+struct ZonalStatsPart {
+	ZonalStatsJob *job;
+	GDALRasterBand *band;
+	GDALDataset *ds; //separate handle owned by the part, NULL for the caller's band
+	int first;
+	int last;
+	std::string error;
+};
+
+class ZonalStatsJob : public AlgorithmJob {
+public:
+	ZonalStatsJob()
+		: src(NULL), layer(NULL), all_touched(false), field(-1), field_is_number(false), threads(0),
+		  has_nodata(0), nodata(0), zones_done(0), stop(false)
+	{
+		for (int i = 0; i < N_STATS; i++) stats[i] = true;
+	}
+
+	std::string parse(Handle<Object> options)
+	{
+		std::string err;
+		if (!(err = getBand(options, "src", true, src)).empty()) return err;
+		if (!(err = getLayer(options, "layer", true, layer)).empty()) return err;
+		if (!(err = getField(options, "field", layer->get(), field)).empty()) return err;
+		if (field >= 0) {
+			OGRFieldDefn *defn = layer->get()->GetLayerDefn()->GetFieldDefn(field);
+			field_name = defn->GetNameRef();
+			field_is_number = defn->GetType() == OFTInteger || defn->GetType() == OFTReal;
+		}
+
+		Handle<Value> val = options->Get(String::NewSymbol("stats"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsArray()) return "stats must be an array";
+			Handle<Array> list = Handle<Array>::Cast(val);
+			for (int i = 0; i < N_STATS; i++) stats[i] = false;
+			for (unsigned int i = 0; i < list->Length(); i++) {
+				std::string name = TOSTR(list->Get(i));
+				int j = 0;
+				while (j < N_STATS && name != stat_names[j]) j++;
+				if (j == N_STATS) return "Unknown statistic \"" + name + "\"";
+				stats[j] = true;
+			}
+		}
+
+		all_touched = options->Get(String::NewSymbol("allTouched"))->BooleanValue();
+
+		val = options->Get(String::NewSymbol("threads"));
+		if (!val->IsUndefined() && !val->IsNull()) {
+			if (!val->IsInt32() || val->Int32Value() < 1) return "threads must be a positive integer";
+			threads = val->Int32Value();
+		}
+		return "";
+	}
+
+	std::string run()
+	{
+		GDALRasterBand *band = src->get();
+		OGRLayer *ogr_layer = layer->get();
+
+		//the objects may have been destroyed while the job was queued
+		if (!band) return "RasterBand object has already been destroyed";
+		if (!ogr_layer) return "Layer object has already been destroyed";
+
+		std::string err = readZones(band, ogr_layer);
+		if (!err.empty()) return err;
+
+		//visit the zones in block order so neighbouring features reuse cached blocks
+		band->GetBlockSize(&block_x, &block_y);
+		order.resize(zones.size());
+		for (unsigned int i = 0; i < order.size(); i++) order[i] = i;
+		std::sort(order.begin(), order.end(), BlockOrder(this));
+
+		std::vector<ZonalStatsPart> parts;
+		openParts(band, parts);
+
+		has_nodata = 0;
+		nodata = band->GetNoDataValue(&has_nodata);
+		has_nodata = has_nodata && !CPLIsNan(nodata);
+		zones_done = 0;
+		stop = false;
+		uv_mutex_init(&lock);
+
+		std::vector<uv_thread_t> tids(parts.size());
+		for (unsigned int i = 1; i < parts.size(); i++) {
+			uv_thread_create(&tids[i], ZonalStatsJob::reducePart, &parts[i]);
+		}
+		reducePart(&parts[0]);
+		for (unsigned int i = 1; i < parts.size(); i++) {
+			uv_thread_join(&tids[i]);
+		}
+		uv_mutex_destroy(&lock);
+
+		for (unsigned int i = 0; i < parts.size(); i++) {
+			if (err.empty()) err = parts[i].error;
+			if (parts[i].ds) GDALClose(parts[i].ds);
+		}
+		return err;
+	}
+
+	Handle<Value> result()
+	{
+		HandleScope scope;
+
+		int n = zones.size();
+		Local<Object> result = Object::New();
+
+		Handle<Value> fids = TypedArray::New(GDT_Float64, n);
+		if (fids.IsEmpty() || !fids->IsObject()) return scope.Close(fids);
+		double *fid_data = static_cast<double*>(TypedArray::Data(fids->ToObject()));
+		for (int i = 0; i < n; i++) fid_data[i] = (double) zones[i].fid;
+		result->Set(String::NewSymbol("fid"), fids);
+
+		for (int j = 0; j < N_STATS; j++) {
+			if (!stats[j]) continue;
+			Handle<Value> column = TypedArray::New(GDT_Float64, n);
+			if (column.IsEmpty() || !column->IsObject()) return scope.Close(column);
+			double *data = static_cast<double*>(TypedArray::Data(column->ToObject()));
+			for (int i = 0; i < n; i++) data[i] = statistic(zones[i], j);
+			result->Set(String::NewSymbol(stat_names[j]), column);
+		}
+
+		if (field >= 0) {
+			Local<Array> values = Array::New(n);
+			for (int i = 0; i < n; i++) {
+				if (field_is_number) values->Set(i, Number::New(zones[i].field_number));
+				else values->Set(i, SafeString::New(zones[i].field_value.c_str()));
+			}
+			result->Set(String::New(field_name.c_str()), values);
+		}
+
+		return scope.Close(result);
+	}
+
+private:
+	enum { STAT_MEAN, STAT_MIN, STAT_MAX, STAT_SUM, STAT_COUNT, N_STATS };
+	static const char *stat_names[N_STATS];
+
+	static double statistic(const Zone &zone, int stat)
+	{
+		switch (stat) {
+			case STAT_MEAN:  return zone.count ? (zone.sum + zone.sum_c) / zone.count : std::numeric_limits<double>::quiet_NaN();
+			case STAT_MIN:   return zone.min;
+			case STAT_MAX:   return zone.max;
+			case STAT_SUM:   return zone.sum + zone.sum_c;
+			default:         return (double) zone.count;
+		}
+	}
+
+	struct BlockOrder {
+		BlockOrder(ZonalStatsJob *job) : job(job) {}
+		bool operator()(int a, int b) const
+		{
+			const Zone &za = job->zones[a];
+			const Zone &zb = job->zones[b];
+			int ya = za.y0 / job->block_y, yb = zb.y0 / job->block_y;
+			if (ya != yb) return ya < yb;
+			return za.x0 / job->block_x < zb.x0 / job->block_x;
+		}
+		ZonalStatsJob *job;
+	};
+
+	//reads every feature of the layer and converts its geometry to pixel coordinates
+	std::string readZones(GDALRasterBand *band, OGRLayer *ogr_layer)
+	{
+		//overview bands have the extent of the full resolution dataset
+		GDALDataset *ds = src->getParent() ? src->getParent() : band->GetDataset();
+		double gt[6], inv_gt[6];
+		if (!ds || ds->GetGeoTransform(gt) != CE_None) return "src band's dataset has no geotransform";
+		double scale_x = ds->GetRasterXSize() / (double) band->GetXSize();
+		double scale_y = ds->GetRasterYSize() / (double) band->GetYSize();
+		gt[1] *= scale_x; gt[4] *= scale_x;
+		gt[2] *= scale_y; gt[5] *= scale_y;
+		if (!GDALInvGeoTransform(gt, inv_gt)) return "src band's geotransform is not invertible";
+
+		int size_x = band->GetXSize();
+		int size_y = band->GetYSize();
+
+		zones.clear();
+		ogr_layer->ResetReading();
+		OGRFeature *feature;
+		while ((feature = ogr_layer->GetNextFeature()) != NULL) {
+			zones.push_back(Zone());
+			Zone &zone = zones.back();
+			zone.fid = feature->GetFID();
+			if (field >= 0) {
+				zone.field_number = feature->GetFieldAsDouble(field);
+				zone.field_value = feature->GetFieldAsString(field);
+			}
+
+			OGRGeometry *geom = feature->GetGeometryRef();
+			if (geom && !geom->IsEmpty()) {
+				collectParts(geom, zone);
+			}
+			OGRFeature::DestroyFeature(feature);
+
+			if (zone.xs.empty()) continue;
+			double min_x = std::numeric_limits<double>::infinity(), max_x = -min_x;
+			double min_y = min_x, max_y = -min_x;
+			for (unsigned int i = 0; i < zone.xs.size(); i++) {
+				double x = inv_gt[0] + zone.xs[i] * inv_gt[1] + zone.ys[i] * inv_gt[2];
+				double y = inv_gt[3] + zone.xs[i] * inv_gt[4] + zone.ys[i] * inv_gt[5];
+				zone.xs[i] = x;
+				zone.ys[i] = y;
+				min_x = std::min(min_x, x); max_x = std::max(max_x, x);
+				min_y = std::min(min_y, y); max_y = std::max(max_y, y);
+			}
+			//clamp before converting, coordinates far outside the band would overflow an int
+			if (!(max_x >= 0 && max_y >= 0 && min_x < size_x && min_y < size_y)) {
+				zone.w = zone.h = 0;
+				continue;
+			}
+			zone.x0 = (int) floor(std::max(0.0, min_x));
+			zone.y0 = (int) floor(std::max(0.0, min_y));
+			zone.w  = (int) std::min((double) size_x, ceil(max_x) + 1) - zone.x0;
+			zone.h  = (int) std::min((double) size_y, ceil(max_y) + 1) - zone.y0;
+			if (zone.w <= 0 || zone.h <= 0) {
+				zone.w = zone.h = 0;
+				continue;
+			}
+
+			//the rasterizer works in window coordinates
+			for (unsigned int i = 0; i < zone.xs.size(); i++) {
+				zone.xs[i] -= zone.x0;
+				zone.ys[i] -= zone.y0;
+			}
+		}
+
+		std::string msg = CPLGetLastErrorMsg();
+		if (CPLGetLastErrorType() == CE_Failure) return msg;
+		return "";
+	}
+
+	//same parts GDALRasterizeGeometries() burns: points, linestrings or rings
+	static void collectParts(OGRGeometry *geom, Zone &zone)
+	{
+		OGRwkbGeometryType type = wkbFlatten(geom->getGeometryType());
+		if (type == wkbPoint) {
+			OGRPoint *point = (OGRPoint*) geom;
+			zone.xs.push_back(point->getX());
+			zone.ys.push_back(point->getY());
+			zone.parts.push_back(1);
+			zone.kinds.push_back(2);
+		} else if (type == wkbLineString || type == wkbLinearRing) {
+			OGRLineString *line = (OGRLineString*) geom;
+			int n = line->getNumPoints();
+			if (n < 1) return;
+			for (int i = 0; i < n; i++) {
+				zone.xs.push_back(line->getX(i));
+				zone.ys.push_back(line->getY(i));
+			}
+			zone.parts.push_back(n);
+			//rings only come from polygons
+			zone.kinds.push_back(type == wkbLinearRing ? 0 : 1);
+		} else if (type == wkbPolygon) {
+			OGRPolygon *polygon = (OGRPolygon*) geom;
+			if (polygon->getExteriorRing()) collectParts(polygon->getExteriorRing(), zone);
+			for (int i = 0; i < polygon->getNumInteriorRings(); i++) {
+				collectParts(polygon->getInteriorRing(i), zone);
+			}
+		} else if (type == wkbMultiPoint || type == wkbMultiLineString || type == wkbMultiPolygon || type == wkbGeometryCollection) {
+			OGRGeometryCollection *collection = (OGRGeometryCollection*) geom;
+			for (int i = 0; i < collection->getNumGeometries(); i++) {
+				collectParts(collection->getGeometryRef(i), zone);
+			}
+		}
+	}
+
+	//opens a read-only handle to the band's file for each extra thread. bands that
+	//can't be reopened (MEM datasets, overviews, ...) are processed on this thread only
+	void openParts(GDALRasterBand *band, std::vector<ZonalStatsPart> &parts)
+	{
+		int n_zones = zones.size();
+		int n = threads > 0 ? threads : CPLGetNumCPUs();
+		if (n > n_zones) n = n_zones;
+		if (n < 1) n = 1;
+
+		std::vector<GDALRasterBand*> bands(1, band);
+		std::vector<GDALDataset*> handles(1, (GDALDataset*) NULL);
+
+		GDALDataset *parent = src->getParent();
+		GDALDriver *driver = parent ? parent->GetDriver() : NULL;
+		if (n > 1 && parent && band->GetDataset() == parent && band->GetBand() > 0 &&
+		    driver && !EQUAL(driver->GetDescription(), "MEM")) {
+			//make pending writes visible to the other handles
+			parent->FlushCache();
+
+			CPLPushErrorHandler(CPLQuietErrorHandler);
+			for (int i = 1; i < n; i++) {
+				GDALDataset *copy = (GDALDataset*) GDALOpen(parent->GetDescription(), GA_ReadOnly);
+				if (!copy) break;
+				if (copy->GetRasterCount() < band->GetBand() ||
+				    copy->GetRasterXSize() != parent->GetRasterXSize() ||
+				    copy->GetRasterYSize() != parent->GetRasterYSize()) {
+					GDALClose(copy);
+					break;
+				}
+				bands.push_back(copy->GetRasterBand(band->GetBand()));
+				handles.push_back(copy);
+			}
+			CPLPopErrorHandler();
+		}
+
+		//contiguous runs of the block-ordered zones, so each thread keeps its locality
+		n = bands.size();
+		for (int i = 0; i < n; i++) {
+			ZonalStatsPart part;
+			part.job   = this;
+			part.band  = bands[i];
+			part.ds    = handles[i];
+			part.first = (int) ((GIntBig) n_zones * i / n);
+			part.last  = (int) ((GIntBig) n_zones * (i + 1) / n);
+			parts.push_back(part);
+		}
+	}
+
+	struct Window {
+		std::vector<unsigned char> mask;
+		int w;
+		int h;
+	};
+
+	static void burnScanline(void *arg, int y, int x_start, int x_end, double)
+	{
+		Window *window = static_cast<Window*>(arg);
+		if (y < 0 || y >= window->h) return;
+		if (x_start < 0) x_start = 0;
+		if (x_end >= window->w) x_end = window->w - 1;
+		if (x_start > x_end) return;
+		memset(&window->mask[(size_t) y * window->w + x_start], 1, x_end - x_start + 1);
+	}
+
+	static void burnPoint(void *arg, int y, int x, double)
+	{
+		Window *window = static_cast<Window*>(arg);
+		if (y < 0 || y >= window->h || x < 0 || x >= window->w) return;
+		window->mask[(size_t) y * window->w + x] = 1;
+	}
+
+	static void reducePart(void *arg)
+	{
+		ZonalStatsPart *part = static_cast<ZonalStatsPart*>(arg);
+		ZonalStatsJob *job = part->job;
+		bool reports_progress = part->first == 0 && job->progress;
+		int total = job->zones.size();
+
+		CPLErrorReset();
+
+		std::vector<double> data;
+		Window window;
+
+		for (int i = part->first; i < part->last; i++) {
+			uv_mutex_lock(&job->lock);
+			bool stop = job->stop;
+			uv_mutex_unlock(&job->lock);
+			if (stop) break;
+
+			Zone &zone = job->zones[job->order[i]];
+			if (zone.w > 0 && zone.h > 0) {
+				size_t n = (size_t) zone.w * zone.h;
+				data.resize(n);
+				window.mask.assign(n, 0);
+				window.w = zone.w;
+				window.h = zone.h;
+
+				if (part->band->RasterIO(GF_Read, zone.x0, zone.y0, zone.w, zone.h, &data[0], zone.w, zone.h, GDT_Float64, 0, 0) != CE_None) {
+					part->error = lastError("Error reading pixels");
+					job->cancel();
+					return;
+				}
+
+				job->rasterize(zone, window);
+				job->reduce(zone, data, window.mask);
+			}
+
+			uv_mutex_lock(&job->lock);
+			int done = ++job->zones_done;
+			uv_mutex_unlock(&job->lock);
+
+			if (reports_progress && !job->progress(done / (double) total, "Zonal Statistics", job->progress_arg)) {
+				part->error = "User terminated";
+				job->cancel();
+				return;
+			}
+		}
+	}
+
+	//marks the pixels of the window covered by the zone, with the same rules as gdal.rasterize().
+	//consecutive parts of the same kind are burnt together, so the rings of (multi)polygons fill even-odd
+	void rasterize(Zone &zone, Window &window)
+	{
+		int n_parts = zone.parts.size();
+		int offset = 0;
+		for (int first = 0; first < n_parts; ) {
+			int kind = zone.kinds[first];
+			int last = first + 1;
+			int n_points = zone.parts[first];
+			while (last < n_parts && zone.kinds[last] == kind) n_points += zone.parts[last++];
+
+			int n = last - first;
+			int *parts = &zone.parts[first];
+			double *xs = &zone.xs[offset];
+			double *ys = &zone.ys[offset];
+			if (kind == 2) {
+				GDALdllImagePoint(window.w, window.h, n, parts, xs, ys, NULL, burnPoint, &window);
+			} else if (kind == 1) {
+				if (all_touched) {
+					GDALdllImageLineAllTouched(window.w, window.h, n, parts, xs, ys, NULL, burnPoint, &window);
+				} else {
+					GDALdllImageLine(window.w, window.h, n, parts, xs, ys, NULL, burnPoint, &window);
+				}
+			} else {
+				GDALdllImageFilledPolygon(window.w, window.h, n, parts, xs, ys, NULL, burnScanline, &window);
+				if (all_touched) {
+					GDALdllImageLineAllTouched(window.w, window.h, n, parts, xs, ys, NULL, burnPoint, &window);
+				}
+			}
+
+			offset += n_points;
+			first = last;
+		}
+	}
+
+	void reduce(Zone &zone, const std::vector<double> &data, const std::vector<unsigned char> &mask)
+	{
+		double min = std::numeric_limits<double>::max();
+		double max = -std::numeric_limits<double>::max();
+		for (size_t i = 0; i < data.size(); i++) {
+			if (!mask[i]) continue;
+			double value = data[i];
+			if (CPLIsNan(value)) continue;
+			if (has_nodata && ARE_REAL_EQUAL(value, nodata)) continue;
+			if (value < min) min = value;
+			if (value > max) max = value;
+			//Neumaier summation
+			double t = zone.sum + value;
+			if (fabs(zone.sum) >= fabs(value)) zone.sum_c += (zone.sum - t) + value;
+			else zone.sum_c += (value - t) + zone.sum;
+			zone.sum = t;
+			zone.count++;
+		}
+		if (zone.count) {
+			zone.min = min;
+			zone.max = max;
+		}
+	}
+
+	void cancel()
+	{
+		uv_mutex_lock(&lock);
+		stop = true;
+		uv_mutex_unlock(&lock);
+	}
+
+	RasterBand *src;
+	Layer *layer;
+	bool stats[N_STATS];
+	bool all_touched;
+	int field;
+	std::string field_name;
+	bool field_is_number;
+	int threads;
+
+	std::vector<Zone> zones;
+	std::vector<int> order;
+	int block_x, block_y;
+
+	//shared by the threads of run()
+	int has_nodata;
+	double nodata;
+	int zones_done;
+	bool stop;
+	uv_mutex_t lock;
+};
+
+const char *ZonalStatsJob::stat_names[ZonalStatsJob::N_STATS] = {"mean", "min", "max", "sum", "count"};
+
+#endif
+
+Handle<Value> Algorithms::zonalStatistics(const Arguments &args)
+{
+#ifdef HAVE_GDAL_ALG_PRIV
+	return runSync<ZonalStatsJob>(args);
+#else
+	return NODE_THROW("zonalStatistics() is not available, it requires the bundled GDAL");
+#endif
+}
+
+Handle<Value> Algorithms::zonalStatisticsAsync(const Arguments &args)
+{
+#ifdef HAVE_GDAL_ALG_PRIV
+	return runAsync<ZonalStatsJob>(args);
+#else
+	return NODE_THROW("zonalStatisticsAsync() is not available, it requires the bundled GDAL");
+#endif
+}
+
+} // namespace node_gdal
@@ -0,0 +1,47 @@
+#ifndef __NODE_GDAL_ALGORITHMS_H__
+#define __NODE_GDAL_ALGORITHMS_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+
+// gdal
+#include <gdal_priv.h>
+#include <gdal_alg.h>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Raster / vector processing algorithms from gdal/alg (gdal.polygonize, ...)
+// Each one has a synchronous version and an "Async" version that runs on the
+// libuv thread pool.
+
+namespace Algorithms {
+
+	void Initialize(Handle<Object> target);
+
+	Handle<Value> polygonize(const Arguments &args);
+	Handle<Value> polygonizeAsync(const Arguments &args);
+	Handle<Value> rasterize(const Arguments &args);
+	Handle<Value> rasterizeAsync(const Arguments &args);
+	Handle<Value> contourGenerate(const Arguments &args);
+	Handle<Value> contourGenerateAsync(const Arguments &args);
+	Handle<Value> computeProximity(const Arguments &args);
+	Handle<Value> computeProximityAsync(const Arguments &args);
+	Handle<Value> sieveFilter(const Arguments &args);
+	Handle<Value> sieveFilterAsync(const Arguments &args);
+	Handle<Value> fillNodata(const Arguments &args);
+	Handle<Value> fillNodataAsync(const Arguments &args);
+	Handle<Value> grid(const Arguments &args);
+	Handle<Value> gridAsync(const Arguments &args);
+	Handle<Value> zonalStatistics(const Arguments &args);
+	Handle<Value> zonalStatisticsAsync(const Arguments &args);
+
+}
+
+}
+#endif
@@ -9,6 +9,8 @@
 
 namespace node_gdal {
 	extern FILE *log_file;
+	//the process-wide CPL error handler set by gdal.quiet() / gdal.verbose()
+	extern CPLErrorHandler error_handler;
 }
 
 #ifdef ENABLE_LOGGING
@@ -247,6 +249,16 @@ public:
   }                                                                                                           \
   var = (*String::Utf8Value((args[num])->ToString()))
 
+
+#define NODE_ARG_CALLBACK(num, name, var)                                                                      \
+  if (args.Length() < num + 1) {                                                                               \
+    return ThrowException(Exception::Error(String::New((std::string(name) + " must be given").c_str())));      \
+  }                                                                                                            \
+  if (!args[num]->IsFunction()) {                                                                              \
+    return ThrowException(Exception::Error(String::New((std::string(name) + " must be a function").c_str()))); \
+  }                                                                                                            \
+  var = Handle<Function>::Cast(args[num]);
+
 // ----- optional argument conversion -------
 
 #define NODE_ARG_INT_OPT(num, name, var)                                                                         \
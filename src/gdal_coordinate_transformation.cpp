@@ -2,6 +2,14 @@
 #include "gdal_common.hpp"
 #include "gdal_spatial_reference.hpp"
 #include "gdal_coordinate_transformation.hpp"
+#include "async_worker.hpp"
+#include "typed_array.hpp"
+
+#include <vector>
+#include <algorithm>
+
+//number of points handed to Transform() at once by transformPoints()
+#define TRANSFORM_CHUNK_SIZE 16384
 
 namespace node_gdal {
 
@@ -17,6 +25,8 @@ void CoordinateTransformation::Initialize(Handle<Object> target)
 
 	NODE_SET_PROTOTYPE_METHOD(constructor, "toString", toString);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "transformPoint", transformPoint);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "transformPoints", transformPoints);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "transformPointsAsync", transformPointsAsync);
 
 	target->Set(String::NewSymbol("CoordinateTransformation"), constructor->GetFunction());
 }
@@ -25,6 +35,7 @@ CoordinateTransformation::CoordinateTransformation(OGRCoordinateTransformation *
 	: ObjectWrap(),
 	  this_(transform)
 {
+	uv_mutex_init(&async_lock);
 	LOG("Created CoordinateTransformation [%p]", transform);
 }
 
@@ -32,6 +43,7 @@ CoordinateTransformation::CoordinateTransformation()
 	: ObjectWrap(),
 	  this_(0)
 {
+	uv_mutex_init(&async_lock);
 }
 
 CoordinateTransformation::~CoordinateTransformation()
@@ -42,6 +54,7 @@ CoordinateTransformation::~CoordinateTransformation()
 		LOG("Disposed CoordinateTransformation [%p]", this_);
 		this_ = NULL;
 	}
+	uv_mutex_destroy(&async_lock);
 }
 
 Handle<Value> CoordinateTransformation::New(const Arguments& args)
@@ -122,7 +135,12 @@ Handle<Value> CoordinateTransformation::transformPoint(const Arguments& args)
 		NODE_ARG_DOUBLE_OPT(2, "z", z);
 	}
 
-	if (!transform->this_->Transform(1, &x, &y, &z)) {
+	//the transform may be in use by transformPointsAsync()
+	transform->lock();
+	int success = transform->this_->Transform(1, &x, &y, &z);
+	transform->unlock();
+
+	if (!success) {
 		return NODE_THROW("Error transforming point");
 	}
 
@@ -134,4 +152,170 @@ Handle<Value> CoordinateTransformation::transformPoint(const Arguments& args)
 	return scope.Close(result);
 }
 
-} // namespace node_gdal
\ No newline at end of file
+// --- batch transformation shared by transformPoints() and transformPointsAsync() ---
+
+//transforms n points in place. coordinates of point i are read from x[i * step],
+//y[i * step] and z[i * step] (z is optional). success[i] is set to 1 or 0 for each point.
+static void transformChunked(OGRCoordinateTransformation *ct, int n, double *x, double *y, double *z, int step, unsigned char *success)
+{
+	int chunk = std::min(n, TRANSFORM_CHUNK_SIZE);
+	std::vector<int> chunk_success(chunk);
+	std::vector<double> xs(chunk), ys(chunk), zs(z ? chunk : 0);
+
+	for (int start = 0; start < n; start += chunk) {
+		int count = std::min(chunk, n - start);
+		size_t offset = (size_t)start * step;
+
+		for (int i = 0; i < count; i++) {
+			xs[i] = x[offset + i * step];
+			ys[i] = y[offset + i * step];
+			if (z) zs[i] = z[offset + i * step];
+		}
+
+		if (!ct->TransformEx(count, &xs[0], &ys[0], z ? &zs[0] : NULL, &chunk_success[0])) {
+			//proj gives up on the whole batch for some errors, so retry the points one by one
+			for (int i = 0; i < count; i++) {
+				xs[i] = x[offset + i * step];
+				ys[i] = y[offset + i * step];
+				if (z) zs[i] = z[offset + i * step];
+				ct->TransformEx(1, &xs[i], &ys[i], z ? &zs[i] : NULL, &chunk_success[i]);
+			}
+		}
+
+		for (int i = 0; i < count; i++) {
+			success[start + i] = chunk_success[i] ? 1 : 0;
+			if (!chunk_success[i]) continue;
+			x[offset + i * step] = xs[i];
+			y[offset + i * step] = ys[i];
+			if (z) z[offset + i * step] = zs[i];
+		}
+	}
+}
+
+class TransformPointsWorker : public AsyncWorker {
+public:
+	TransformPointsWorker(Handle<Function> callback, CoordinateTransformation *transform, int n,
+	                      double *x, double *y, double *z, int step, unsigned char *success)
+		: AsyncWorker(callback), transform(transform), n(n), x(x), y(y), z(z), step(step), success(success)
+	{}
+
+	void Execute()
+	{
+		transform->lock();
+		transformChunked(transform->get(), n, x, y, z, step, success);
+		transform->unlock();
+	}
+
+	Handle<Value> GetResult()
+	{
+		HandleScope scope;
+		return scope.Close(GetFromPersistent("success"));
+	}
+
+private:
+	CoordinateTransformation *transform;
+	int n;
+	double *x, *y, *z;
+	int step;
+	unsigned char *success;
+};
+
+static bool isFloat64Array(Handle<Value> val)
+{
+	return val->IsObject() && TypedArray::Identify(val->ToObject()) == GDT_Float64;
+}
+
+static Handle<Value> transformPointsImpl(const Arguments& args, bool async)
+{
+	HandleScope scope;
+
+	CoordinateTransformation *transform = ObjectWrap::Unwrap<CoordinateTransformation>(args.This());
+
+	int n, stride = 1;
+	double *x, *y, *z = NULL;
+	Handle<Object> xs, ys, zs;
+	Handle<Function> callback;
+
+	if (!isFloat64Array(args[0])) {
+		return NODE_THROW("First argument must be a Float64Array");
+	}
+	xs = args[0]->ToObject();
+	x  = static_cast<double*>(TypedArray::Data(xs));
+
+	if (args.Length() > 1 && args[1]->IsObject()) {
+		//separate x, y and optional z arrays
+		if (!isFloat64Array(args[1])) {
+			return NODE_THROW("ys must be a Float64Array");
+		}
+		ys = args[1]->ToObject();
+		n  = TypedArray::Length(xs);
+		if (TypedArray::Length(ys) != n) {
+			return NODE_THROW("xs and ys must have the same length");
+		}
+		y = static_cast<double*>(TypedArray::Data(ys));
+
+		if (args.Length() > 2 && !args[2]->IsNull() && !args[2]->IsUndefined()) {
+			if (!isFloat64Array(args[2])) {
+				return NODE_THROW("zs must be a Float64Array");
+			}
+			zs = args[2]->ToObject();
+			if (TypedArray::Length(zs) != n) {
+				return NODE_THROW("zs must have the same length as xs and ys");
+			}
+			z = static_cast<double*>(TypedArray::Data(zs));
+		}
+	} else {
+		//single interleaved array
+		stride = 2;
+		NODE_ARG_INT_OPT(1, "stride", stride);
+		if (stride != 2 && stride != 3) {
+			return NODE_THROW("stride must be 2 or 3");
+		}
+		if (TypedArray::Length(xs) % stride) {
+			return NODE_THROW("Array length must be a multiple of stride");
+		}
+		n = TypedArray::Length(xs) / stride;
+		y = x + 1;
+		if (stride == 3) z = x + 2;
+	}
+
+	if (async) {
+		NODE_ARG_CALLBACK(3, "callback", callback);
+	}
+
+	Handle<Value> success = TypedArray::New(GDT_Byte, n);
+	if (success.IsEmpty() || !success->IsObject()) {
+		return success; //TypedArray::New threw an error
+	}
+	unsigned char *success_data = static_cast<unsigned char*>(TypedArray::Data(success->ToObject()));
+
+	if (async) {
+		TransformPointsWorker *worker = new TransformPointsWorker(callback, transform, n, x, y, z, stride, success_data);
+		//keep the arrays and the transformation alive until the job is done
+		worker->SaveToPersistent("transform", args.This());
+		worker->SaveToPersistent("xs", xs);
+		if (!ys.IsEmpty()) worker->SaveToPersistent("ys", ys);
+		if (!zs.IsEmpty()) worker->SaveToPersistent("zs", zs);
+		worker->SaveToPersistent("success", success);
+		AsyncWorker::Queue(worker);
+		return Undefined();
+	}
+
+	transform->lock();
+	transformChunked(transform->get(), n, x, y, z, stride, success_data);
+	transform->unlock();
+
+	return scope.Close(success);
+}
+
+Handle<Value> CoordinateTransformation::transformPoints(const Arguments& args)
+{
+	return transformPointsImpl(args, false);
+}
+
+Handle<Value> CoordinateTransformation::transformPointsAsync(const Arguments& args)
+{
+	return transformPointsImpl(args, true);
+}
+
+} // namespace node_gdal
@@ -11,6 +11,9 @@
 // ogr
 #include <ogrsf_frmts.h>
 
+// libuv
+#include <uv.h>
+
 using namespace v8;
 using namespace node;
 
@@ -24,6 +27,8 @@ public:
 	static Handle<Value> New(OGRCoordinateTransformation *transform);
 	static Handle<Value> toString(const Arguments &args);
 	static Handle<Value> transformPoint(const Arguments &args);
+	static Handle<Value> transformPoints(const Arguments &args);
+	static Handle<Value> transformPointsAsync(const Arguments &args);
 
 	CoordinateTransformation();
 	CoordinateTransformation(OGRCoordinateTransformation *srs);
@@ -31,9 +36,18 @@ public:
 		return this_;
 	}
 
+	//a transformation must not be used by more than one thread at a time
+	inline void lock() {
+		uv_mutex_lock(&async_lock);
+	}
+	inline void unlock() {
+		uv_mutex_unlock(&async_lock);
+	}
+
 private:
 	~CoordinateTransformation();
 	OGRCoordinateTransformation *this_;
+	uv_mutex_t async_lock;
 };
 
 }
@@ -6,6 +6,9 @@
 #include "gdal_spatial_reference.hpp"
 #include "gdal_layer.hpp"
 #include "gdal_geometry.hpp"
+#include "typed_array.hpp"
+#include "fast_buffer.hpp"
+#include "async_worker.hpp"
 #include "collections/dataset_bands.hpp"
 #include "collections/dataset_layers.hpp"
 
@@ -34,6 +37,9 @@ void Dataset::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "testCapability", testCapability);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "executeSQL", executeSQL);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "buildOverviews", buildOverviews);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "buildOverviewsAsync", buildOverviewsAsync);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "readBands", readBands);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toBuffer", toBuffer);
 
 	ATTR(constructor, "description", descriptionGetter, READ_ONLY_SETTER);
 	ATTR(constructor, "bands", bandsGetter, READ_ONLY_SETTER);
@@ -51,8 +57,13 @@ Dataset::Dataset(GDALDataset *ds)
 	  uses_ogr(false),
 	  this_dataset(ds),
 	  this_datasource(0),
-	  result_sets()
+	  result_sets(),
+	  mem_file(),
+	  mem_buffer(),
+	  lock_owner(0),
+	  lock_depth(0)
 {
+	uv_mutex_init(&async_lock);
 	LOG("Created Dataset [%p]", ds);
 }
 
@@ -61,8 +72,13 @@ Dataset::Dataset(OGRDataSource *ds)
 	  uses_ogr(true),
 	  this_dataset(0),
 	  this_datasource(ds),
-	  result_sets()
+	  result_sets(),
+	  mem_file(),
+	  mem_buffer(),
+	  lock_owner(0),
+	  lock_depth(0)
 {
+	uv_mutex_init(&async_lock);
 	LOG("Created Datasource [%p]", ds);
 }
 
@@ -70,6 +86,7 @@ Dataset::~Dataset()
 {
 	//Destroy at garbage collection time if not already explicitly destroyed
 	dispose();
+	uv_mutex_destroy(&async_lock);
 }
 
 void Dataset::dispose()
@@ -78,6 +95,9 @@ void Dataset::dispose()
 	OGRLayer *lyr;
 	Layer *lyr_wrapped;
 	
+	//wait for any async operation that is still using the dataset
+	lock();
+
 	if (this_dataset) {
 		LOG("Disposing Dataset [%p]", this_dataset);
 
@@ -87,8 +107,9 @@ void Dataset::dispose()
 		int n = this_dataset->GetRasterCount();
 		for(int i = 1; i <= n; i++) {
 			band = this_dataset->GetRasterBand(i);
-			if (RasterBand::cache.has(band)) {
-				RasterBand *band_wrapped = ObjectWrap::Unwrap<RasterBand>(RasterBand::cache.get(band));
+			Handle<Object> cached = RasterBand::cache.find(band);
+			if (!cached.IsEmpty()) {
+				RasterBand *band_wrapped = ObjectWrap::Unwrap<RasterBand>(cached);
 				band_wrapped->dispose();
 			}
 		}
@@ -108,8 +129,9 @@ void Dataset::dispose()
 		int n = this_datasource->GetLayerCount();
 		for(int i = 0; i < n; i++) {
 			lyr = this_datasource->GetLayer(i);
-			if (Layer::cache.has(lyr)) {
-				lyr_wrapped = ObjectWrap::Unwrap<Layer>(Layer::cache.get(lyr));
+			Handle<Object> cached = Layer::cache.find(lyr);
+			if (!cached.IsEmpty()) {
+				lyr_wrapped = ObjectWrap::Unwrap<Layer>(cached);
 				lyr_wrapped->dispose();
 			}
 		}
@@ -118,8 +140,9 @@ void Dataset::dispose()
 		n = result_sets.size();
 		for(int i = 0; i < n; i++) {
 			lyr = result_sets[i];
-			if (Layer::cache.has(lyr)) {
-				lyr_wrapped = ObjectWrap::Unwrap<Layer>(Layer::cache.get(lyr));
+			Handle<Object> cached = Layer::cache.find(lyr);
+			if (!cached.IsEmpty()) {
+				lyr_wrapped = ObjectWrap::Unwrap<Layer>(cached);
 				lyr_wrapped->dispose();
 			}
 		}
@@ -131,6 +154,42 @@ void Dataset::dispose()
 
 		this_datasource = NULL;
 	}
+
+	if (!mem_file.empty()) {
+		//the buffer has to outlive the file, so drop it only after unlinking
+		VSIUnlink(mem_file.c_str());
+		VSIUnlink((mem_file + ".aux.xml").c_str());
+		mem_file = "";
+		mem_buffer.Dispose();
+		mem_buffer.Clear();
+	}
+
+	unlock();
+}
+
+Dataset *Dataset::owner(Handle<Object> obj)
+{
+	if (IS_WRAPPED(obj, Dataset)) {
+		return ObjectWrap::Unwrap<Dataset>(obj);
+	}
+	//bands and layers keep their dataset as a hidden value
+	Handle<Value> ds_obj = obj->GetHiddenValue(String::NewSymbol("ds_"));
+	if (ds_obj.IsEmpty() || !ds_obj->IsObject() || !IS_WRAPPED(ds_obj, Dataset)) {
+		return NULL;
+	}
+	return ObjectWrap::Unwrap<Dataset>(ds_obj->ToObject());
+}
+
+void Dataset::attachMemFile(const std::string &path, Handle<Object> buffer)
+{
+	mem_file = path;
+	mem_buffer = Persistent<Object>::New(buffer);
+}
+
+std::string Dataset::uniqueMemPath(const std::string &name)
+{
+	static unsigned int counter = 0;
+	return std::string(CPLSPrintf("/vsimem/node_gdal_%u/", ++counter)) + name;
 }
 
 Handle<Value> Dataset::New(const Arguments& args)
@@ -165,8 +224,9 @@ Handle<Value> Dataset::New(GDALDataset *raw)
 	if (!raw) {
 		return Null();
 	}
-	if (dataset_cache.has(raw)) {
-		return dataset_cache.get(raw);
+	Handle<Object> cached = dataset_cache.find(raw);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	Dataset *wrapped = new Dataset(raw);
@@ -186,8 +246,9 @@ Handle<Value> Dataset::New(OGRDataSource *raw)
 	if (!raw) {
 		return Null();
 	}
-	if (datasource_cache.has(raw)) {
-		return datasource_cache.get(raw);
+	Handle<Object> cached = datasource_cache.find(raw);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	Dataset *wrapped = new Dataset(raw);
@@ -210,6 +271,7 @@ Handle<Value> Dataset::getMetadata(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr){
 		OGRDataSource* raw = ds->getDatasource();
@@ -233,6 +295,7 @@ Handle<Value> Dataset::testCapability(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 	
 	#if GDAL_MAJOR > 2
 		GDALDataset *raw = ds->getDataset();
@@ -258,6 +321,7 @@ Handle<Value> Dataset::getGCPProjection(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr){
 		OGRDataSource* raw = ds->getDatasource();
@@ -280,6 +344,10 @@ Handle<Value> Dataset::close(const Arguments& args)
 	if (!ds->getDataset() && !ds->getDatasource()) {
 		return NODE_THROW("Dataset object has already been destroyed");
 	}
+	if (ds->lockedByCurrentThread()) {
+		//called from a callback of a synchronous operation that is still using the dataset
+		return NODE_THROW("Dataset is in use and can't be closed");
+	}
 
 	ds->dispose();
 
@@ -290,6 +358,7 @@ Handle<Value> Dataset::flush(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr){
 		OGRDataSource* raw = ds->getDatasource();
@@ -315,6 +384,7 @@ Handle<Value> Dataset::executeSQL(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 
 	#if GDAL_MAJOR > 2
 		GDALDataset* raw = ds->getDataset();
@@ -353,6 +423,7 @@ Handle<Value> Dataset::getFileList(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 
 	Handle<Array> results = Array::New(0);
 
@@ -388,6 +459,7 @@ Handle<Value> Dataset::getGCPs(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 	
 	Handle<Array> results = Array::New(0);
 	
@@ -430,6 +502,7 @@ Handle<Value> Dataset::setGCPs(const Arguments& args)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		return NODE_THROW("Dataset does not support setting GCPs")
@@ -476,77 +549,450 @@ Handle<Value> Dataset::setGCPs(const Arguments& args)
 	return Undefined();
 }
 
-Handle<Value> Dataset::buildOverviews(const Arguments& args)
+// --- buildOverviews() and buildOverviewsAsync() ---
+
+//overview creation options, set as thread-local config options while the overviews are built
+static const char *overview_config[][2] = {
+	{"compress",    "COMPRESS_OVERVIEW"},
+	{"interleave",  "INTERLEAVE_OVERVIEW"},
+	{"photometric", "PHOTOMETRIC_OVERVIEW"},
+	{"predictor",   "PREDICTOR_OVERVIEW"},
+	{"jpegQuality", "JPEG_QUALITY_OVERVIEW"},
+	{"bigtiff",     "BIGTIFF_OVERVIEW"}
+};
+static const int n_overview_config = sizeof(overview_config) / sizeof(overview_config[0]);
+
+class BuildOverviewsJob {
+public:
+	BuildOverviewsJob()
+		: ds(NULL), progress(NULL), progress_arg(NULL)
+	{}
+
+	//returns an error message or ""
+	std::string run()
+	{
+		//the dataset may have been closed while the job was queued
+		GDALDataset *raw = ds->getDataset();
+		if (!raw) return "Dataset object has already been destroyed";
+
+		//thread-local, so concurrent jobs on other datasets don't see each other's settings
+		for (int i = 0; i < n_overview_config; i++) {
+			if (!config[i].empty()) CPLSetThreadLocalConfigOption(overview_config[i][1], config[i].c_str());
+		}
+
+		CPLErr err = raw->BuildOverviews(resampling.c_str(), overviews.size(), overviews.empty() ? NULL : &overviews[0],
+		                                 bands.size(), bands.empty() ? NULL : &bands[0], progress, progress_arg);
+
+		for (int i = 0; i < n_overview_config; i++) {
+			if (!config[i].empty()) CPLSetThreadLocalConfigOption(overview_config[i][1], NULL);
+		}
+
+		if (err) {
+			std::string msg = CPLGetLastErrorMsg();
+			return msg.empty() ? "Error building overviews" : msg;
+		}
+		return "";
+	}
+
+	Dataset *ds;
+	std::string resampling;
+	std::vector<int> overviews;
+	std::vector<int> bands;
+	std::string config[n_overview_config];
+	GDALProgressFunc progress;
+	void *progress_arg;
+};
+
+class BuildOverviewsWorker : public AsyncProgressWorker {
+public:
+	BuildOverviewsWorker(Handle<Function> callback, Handle<Function> progress_cb, const BuildOverviewsJob &job)
+		: AsyncProgressWorker(callback, progress_cb), job(job)
+	{
+		this->job.progress = AsyncProgressWorker::ProgressFunc;
+		this->job.progress_arg = this;
+	}
+
+	void Execute()
+	{
+		CPLErrorReset();
+		job.ds->lock();
+		std::string error = job.run();
+		job.ds->unlock();
+		if (!error.empty()) SetErrorMessage(error.c_str());
+	}
+
+	BuildOverviewsJob job;
+};
+
+//parses (resampling, overviews, [bands], [options]) shared by both versions
+static Handle<Value> parseBuildOverviewsArgs(const Arguments& args, BuildOverviewsJob &job, Handle<Function> &progress_cb)
 {
-	HandleScope scope;
-	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
-	
-	if (ds->uses_ogr) {
+	job.ds = ObjectWrap::Unwrap<Dataset>(args.This());
+
+	if (job.ds->uses_ogr) {
 		return NODE_THROW("Dataset does not support building overviews");
 	}
 
-	GDALDataset* raw = ds->getDataset();
+	GDALDataset* raw = job.ds->getDataset();
 	if (!raw) {
 		return NODE_THROW("Dataset object has already been destroyed");
 	}
 
-
-	std::string resampling = "";
 	Handle<Array> overviews;
 	Handle<Array> bands;
+	Handle<Object> options = Object::New();
 
-	NODE_ARG_STR(0, "resampling", resampling);
+	NODE_ARG_STR(0, "resampling", job.resampling);
 	NODE_ARG_ARRAY(1, "overviews", overviews);
 	NODE_ARG_ARRAY_OPT(2, "bands", bands);
+	if (args.Length() > 3 && !args[3]->IsUndefined() && !args[3]->IsNull()) {
+		if (!args[3]->IsObject()) return NODE_THROW("options must be an object");
+		options = args[3]->ToObject();
+	}
 
-	int *o, *b = NULL;
-	int n_overviews = overviews->Length();
-	int i, n_bands = 0; 
-
-	o = new int[n_overviews];
-	for(i = 0; i<n_overviews; i++){
+	for (unsigned int i = 0; i < overviews->Length(); i++) {
 		Handle<Value> val = overviews->Get(i);
-		if(!val->IsNumber()) {
-			delete [] o;
+		if (!val->IsNumber()) {
 			return NODE_THROW("overviews array must only contain numbers");
 		}
-		o[i] = val->Int32Value(); 
+		job.overviews.push_back(val->Int32Value());
 	}
 
-	if(!bands.IsEmpty()){
-		n_bands = bands->Length();
-		b = new int[n_bands];
-		for(i = 0; i<n_bands; i++){
+	if (!bands.IsEmpty()) {
+		for (unsigned int i = 0; i < bands->Length(); i++) {
 			Handle<Value> val = bands->Get(i);
-			if(!val->IsNumber()) {
-				delete [] o;
-				delete [] b;
+			if (!val->IsNumber()) {
 				return NODE_THROW("band array must only contain numbers");
 			}
-			b[i] = val->Int32Value(); 
-			if(b[i] > raw->GetRasterCount() || b[i] < 1) {
+			int band = val->Int32Value();
+			if (band > raw->GetRasterCount() || band < 1) {
 				//BuildOverviews prints an error but segfaults before returning
-				delete [] o;
-				delete [] b;
 				return NODE_THROW("invalid band id");
 			}
+			job.bands.push_back(band);
 		}
 	}
 
-	CPLErr err = raw->BuildOverviews(resampling.c_str(), n_overviews, o, n_bands, b, NULL, NULL);
-	
-	delete [] o;
-	if(b) delete [] b;
+	for (int i = 0; i < n_overview_config; i++) {
+		Handle<Value> val = options->Get(String::NewSymbol(overview_config[i][0]));
+		if (val->IsUndefined() || val->IsNull()) continue;
+		if (!val->IsString() && !val->IsNumber()) {
+			return NODE_THROW((std::string(overview_config[i][0]) + " must be a string").c_str());
+		}
+		job.config[i] = TOSTR(val);
+	}
+
+	Handle<Value> progress = options->Get(String::NewSymbol("progress"));
+	if (!progress->IsUndefined() && !progress->IsNull()) {
+		if (!progress->IsFunction()) return NODE_THROW("progress must be a function");
+		progress_cb = Handle<Function>::Cast(progress);
+	}
+
+	return Handle<Value>();
+}
+
+Handle<Value> Dataset::buildOverviews(const Arguments& args)
+{
+	HandleScope scope;
 
-	if(err) return NODE_THROW_CPLERR(err);
+	BuildOverviewsJob job;
+	Handle<Function> progress_cb;
+	Handle<Value> error = parseBuildOverviewsArgs(args, job, progress_cb);
+	if (!error.IsEmpty()) return error;
+
+	if (!progress_cb.IsEmpty()) {
+		job.progress = SyncProgressFunc;
+		job.progress_arg = &progress_cb;
+	}
+
+	TryCatch try_catch;
+
+	CPLErrorReset();
+	job.ds->lock();
+	std::string msg = job.run();
+	job.ds->unlock();
+
+	if (try_catch.HasCaught()) {
+		return try_catch.ReThrow();
+	}
+	if (!msg.empty()) {
+		return NODE_THROW(msg.c_str());
+	}
 
 	return Undefined();
 }
 
+Handle<Value> Dataset::buildOverviewsAsync(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Function> callback;
+	NODE_ARG_CALLBACK(4, "callback", callback);
+
+	BuildOverviewsJob job;
+	Handle<Function> progress_cb;
+	Handle<Value> error = parseBuildOverviewsArgs(args, job, progress_cb);
+	if (!error.IsEmpty()) return error;
+
+	BuildOverviewsWorker *worker = new BuildOverviewsWorker(callback, progress_cb, job);
+
+	//keep the dataset alive until the overviews are built
+	worker->SaveToPersistent("ds", args.This());
+	AsyncWorker::Queue(worker);
+
+	return Undefined();
+}
+
+Handle<Value> Dataset::readBands(const Arguments& args)
+{
+	HandleScope scope;
+	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+
+	if (ds->uses_ogr) {
+		return NODE_THROW("Dataset does not support reading raster data");
+	}
+
+	GDALDataset* raw = ds->getDataset();
+	if (!raw) {
+		return NODE_THROW("Dataset object has already been destroyed");
+	}
+
+	int x, y, w, h;
+	int buffer_w, buffer_h;
+	int bytes_per_pixel;
+	int pixel_space, line_space, band_space;
+	int i, n_bands;
+	int length;
+	double size;
+	void *data;
+	Handle<Array>  band_list;
+	Handle<Value>  array;
+	Handle<Object> passed_array;
+	GDALDataType type;
+	std::string type_name = "";
+
+	NODE_ARG_INT(0, "x_offset", x);
+	NODE_ARG_INT(1, "y_offset", y);
+	NODE_ARG_INT(2, "x_size", w);
+	NODE_ARG_INT(3, "y_size", h);
+	NODE_ARG_ARRAY_OPT(4, "bands", band_list);
+
+	if (!band_list.IsEmpty()) {
+		n_bands = band_list->Length();
+	} else {
+		n_bands = raw->GetRasterCount();
+	}
+	if (n_bands < 1) {
+		return NODE_THROW("Dataset has no bands to read");
+	}
+
+	std::vector<int> bands(n_bands);
+	for (i = 0; i < n_bands; i++) {
+		if (band_list.IsEmpty()) {
+			bands[i] = i + 1;
+			continue;
+		}
+		Handle<Value> val = band_list->Get(i);
+		if (!val->IsNumber()) {
+			return NODE_THROW("band array must only contain numbers");
+		}
+		bands[i] = val->Int32Value();
+		if (bands[i] > raw->GetRasterCount() || bands[i] < 1) {
+			return NODE_THROW("invalid band id");
+		}
+	}
+
+	buffer_w = w;
+	buffer_h = h;
+	type     = raw->GetRasterBand(bands[0])->GetRasterDataType();
+	NODE_ARG_INT_OPT(6, "buffer_width", buffer_w);
+	NODE_ARG_INT_OPT(7, "buffer_height", buffer_h);
+	NODE_ARG_OPT_STR(8, "data_type", type_name);
+	if (!type_name.empty()) {
+		type = GDALGetDataTypeByName(type_name.c_str());
+		if (type == GDT_Unknown) return NODE_THROW("Invalid data type");
+	}
+
+	if (args.Length() >= 6 && !args[5]->IsUndefined() && !args[5]->IsNull()) {
+		NODE_ARG_OBJECT(5, "data", passed_array);
+		type = TypedArray::Identify(passed_array);
+		if (type == GDT_Unknown) return NODE_THROW("Invalid array");
+	}
+
+	//pixel interleaved by default
+	bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+	pixel_space = bytes_per_pixel * n_bands;
+	NODE_ARG_INT_OPT(9, "pixel_space", pixel_space);
+	line_space = pixel_space * buffer_w;
+	NODE_ARG_INT_OPT(10, "line_space", line_space);
+	band_space = bytes_per_pixel;
+	NODE_ARG_INT_OPT(11, "band_space", band_space);
+
+	if (pixel_space < bytes_per_pixel) {
+		return NODE_THROW("pixel_space must be greater than or equal to size of data_type");
+	}
+	if (line_space < pixel_space * buffer_w) {
+		return NODE_THROW("line_space must be greater than or equal to pixel_space * buffer_w");
+	}
+	if (band_space < bytes_per_pixel) {
+		return NODE_THROW("band_space must be greater than or equal to size of data_type");
+	}
+
+	//offset of the last byte written, plus one
+	size = (double) (n_bands - 1) * band_space
+	     + (double) (buffer_h - 1) * line_space
+	     + (double) (buffer_w - 1) * pixel_space
+	     + bytes_per_pixel;
+	if (size > INT_MAX) {
+		return NODE_THROW("Buffer would be too large");
+	}
+	length = ((int) size + bytes_per_pixel - 1) / bytes_per_pixel;
+
+	//create array if no array was passed
+	if (passed_array.IsEmpty()) {
+		array = TypedArray::New(type, length);
+		if (array.IsEmpty() || !array->IsObject()) {
+			return array; //TypedArray::New threw an error
+		}
+		data = TypedArray::Data(array->ToObject());
+	} else {
+		array = passed_array;
+		if (TypedArray::Length(passed_array) < length) {
+			return NODE_THROW("Invalid array length");
+		}
+		data = TypedArray::Data(passed_array);
+	}
+
+	ds->lock();
+	CPLErr err = raw->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, n_bands, &bands[0], pixel_space, line_space, band_space);
+	ds->unlock();
+	if (err) return NODE_THROW_CPLERR(err);
+
+	return scope.Close(array);
+}
+
+//removes a /vsimem/ directory and everything in it
+static void unlinkMemDir(const std::string &dir)
+{
+	char **files = VSIReadDir(dir.c_str());
+	for (int i = 0; files && files[i]; i++) {
+		std::string path = dir + "/" + files[i];
+		VSIStatBufL stat;
+		if (VSIStatL(path.c_str(), &stat) == 0 && VSI_ISDIR(stat.st_mode)) {
+			unlinkMemDir(path);
+		} else {
+			VSIUnlink(path.c_str());
+		}
+	}
+	CSLDestroy(files);
+	VSIRmdir(dir.c_str());
+}
+
+static void freeMemFileBuffer(char *data, void *hint)
+{
+	CPLFree(data);
+}
+
+Handle<Value> Dataset::toBuffer(const Arguments& args)
+{
+	HandleScope scope;
+	Dataset *ds = ObjectWrap::Unwrap<Dataset>(args.This());
+
+	if (!ds->getDataset() && !ds->getDatasource()) {
+		return NODE_THROW("Dataset object has already been destroyed");
+	}
+
+	Driver *driver = NULL;
+	Handle<Array> creation_options = Array::New(0);
+
+	if (args.Length() > 0 && !args[0]->IsNull() && !args[0]->IsUndefined()) {
+		if (!IS_WRAPPED(args[0], Driver)) {
+			return NODE_THROW("driver must be an instance of Driver");
+		}
+		driver = ObjectWrap::Unwrap<Driver>(args[0]->ToObject());
+	}
+	NODE_ARG_ARRAY_OPT(1, "dataset creation options", creation_options);
+
+	if (driver && driver->uses_ogr != ds->uses_ogr) {
+		return NODE_THROW("Driver unable to copy dataset");
+	}
+
+	std::vector<std::string> options_str(creation_options->Length());
+	std::vector<char*> options(creation_options->Length() + 1, (char*) NULL);
+	for (unsigned int i = 0; i < creation_options->Length(); ++i) {
+		options_str[i] = TOSTR(creation_options->Get(i));
+		options[i]     = (char*) options_str[i].c_str();
+	}
+
+	//write the copy into its own directory so side-car files can be found and cleaned up
+	std::string path = uniqueMemPath("dataset");
+	std::string dir  = CPLGetPath(path.c_str());
+	bool copied;
+
+	//datasets opened through a driver's pfnOpen directly (Driver#open, openBuffer with a driver) have none set
+	if (!driver && (ds->uses_ogr ? !ds->getDatasource()->GetDriver() : !ds->getDataset()->GetDriver())) {
+		return NODE_THROW("Dataset has no driver, one must be given");
+	}
+
+	ds->lock();
+	if (ds->uses_ogr) {
+		OGRSFDriver *raw = driver ? driver->getOGRSFDriver() : ds->getDatasource()->GetDriver();
+		OGRDataSource *copy = raw->CopyDataSource(ds->getDatasource(), path.c_str(), &options[0]);
+		copied = copy != NULL;
+		if (copy) OGRDataSource::DestroyDataSource(copy);
+	} else {
+		GDALDriver *raw = driver ? driver->getGDALDriver() : ds->getDataset()->GetDriver();
+		const char *ext = raw->GetMetadataItem(GDAL_DMD_EXTENSION);
+		if (ext && ext[0]) {
+			path = path + "." + ext;
+		}
+		GDALDataset *copy = raw->CreateCopy(path.c_str(), ds->getDataset(), FALSE, &options[0], NULL, NULL);
+		copied = copy != NULL;
+		if (copy) GDALClose(copy);
+	}
+	ds->unlock();
+
+	if (!copied) {
+		unlinkMemDir(dir);
+		return NODE_THROW("Error copying dataset");
+	}
+
+	//anything besides the dataset itself (and its PAM side-car) can't be returned as a single buffer
+	VSIStatBufL stat;
+	bool single_file = VSIStatL(path.c_str(), &stat) == 0 && !VSI_ISDIR(stat.st_mode);
+	char **files = VSIReadDir(dir.c_str());
+	std::string aux = std::string(CPLGetFilename(path.c_str())) + ".aux.xml";
+	for (int i = 0; single_file && files && files[i]; i++) {
+		single_file = files[i] == std::string(CPLGetFilename(path.c_str())) || files[i] == aux;
+	}
+	CSLDestroy(files);
+
+	if (!single_file) {
+		unlinkMemDir(dir);
+		return NODE_THROW("Driver wrote more than one file; only single-file formats can be written to a buffer");
+	}
+
+	vsi_l_offset length = 0;
+	GByte *data = VSIGetMemFileBuffer(path.c_str(), &length, TRUE);
+	unlinkMemDir(dir);
+
+	if (!data) {
+		return NODE_THROW("Error reading dataset from memory");
+	}
+	if (length > INT_MAX) {
+		CPLFree(data);
+		return NODE_THROW("Dataset is too large for a buffer");
+	}
+
+	//the buffer takes over the memory GDAL wrote into
+	return scope.Close(FastBuffer::New((char*) data, (int) length, freeMemFileBuffer, NULL));
+}
+
 Handle<Value> Dataset::descriptionGetter(Local<String> property, const AccessorInfo &info)
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		OGRDataSource* raw = ds->getDatasource();
@@ -567,6 +1013,7 @@ Handle<Value> Dataset::rasterSizeGetter(Local<String> property, const AccessorIn
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		OGRDataSource* raw = ds->getDatasource();
@@ -590,6 +1037,7 @@ Handle<Value> Dataset::srsGetter(Local<String> property, const AccessorInfo &inf
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		OGRDataSource* raw = ds->getDatasource();
@@ -625,6 +1073,7 @@ Handle<Value> Dataset::geoTransformGetter(Local<String> property, const Accessor
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		OGRDataSource* raw = ds->getDatasource();
@@ -659,6 +1108,7 @@ Handle<Value> Dataset::driverGetter(Local<String> property, const AccessorInfo &
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		OGRDataSource* raw = ds->getDatasource();
@@ -679,6 +1129,7 @@ void Dataset::srsSetter(Local<String> property, Local<Value> value, const Access
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	
 	if (ds->uses_ogr) {
 		NODE_THROW("Dataset doesnt support setting a spatial reference");
@@ -721,6 +1172,7 @@ void Dataset::geoTransformSetter(Local<String> property, Local<Value> value, con
 {
 	HandleScope scope;
 	Dataset *ds = ObjectWrap::Unwrap<Dataset>(info.This());
+	DatasetLock lock(ds);
 	if (ds->uses_ogr) {
 		NODE_THROW("Dataset doesnt support setting a geotransform");
 		return;
@@ -14,6 +14,9 @@
 // ogr
 #include <ogrsf_frmts.h>
 
+// libuv
+#include <uv.h>
+
 #include "obj_cache.hpp"
 
 using namespace v8;
@@ -41,6 +44,9 @@ public:
 	static Handle<Value> executeSQL(const Arguments &args);
 	static Handle<Value> testCapability(const Arguments &args);
 	static Handle<Value> buildOverviews(const Arguments &args);
+	static Handle<Value> buildOverviewsAsync(const Arguments &args);
+	static Handle<Value> readBands(const Arguments &args);
+	static Handle<Value> toBuffer(const Arguments &args);
 	static Handle<Value> close(const Arguments &args);
 
 	static Handle<Value> bandsGetter(Local<String> property, const AccessorInfo &info);
@@ -67,12 +73,62 @@ public:
 	}
 	void dispose();
 
+	//makes the dataset responsible for an in-memory (/vsimem/) file backed by a node Buffer:
+	//the buffer is kept alive and the file unlinked when the dataset is disposed
+	void attachMemFile(const std::string &path, Handle<Object> buffer);
+	//returns a unique path under /vsimem/ for temporary files
+	static std::string uniqueMemPath(const std::string &name);
+
+	//serializes access to the underlying dataset between the JS thread and async workers.
+	//recursive for the thread holding it, so a JS callback invoked by a synchronous
+	//operation can use the dataset again without deadlocking
+	inline void lock() {
+		unsigned long self = uv_thread_self();
+		if (lock_depth > 0 && lock_owner == self) {
+			lock_depth++;
+			return;
+		}
+		uv_mutex_lock(&async_lock);
+		lock_owner = self;
+		lock_depth = 1;
+	}
+	inline void unlock() {
+		if (--lock_depth == 0) {
+			lock_owner = 0;
+			uv_mutex_unlock(&async_lock);
+		}
+	}
+	//true if the calling thread holds the lock (the dataset is in use further up the stack)
+	inline bool lockedByCurrentThread() {
+		return lock_depth > 0 && lock_owner == uv_thread_self();
+	}
+	//the dataset a Dataset, RasterBand or Layer wrapper belongs to (NULL if none)
+	static Dataset *owner(Handle<Object> obj);
+
 	bool uses_ogr;
 private:
 	~Dataset();
 	GDALDataset   *this_dataset;
 	OGRDataSource *this_datasource;
 	std::vector<OGRLayer*> result_sets;
+	std::string mem_file;
+	Persistent<Object> mem_buffer;
+	uv_mutex_t async_lock;
+	volatile unsigned long lock_owner;
+	volatile int lock_depth;
+};
+
+//locks a dataset (if any) for the lifetime of the guard, so accessors can return early
+class DatasetLock {
+public:
+	DatasetLock(Dataset *ds) : ds(ds) {
+		if (ds) ds->lock();
+	}
+	~DatasetLock() {
+		if (ds) ds->unlock();
+	}
+private:
+	Dataset *ds;
 };
 
 }
@@ -2,6 +2,11 @@
 #include "gdal_majorobject.hpp"
 #include "gdal_driver.hpp"
 #include "gdal_dataset.hpp"
+#include "async_worker.hpp"
+
+// std
+#include <string>
+#include <vector>
 
 namespace node_gdal {
 
@@ -21,6 +26,7 @@ void Driver::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "open", open);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "create", create);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "createCopy", createCopy);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "createCopyAsync", createCopyAsync);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "deleteDataset", deleteDataset);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "rename", rename);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "copyFiles", copyFiles);
@@ -95,8 +101,9 @@ Handle<Value> Driver::New(GDALDriver *driver)
 	if (!driver) {
 		return Null();
 	}
-	if (cache.has(driver)) {
-		return cache.get(driver);
+	Handle<Object> cached = cache.find(driver);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	Driver *wrapped = new Driver(driver);
@@ -115,8 +122,9 @@ Handle<Value> Driver::New(OGRSFDriver *driver)
 	if (!driver) {
 		return Null();
 	}
-	if (cache_ogr.has(driver)) {
-		return cache_ogr.get(driver);
+	Handle<Object> cached = cache_ogr.find(driver);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	Driver *wrapped = new Driver(driver);
@@ -237,83 +245,196 @@ Handle<Value> Driver::create(const Arguments& args)
 	}
 
 }
-Handle<Value> Driver::createCopy(const Arguments& args)
-{
-	HandleScope scope;
-	Driver *driver = ObjectWrap::Unwrap<Driver>(args.This());
+// --- createCopy() and createCopyAsync() ---
+
+class CreateCopyJob {
+public:
+	CreateCopyJob()
+		: driver(NULL), src(NULL), strict(false), progress(NULL), progress_arg(NULL), ds(NULL), ds_ogr(NULL)
+	{}
+
+	//returns an error message or ""
+	std::string run()
+	{
+		//the source may have been closed while the job was queued
+		if (!src->getDataset() && !src->getDatasource()) {
+			return "Dataset object has already been destroyed";
+		}
+
+		std::vector<char*> options_ptr;
+		for (unsigned int i = 0; i < options.size(); i++) {
+			options_ptr.push_back((char*) options[i].c_str());
+		}
+		options_ptr.push_back(NULL);
+
+		if (driver->uses_ogr) {
+			//OGR drivers don't report progress
+			ds_ogr = driver->getOGRSFDriver()->CopyDataSource(src->getDatasource(), filename.c_str(), &options_ptr[0]);
+			if (!ds_ogr) return "Error copying dataset.";
+			return "";
+		}
+
+		ds = driver->getGDALDriver()->CreateCopy(filename.c_str(), src->getDataset(), strict, &options_ptr[0], progress, progress_arg);
+		if (!ds) {
+			std::string msg = CPLGetLastErrorMsg();
+			//don't leave a partial file behind if the copy was cancelled
+			if (CPLGetLastErrorNo() == CPLE_UserInterrupt) {
+				GDALDriver::QuietDelete(filename.c_str());
+			}
+			return msg.empty() ? "Error copying dataset" : msg;
+		}
+		return "";
+	}
 
+	Handle<Value> result()
+	{
+		HandleScope scope;
+		if (ds_ogr) return scope.Close(Dataset::New(ds_ogr));
+		return scope.Close(Dataset::New(ds));
+	}
+
+	Driver *driver;
+	Dataset *src;
 	std::string filename;
-	Dataset* src_dataset;
-	unsigned int i, strict = 0;
+	std::vector<std::string> options;
+	bool strict;
+	GDALProgressFunc progress;
+	void *progress_arg;
+
+private:
+	GDALDataset *ds;
+	OGRDataSource *ds_ogr;
+};
+
+class CreateCopyWorker : public AsyncProgressWorker {
+public:
+	CreateCopyWorker(Handle<Function> callback, Handle<Function> progress_cb, const CreateCopyJob &job)
+		: AsyncProgressWorker(callback, progress_cb), job(job)
+	{
+		this->job.progress = AsyncProgressWorker::ProgressFunc;
+		this->job.progress_arg = this;
+	}
+
+	void Execute()
+	{
+		CPLErrorReset();
+		job.src->lock();
+		std::string error = job.run();
+		job.src->unlock();
+		if (!error.empty()) SetErrorMessage(error.c_str());
+	}
+
+	Handle<Value> GetResult()
+	{
+		return job.result();
+	}
+
+	CreateCopyJob job;
+};
+
+//parses (filename, src, [options], [{strict, progress}]) shared by both versions
+static Handle<Value> parseCreateCopyArgs(const Arguments& args, CreateCopyJob &job, Handle<Function> &progress_cb)
+{
 	Handle<Array> creation_options = Array::New(0);
+	Handle<Object> params = Object::New();
 
-	NODE_ARG_STR(0, "filename", filename);
+	job.driver = ObjectWrap::Unwrap<Driver>(args.This());
+
+	NODE_ARG_STR(0, "filename", job.filename);
 
 	//NODE_ARG_STR(1, "source dataset", src_dataset)
 	if(args.Length() < 2){
 		return NODE_THROW("source dataset must be provided");
 	}
 	if (IS_WRAPPED(args[1], Dataset)) {
-		src_dataset = ObjectWrap::Unwrap<Dataset>(args[1]->ToObject());
+		job.src = ObjectWrap::Unwrap<Dataset>(args[1]->ToObject());
 	} else {
 		return NODE_THROW("source dataset must be a Dataset object")
-	}	
+	}
 
 	NODE_ARG_ARRAY_OPT(2, "dataset creation options", creation_options);
+	if (args.Length() > 3 && !args[3]->IsUndefined() && !args[3]->IsNull()) {
+		if (!args[3]->IsObject()) return NODE_THROW("copy options must be an object");
+		params = args[3]->ToObject();
+	}
 
-	char **options = NULL;
-	std::string *options_str = NULL;
+	for (unsigned int i = 0; i < creation_options->Length(); ++i) {
+		job.options.push_back(TOSTR(creation_options->Get(i)));
+	}
 
-	if (creation_options->Length() > 0) {
-		options = new char* [creation_options->Length()+1];
-		options_str = new std::string [creation_options->Length()+1];
-		for (i = 0; i < creation_options->Length(); ++i) {
-			options_str[i] = TOSTR(creation_options->Get(i));
-			options[i]     = (char*) options_str[i].c_str();
-		}
-		options[i] = NULL;
+	Handle<Value> strict = params->Get(String::NewSymbol("strict"));
+	if (!strict->IsUndefined() && !strict->IsNull()) {
+		if (!strict->IsBoolean()) return NODE_THROW("strict must be a boolean");
+		job.strict = strict->BooleanValue();
 	}
 
-	if (driver->uses_ogr) {
-		OGRSFDriver *raw = driver->getOGRSFDriver();
-		OGRDataSource *raw_ds = src_dataset->getDatasource();
-		if(!src_dataset->uses_ogr) {
-			return NODE_THROW("Driver unable to copy dataset");
-		}
-		if (!raw_ds) {
-			return NODE_THROW("Dataset object has already been destroyed");
-		}
+	Handle<Value> progress = params->Get(String::NewSymbol("progress"));
+	if (!progress->IsUndefined() && !progress->IsNull()) {
+		if (!progress->IsFunction()) return NODE_THROW("progress must be a function");
+		progress_cb = Handle<Function>::Cast(progress);
+	}
 
-		OGRDataSource *ds = raw->CopyDataSource(raw_ds, filename.c_str(), options);
+	if (job.driver->uses_ogr != job.src->uses_ogr) {
+		return NODE_THROW("Driver unable to copy dataset");
+	}
+	if (!job.src->getDataset() && !job.src->getDatasource()) {
+		return NODE_THROW("Dataset object has already been destroyed");
+	}
 
-		if(options)	    delete [] options;
-		if(options_str)	delete [] options_str;
+	return Handle<Value>();
+}
 
-		if (!ds) {
-			return NODE_THROW("Error copying dataset.");
-		}
+Handle<Value> Driver::createCopy(const Arguments& args)
+{
+	HandleScope scope;
 
-		return scope.Close(Dataset::New(ds));
-	} else {
-		GDALDriver *raw = driver->getGDALDriver();
-		GDALDataset* raw_ds = src_dataset->getDataset();
-		if(src_dataset->uses_ogr) {
-			return NODE_THROW("Driver unable to copy dataset");
-		}
-		if(!raw_ds) {
-			return NODE_THROW("Dataset object has already been destroyed");
-		}
-		GDALDataset* ds = raw->CreateCopy(filename.c_str(), raw_ds, strict, options, NULL, NULL);
+	CreateCopyJob job;
+	Handle<Function> progress_cb;
+	Handle<Value> error = parseCreateCopyArgs(args, job, progress_cb);
+	if (!error.IsEmpty()) return error;
 
-		if(options)	    delete [] options;
-		if(options_str)	delete [] options_str;
+	if (!progress_cb.IsEmpty()) {
+		job.progress = SyncProgressFunc;
+		job.progress_arg = &progress_cb;
+	}
 
-		if (!ds) {
-			return NODE_THROW("Error copying dataset");
-		}
+	TryCatch try_catch;
 
-		return scope.Close(Dataset::New(ds));
+	CPLErrorReset();
+	job.src->lock();
+	std::string msg = job.run();
+	job.src->unlock();
+
+	if (try_catch.HasCaught()) {
+		return try_catch.ReThrow();
+	}
+	if (!msg.empty()) {
+		return NODE_THROW(msg.c_str());
 	}
+
+	return scope.Close(job.result());
+}
+
+Handle<Value> Driver::createCopyAsync(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Function> callback;
+	NODE_ARG_CALLBACK(4, "callback", callback);
+
+	CreateCopyJob job;
+	Handle<Function> progress_cb;
+	Handle<Value> error = parseCreateCopyArgs(args, job, progress_cb);
+	if (!error.IsEmpty()) return error;
+
+	CreateCopyWorker *worker = new CreateCopyWorker(callback, progress_cb, job);
+
+	//keep the source dataset and driver alive until the copy is done
+	worker->SaveToPersistent("src", args[1]);
+	worker->SaveToPersistent("driver", args.This());
+	AsyncWorker::Queue(worker);
+
+	return Undefined();
 }
 
 Handle<Value> Driver::copyFiles(const Arguments& args)
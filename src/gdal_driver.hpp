@@ -35,6 +35,7 @@ public:
 	static Handle<Value> open(const Arguments &args);
 	static Handle<Value> create(const Arguments &args);
 	static Handle<Value> createCopy(const Arguments &args);
+	static Handle<Value> createCopyAsync(const Arguments &args);
 	static Handle<Value> deleteDataset(const Arguments &args);
 	static Handle<Value> rename(const Arguments &args);
 	static Handle<Value> copyFiles(const Arguments &args);
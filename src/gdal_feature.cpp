@@ -5,6 +5,7 @@
 #include "gdal_geometry.hpp"
 #include "gdal_field_defn.hpp"
 #include "gdal_layer.hpp"
+#include "gdal_dataset.hpp"
 #include "collections/feature_fields.hpp"
 
 namespace node_gdal {
@@ -99,6 +100,7 @@ Handle<Value> Feature::New(const Arguments& args)
 			if (!layer->get()) {
 				return NODE_THROW("Layer object already destroyed");
 			}
+			DatasetLock lock(Layer::parentDataset(args[0]->ToObject()));
 			def = layer->get()->GetLayerDefn();
 		} else if(IS_WRAPPED(args[0], FeatureDefn)) {
 			FeatureDefn *feature_def = ObjectWrap::Unwrap<FeatureDefn>(args[0]->ToObject());
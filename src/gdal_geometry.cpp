@@ -4,6 +4,8 @@
 #include "gdal_coordinate_transformation.hpp"
 #include "gdal_geometry.hpp"
 #include "gdal_geometrycollection.hpp"
+#include "gdal_geometry_array.hpp"
+#include "gdal_prepared_geometry.hpp"
 #include "gdal_point.hpp"
 #include "gdal_linestring.hpp"
 #include "gdal_linearring.hpp"
@@ -13,9 +15,11 @@
 #include "gdal_multipolygon.hpp"
 
 #include "fast_buffer.hpp"
+#include "typed_array.hpp"
 
 #include <node_buffer.h>
 #include <sstream>
+#include <vector>
 #include <stdlib.h>
 #include <ogr_core.h>
 
@@ -34,6 +38,9 @@ void Geometry::Initialize(Handle<Object> target)
 	//NODE_SET_METHOD(constructor, "fromWKBType", Geometry::create);
 	NODE_SET_METHOD(constructor, "fromWKT", Geometry::createFromWkt);
 	NODE_SET_METHOD(constructor, "fromWKB", Geometry::createFromWkb);
+	NODE_SET_METHOD(constructor, "toWKBMany", Geometry::exportToWKBMany);
+	NODE_SET_METHOD(constructor, "fromWKBMany", GeometryArray::fromWKBMany);
+	NODE_SET_METHOD(constructor, "fromWKTMany", GeometryArray::fromWKTMany);
 	NODE_SET_METHOD(constructor, "getName", Geometry::getName);
 	NODE_SET_METHOD(constructor, "getConstructor", Geometry::getConstructor);
 
@@ -75,6 +82,7 @@ void Geometry::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "getEnvelope3D", getEnvelope3D);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "transform", transform);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "transformTo", transformTo);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "prepare", prepare);
 
 	ATTR(constructor, "srs", srsGetter, srsSetter);
 	ATTR(constructor, "wkbSize", wkbSizeGetter, READ_ONLY_SETTER);
@@ -233,9 +241,27 @@ NODE_WRAPPED_METHOD_WITH_RESULT_1_WRAPPED_PARAM(Geometry, symDifference, Geometr
 NODE_WRAPPED_METHOD_WITH_RESULT_1_DOUBLE_PARAM(Geometry, simplify, Geometry, Simplify, "tolerance");
 NODE_WRAPPED_METHOD_WITH_RESULT_1_DOUBLE_PARAM(Geometry, simplifyPreserveTopology, Geometry, SimplifyPreserveTopology, "tolerance");
 NODE_WRAPPED_METHOD_WITH_1_DOUBLE_PARAM(Geometry, segmentize, segmentize, "segment length");
-NODE_WRAPPED_METHOD_WITH_OGRERR_RESULT_1_WRAPPED_PARAM(Geometry, transform, transform, CoordinateTransformation, "transform");
 NODE_WRAPPED_METHOD_WITH_OGRERR_RESULT_1_WRAPPED_PARAM(Geometry, transformTo, transformTo, SpatialReference, "spatial reference");
 
+//manually wrap this method because the transform may be in use by transformPointsAsync()
+Handle<Value> Geometry::transform(const Arguments& args)
+{
+	HandleScope scope;
+
+	CoordinateTransformation *ct;
+	NODE_ARG_WRAPPED(0, "transform", CoordinateTransformation, ct);
+
+	Geometry *geom = ObjectWrap::Unwrap<Geometry>(args.This());
+	if (!geom->this_) return NODE_THROW("Geometry object has already been destroyed");
+
+	ct->lock();
+	int err = geom->this_->transform(ct->get());
+	ct->unlock();
+
+	if (err) return NODE_THROW_OGRERR(err);
+	return Undefined();
+}
+
 //manually wrap this method because we don't have macros for multiple params
 Handle<Value> Geometry::buffer(const Arguments& args)
 {
@@ -253,6 +279,15 @@ Handle<Value> Geometry::buffer(const Arguments& args)
 }
 
 
+Handle<Value> Geometry::prepare(const Arguments& args)
+{
+	HandleScope scope;
+
+	Geometry *geom = ObjectWrap::Unwrap<Geometry>(args.This());
+
+	return scope.Close(PreparedGeometry::New(geom->this_));
+}
+
 Handle<Value> Geometry::exportToWKT(const Arguments& args)
 {
 	HandleScope scope;
@@ -272,19 +307,18 @@ Handle<Value> Geometry::exportToWKT(const Arguments& args)
 	return Undefined();
 }
 
-Handle<Value> Geometry::exportToWKB(const Arguments& args)
+#if !(GDAL_VERSION_MAJOR > 1 || (GDAL_VERSION_MINOR > 10))
+typedef int OGRwkbVariant;
+#endif
+
+//parses the optional (byte_order, variant) arguments of toWKB() and toWKBMany()
+static Handle<Value> parseWkbArgs(const Arguments& args, int first, OGRwkbByteOrder &byte_order, OGRwkbVariant &wkb_variant)
 {
 	HandleScope scope;
 
-	Geometry *geom = ObjectWrap::Unwrap<Geometry>(args.This());
-
-	int size = geom->this_->WkbSize();
-	unsigned char *data = (unsigned char*) malloc(size);
-
 	//byte order
-	OGRwkbByteOrder byte_order;
 	std::string order = "MSB";
-	NODE_ARG_OPT_STR(0, "byte order", order);
+	NODE_ARG_OPT_STR(first, "byte order", order);
 	if (order == "MSB") {
 		byte_order = wkbXDR;
 	} else if (order == "LSB") {
@@ -295,34 +329,117 @@ Handle<Value> Geometry::exportToWKB(const Arguments& args)
 
 	#if GDAL_VERSION_MAJOR > 1 || (GDAL_VERSION_MINOR > 10)
 	//wkb variant
-	OGRwkbVariant wkb_variant;
 	std::string variant = "OGC";
-	NODE_ARG_OPT_STR(1, "wkb variant", variant);
+	NODE_ARG_OPT_STR(first + 1, "wkb variant", variant);
 	if (variant == "OGC") {
 		wkb_variant = wkbVariantOgc;
-	} else if (order == "ISO") {
+	} else if (variant == "ISO") {
 		wkb_variant = wkbVariantIso;
 	} else {
-		return NODE_THROW("byte order must be 'OGC' or 'ISO'");
+		return NODE_THROW("wkb variant must be 'OGC' or 'ISO'");
 	}
-	OGRErr err = geom->this_->exportToWkb(byte_order, data, wkb_variant);
 	#else
-	OGRErr err = geom->this_->exportToWkb(byte_order, data);
+	wkb_variant = 0;
 	#endif
 
-	//^^ export to wkb and fill buffer ^^
-	//TODO: avoid extra memcpy in FastBuffer::New and have exportToWkb write directly into buffer
+	return Handle<Value>();
+}
+
+static OGRErr exportWkb(OGRGeometry *geom, OGRwkbByteOrder byte_order, OGRwkbVariant wkb_variant, unsigned char *data)
+{
+	#if GDAL_VERSION_MAJOR > 1 || (GDAL_VERSION_MINOR > 10)
+	return geom->exportToWkb(byte_order, data, wkb_variant);
+	#else
+	return geom->exportToWkb(byte_order, data);
+	#endif
+}
 
+Handle<Value> Geometry::exportToWKB(const Arguments& args)
+{
+	HandleScope scope;
+
+	Geometry *geom = ObjectWrap::Unwrap<Geometry>(args.This());
+
+	OGRwkbByteOrder byte_order;
+	OGRwkbVariant wkb_variant;
+	Handle<Value> err_value = parseWkbArgs(args, 0, byte_order, wkb_variant);
+	if (!err_value.IsEmpty()) {
+		return err_value;
+	}
+
+	//export straight into the memory of the Buffer
+	unsigned char *data;
+	int size = geom->this_->WkbSize();
+	Handle<Value> result = FastBuffer::New(size, &data);
+
+	OGRErr err = exportWkb(geom->this_, byte_order, wkb_variant, data);
 	if (err) {
-		free(data);
 		return NODE_THROW_OGRERR(err);
 	}
 
-	Handle<Value> result = FastBuffer::New(data, size);
-	free(data);
-
 	return scope.Close(result);
+}
+
+Handle<Value> Geometry::exportToWKBMany(const Arguments& args)
+{
+	HandleScope scope;
 
+	OGRwkbByteOrder byte_order;
+	OGRwkbVariant wkb_variant;
+	Handle<Value> err_value = parseWkbArgs(args, 1, byte_order, wkb_variant);
+	if (!err_value.IsEmpty()) {
+		return err_value;
+	}
+
+	//null / undefined entries are written as empty ranges
+	std::vector<OGRGeometry*> items;
+	if (args.Length() > 0 && IS_WRAPPED(args[0], GeometryArray)) {
+		items = ObjectWrap::Unwrap<GeometryArray>(args[0]->ToObject())->get();
+	} else {
+		Handle<Array> geoms;
+		NODE_ARG_ARRAY(0, "geometries", geoms);
+		items.resize(geoms->Length(), (OGRGeometry*) NULL);
+		for (unsigned int i = 0; i < items.size(); i++) {
+			Handle<Value> element = geoms->Get(i);
+			if (IS_WRAPPED(element, Geometry)) {
+				items[i] = ObjectWrap::Unwrap<Geometry>(element->ToObject())->get();
+			} else if (!element->IsNull() && !element->IsUndefined()) {
+				return NODE_THROW("All array elements must be geometries, null or undefined");
+			}
+		}
+	}
+
+	unsigned int n = items.size();
+	Handle<Value> offsets = TypedArray::New(GDT_UInt32, n + 1);
+	if (offsets.IsEmpty() || !offsets->IsObject()) {
+		return offsets; //TypedArray::New threw an error
+	}
+	unsigned int *offset_data = static_cast<unsigned int*>(TypedArray::Data(offsets->ToObject()));
+
+	size_t size = 0;
+	offset_data[0] = 0;
+	for (unsigned int i = 0; i < n; i++) {
+		if (items[i]) size += items[i]->WkbSize();
+		if (size > 0x7FFFFFFF) {
+			return NODE_THROW("Geometries are too large for one Buffer");
+		}
+		offset_data[i + 1] = size;
+	}
+
+	unsigned char *data;
+	Handle<Value> buffer = FastBuffer::New((int) size, &data);
+	for (unsigned int i = 0; i < n; i++) {
+		if (!items[i]) continue;
+		OGRErr err = exportWkb(items[i], byte_order, wkb_variant, data + offset_data[i]);
+		if (err) {
+			return NODE_THROW_OGRERR(err);
+		}
+	}
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("wkb"), buffer);
+	result->Set(String::NewSymbol("offsets"), offsets);
+	return scope.Close(result);
 }
 
 Handle<Value> Geometry::exportToKML(const Arguments& args)
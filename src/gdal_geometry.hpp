@@ -38,6 +38,7 @@ public:
 	static Handle<Value> exportToJSON(const Arguments &args);
 	static Handle<Value> exportToWKT(const Arguments &args);
 	static Handle<Value> exportToWKB(const Arguments &args);
+	static Handle<Value> exportToWKBMany(const Arguments &args);
 	static Handle<Value> closeRings(const Arguments &args);
 	static Handle<Value> segmentize(const Arguments &args);
 	static Handle<Value> intersects(const Arguments &args);
@@ -61,6 +62,7 @@ public:
 	static Handle<Value> simplifyPreserveTopology(const Arguments &args);
 	static Handle<Value> polygonize(const Arguments &args);
 	static Handle<Value> swapXY(const Arguments &args);
+	static Handle<Value> prepare(const Arguments &args);
 	static Handle<Value> getNumGeometries(const Arguments &args);
 	static Handle<Value> getEnvelope(const Arguments &args);
 	static Handle<Value> getEnvelope3D(const Arguments &args);
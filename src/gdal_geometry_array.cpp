@@ -0,0 +1,446 @@
+#include "gdal_common.hpp"
+#include "gdal_geometry.hpp"
+#include "gdal_geometry_array.hpp"
+#include "gdal_spatial_reference.hpp"
+#include "gdal_coordinate_transformation.hpp"
+#include "gdal_layer.hpp"
+#include "gdal_dataset.hpp"
+#include "typed_array.hpp"
+
+#include <node_buffer.h>
+#include <limits>
+#include <sstream>
+
+namespace node_gdal {
+
+enum {
+	PREDICATE_INTERSECTS,
+	PREDICATE_EQUALS,
+	PREDICATE_DISJOINT,
+	PREDICATE_TOUCHES,
+	PREDICATE_CROSSES,
+	PREDICATE_WITHIN,
+	PREDICATE_CONTAINS,
+	PREDICATE_OVERLAPS
+};
+
+Persistent<FunctionTemplate> GeometryArray::constructor;
+
+void GeometryArray::Initialize(Handle<Object> target)
+{
+	HandleScope scope;
+
+	constructor = Persistent<FunctionTemplate>::New(FunctionTemplate::New(GeometryArray::New));
+	constructor->InstanceTemplate()->SetInternalFieldCount(1);
+	constructor->SetClassName(String::NewSymbol("GeometryArray"));
+
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toString", toString);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "count", count);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "get", get);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "getEnvelopes", getEnvelopes);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "buffer", buffer);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "transform", transform);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "transformTo", transformTo);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "intersects", intersects);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "equals", equals);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "disjoint", disjoint);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "touches", touches);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "crosses", crosses);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "within", within);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "contains", contains);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "overlaps", overlaps);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "writeTo", writeTo);
+
+	target->Set(String::NewSymbol("GeometryArray"), constructor->GetFunction());
+}
+
+GeometryArray::GeometryArray(std::vector<OGRGeometry*> &geoms)
+	: ObjectWrap(),
+	  size_(0)
+{
+	geoms_.swap(geoms);
+	for (unsigned int i = 0; i < geoms_.size(); i++) {
+		if (geoms_[i]) size_ += geoms_[i]->WkbSize();
+	}
+	V8::AdjustAmountOfExternalAllocatedMemory(size_);
+	LOG("Created GeometryArray [%d geometries]", (int) geoms_.size());
+}
+
+GeometryArray::GeometryArray()
+	: ObjectWrap(),
+	  size_(0)
+{
+}
+
+GeometryArray::~GeometryArray()
+{
+	LOG("Disposing GeometryArray [%d geometries]", (int) geoms_.size());
+	for (unsigned int i = 0; i < geoms_.size(); i++) {
+		if (geoms_[i]) OGRGeometryFactory::destroyGeometry(geoms_[i]);
+	}
+	geoms_.clear();
+	V8::AdjustAmountOfExternalAllocatedMemory(-size_);
+}
+
+Handle<Value> GeometryArray::New(const Arguments& args)
+{
+	HandleScope scope;
+
+	if (!args.IsConstructCall()) {
+		return NODE_THROW("Cannot call constructor as function, you need to use 'new' keyword");
+	}
+
+	if (args[0]->IsExternal()) {
+		Local<External> ext = Local<External>::Cast(args[0]);
+		void* ptr = ext->Value();
+		GeometryArray *f = static_cast<GeometryArray *>(ptr);
+		f->Wrap(args.This());
+		return args.This();
+	} else {
+		return NODE_THROW("Cannot create GeometryArray directly, use Geometry.fromWKBMany() or Geometry.fromWKTMany()");
+	}
+}
+
+//takes ownership of the geometries, geoms is left empty
+Handle<Value> GeometryArray::New(std::vector<OGRGeometry*> &geoms)
+{
+	HandleScope scope;
+
+	GeometryArray *wrapped = new GeometryArray(geoms);
+
+	v8::Handle<v8::Value> ext = v8::External::New(wrapped);
+	v8::Handle<v8::Object> obj = GeometryArray::constructor->GetFunction()->NewInstance(1, &ext);
+
+	return scope.Close(obj);
+}
+
+Handle<Value> GeometryArray::toString(const Arguments& args)
+{
+	HandleScope scope;
+	return scope.Close(String::New("GeometryArray"));
+}
+
+static void destroyGeometries(std::vector<OGRGeometry*> &geoms)
+{
+	for (unsigned int i = 0; i < geoms.size(); i++) {
+		if (geoms[i]) OGRGeometryFactory::destroyGeometry(geoms[i]);
+	}
+	geoms.clear();
+}
+
+Handle<Value> GeometryArray::fromWKBMany(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> wkb_obj;
+	Handle<Object> offsets_obj;
+	SpatialReference *srs = NULL;
+	NODE_ARG_OBJECT(0, "wkb", wkb_obj);
+	NODE_ARG_OBJECT(1, "offsets", offsets_obj);
+	NODE_ARG_WRAPPED_OPT(2, "srs", SpatialReference, srs);
+
+	if (!Buffer::HasInstance(wkb_obj)) {
+		return NODE_THROW("wkb must be a Buffer");
+	}
+	if (TypedArray::Identify(offsets_obj) != GDT_UInt32 || TypedArray::Length(offsets_obj) < 1) {
+		return NODE_THROW("offsets must be a Uint32Array");
+	}
+
+	unsigned char *wkb = (unsigned char*) Buffer::Data(wkb_obj);
+	size_t wkb_length = Buffer::Length(wkb_obj);
+	unsigned int *offsets = static_cast<unsigned int*>(TypedArray::Data(offsets_obj));
+	int n = TypedArray::Length(offsets_obj) - 1;
+
+	OGRSpatialReference *ogr_srs = srs ? srs->get() : NULL;
+
+	//empty ranges are kept as NULL entries
+	std::vector<OGRGeometry*> geoms(n, (OGRGeometry*) NULL);
+	for (int i = 0; i < n; i++) {
+		if (offsets[i] > offsets[i + 1] || offsets[i + 1] > wkb_length) {
+			destroyGeometries(geoms);
+			return NODE_THROW("offsets are out of range");
+		}
+		if (offsets[i + 1] == offsets[i]) continue;
+
+		OGRErr err = OGRGeometryFactory::createFromWkb(wkb + offsets[i], ogr_srs, &geoms[i], offsets[i + 1] - offsets[i]);
+		if (err) {
+			destroyGeometries(geoms);
+			std::ostringstream msg;
+			msg << "Error parsing geometry " << i << ": " << getOGRErrMsg(err);
+			return NODE_THROW(msg.str().c_str());
+		}
+	}
+
+	return scope.Close(GeometryArray::New(geoms));
+}
+
+Handle<Value> GeometryArray::fromWKTMany(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Array> wkts;
+	SpatialReference *srs = NULL;
+	NODE_ARG_ARRAY(0, "wkt", wkts);
+	NODE_ARG_WRAPPED_OPT(1, "srs", SpatialReference, srs);
+
+	OGRSpatialReference *ogr_srs = srs ? srs->get() : NULL;
+
+	//null / undefined entries are kept as NULL entries
+	int n = wkts->Length();
+	std::vector<OGRGeometry*> geoms(n, (OGRGeometry*) NULL);
+	for (int i = 0; i < n; i++) {
+		Handle<Value> element = wkts->Get(i);
+		if (element->IsNull() || element->IsUndefined()) continue;
+		if (!element->IsString()) {
+			destroyGeometries(geoms);
+			return NODE_THROW("All array elements must be strings, null or undefined");
+		}
+
+		std::string wkt = *String::Utf8Value(element);
+		char *wkt_c = (char*) wkt.c_str();
+		OGRErr err = OGRGeometryFactory::createFromWkt(&wkt_c, ogr_srs, &geoms[i]);
+		if (err) {
+			destroyGeometries(geoms);
+			std::ostringstream msg;
+			msg << "Error parsing geometry " << i << ": " << getOGRErrMsg(err);
+			return NODE_THROW(msg.str().c_str());
+		}
+	}
+
+	return scope.Close(GeometryArray::New(geoms));
+}
+
+Handle<Value> GeometryArray::count(const Arguments& args)
+{
+	HandleScope scope;
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+
+	return scope.Close(Integer::New(array->geoms_.size()));
+}
+
+Handle<Value> GeometryArray::get(const Arguments& args)
+{
+	HandleScope scope;
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+
+	int i;
+	NODE_ARG_INT(0, "index", i);
+	if (i < 0 || i >= (int) array->geoms_.size()) {
+		return NODE_THROW("Invalid index");
+	}
+	if (!array->geoms_[i]) {
+		return scope.Close(Null());
+	}
+
+	//a copy, so the array stays valid whatever happens to the wrapper
+	return scope.Close(Geometry::New(array->geoms_[i]->clone(), true));
+}
+
+Handle<Value> GeometryArray::getEnvelopes(const Arguments& args)
+{
+	HandleScope scope;
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+	int n = array->geoms_.size();
+
+	//[minX, minY, maxX, maxY] per geometry, NaN for NULL / empty entries
+	Handle<Value> result = TypedArray::New(GDT_Float64, n * 4);
+	if (result.IsEmpty() || !result->IsObject()) {
+		return scope.Close(result); //TypedArray::New threw an error
+	}
+	double *data = static_cast<double*>(TypedArray::Data(result->ToObject()));
+	for (int i = 0; i < n; i++) {
+		OGRGeometry *geom = array->geoms_[i];
+		if (!geom || geom->IsEmpty()) {
+			data[i * 4] = data[i * 4 + 1] = data[i * 4 + 2] = data[i * 4 + 3] = std::numeric_limits<double>::quiet_NaN();
+			continue;
+		}
+		OGREnvelope envelope;
+		geom->getEnvelope(&envelope);
+		data[i * 4]     = envelope.MinX;
+		data[i * 4 + 1] = envelope.MinY;
+		data[i * 4 + 2] = envelope.MaxX;
+		data[i * 4 + 3] = envelope.MaxY;
+	}
+
+	return scope.Close(result);
+}
+
+Handle<Value> GeometryArray::buffer(const Arguments& args)
+{
+	HandleScope scope;
+
+	double distance;
+	int number_of_segments = 30;
+
+	NODE_ARG_DOUBLE(0, "distance", distance);
+	NODE_ARG_INT_OPT(1, "number of segments", number_of_segments);
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+	int n = array->geoms_.size();
+
+	std::vector<OGRGeometry*> result(n, (OGRGeometry*) NULL);
+	for (int i = 0; i < n; i++) {
+		if (array->geoms_[i]) result[i] = array->geoms_[i]->Buffer(distance, number_of_segments);
+	}
+
+	return scope.Close(GeometryArray::New(result));
+}
+
+Handle<Value> GeometryArray::transform(const Arguments& args)
+{
+	HandleScope scope;
+
+	CoordinateTransformation *ct;
+	NODE_ARG_WRAPPED(0, "transform", CoordinateTransformation, ct);
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+
+	ct->lock();
+	for (unsigned int i = 0; i < array->geoms_.size(); i++) {
+		if (!array->geoms_[i]) continue;
+		OGRErr err = array->geoms_[i]->transform(ct->get());
+		if (err) {
+			ct->unlock();
+			return NODE_THROW_OGRERR(err);
+		}
+	}
+	ct->unlock();
+
+	return Undefined();
+}
+
+Handle<Value> GeometryArray::transformTo(const Arguments& args)
+{
+	HandleScope scope;
+
+	SpatialReference *srs;
+	NODE_ARG_WRAPPED(0, "spatial reference", SpatialReference, srs);
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+
+	//geometries without a spatial reference can't be transformed, like Geometry#transformTo()
+	OGRCoordinateTransformation *ct = NULL;
+	OGRSpatialReference *ct_source = NULL;
+	for (unsigned int i = 0; i < array->geoms_.size(); i++) {
+		OGRGeometry *geom = array->geoms_[i];
+		if (!geom) continue;
+
+		OGRSpatialReference *source = geom->getSpatialReference();
+		if (!source) {
+			if (ct) OGRCoordinateTransformation::DestroyCT(ct);
+			return NODE_THROW_OGRERR(OGRERR_FAILURE);
+		}
+
+		//geometries parsed together share their spatial reference, so this is usually created once
+		if (!ct || (source != ct_source && !source->IsSame(ct_source))) {
+			if (ct) OGRCoordinateTransformation::DestroyCT(ct);
+			ct = OGRCreateCoordinateTransformation(source, srs->get());
+			ct_source = source;
+			if (!ct) {
+				return NODE_THROW_LAST_CPLERR();
+			}
+		}
+
+		OGRErr err = geom->transform(ct);
+		if (err) {
+			OGRCoordinateTransformation::DestroyCT(ct);
+			return NODE_THROW_OGRERR(err);
+		}
+	}
+	if (ct) OGRCoordinateTransformation::DestroyCT(ct);
+
+	return Undefined();
+}
+
+//tests every geometry against one other geometry, NULL entries give 0
+Handle<Value> GeometryArray::predicate(const Arguments& args, int op)
+{
+	HandleScope scope;
+
+	Geometry *other;
+	NODE_ARG_WRAPPED(0, "geometry", Geometry, other);
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+	int n = array->geoms_.size();
+
+	Handle<Value> result = TypedArray::New(GDT_Byte, n);
+	if (result.IsEmpty() || !result->IsObject()) {
+		return scope.Close(result); //TypedArray::New threw an error
+	}
+	unsigned char *data = static_cast<unsigned char*>(TypedArray::Data(result->ToObject()));
+
+	OGRGeometry *b = other->get();
+	for (int i = 0; i < n; i++) {
+		OGRGeometry *a = array->geoms_[i];
+		if (!a) {
+			data[i] = 0;
+			continue;
+		}
+		switch (op) {
+			case PREDICATE_INTERSECTS: data[i] = a->Intersects(b) ? 1 : 0; break;
+			case PREDICATE_EQUALS:     data[i] = a->Equals(b) ? 1 : 0;     break;
+			case PREDICATE_DISJOINT:   data[i] = a->Disjoint(b) ? 1 : 0;   break;
+			case PREDICATE_TOUCHES:    data[i] = a->Touches(b) ? 1 : 0;    break;
+			case PREDICATE_CROSSES:    data[i] = a->Crosses(b) ? 1 : 0;    break;
+			case PREDICATE_WITHIN:     data[i] = a->Within(b) ? 1 : 0;     break;
+			case PREDICATE_CONTAINS:   data[i] = a->Contains(b) ? 1 : 0;   break;
+			default:                   data[i] = a->Overlaps(b) ? 1 : 0;   break;
+		}
+	}
+
+	return scope.Close(result);
+}
+
+Handle<Value> GeometryArray::intersects(const Arguments& args) { return predicate(args, PREDICATE_INTERSECTS); }
+Handle<Value> GeometryArray::equals(const Arguments& args)     { return predicate(args, PREDICATE_EQUALS); }
+Handle<Value> GeometryArray::disjoint(const Arguments& args)   { return predicate(args, PREDICATE_DISJOINT); }
+Handle<Value> GeometryArray::touches(const Arguments& args)    { return predicate(args, PREDICATE_TOUCHES); }
+Handle<Value> GeometryArray::crosses(const Arguments& args)    { return predicate(args, PREDICATE_CROSSES); }
+Handle<Value> GeometryArray::within(const Arguments& args)     { return predicate(args, PREDICATE_WITHIN); }
+Handle<Value> GeometryArray::contains(const Arguments& args)   { return predicate(args, PREDICATE_CONTAINS); }
+Handle<Value> GeometryArray::overlaps(const Arguments& args)   { return predicate(args, PREDICATE_OVERLAPS); }
+
+//creates a feature per geometry (including NULL ones) and returns their FIDs
+Handle<Value> GeometryArray::writeTo(const Arguments& args)
+{
+	HandleScope scope;
+
+	Layer *layer;
+	NODE_ARG_WRAPPED(0, "layer", Layer, layer);
+	if (!layer->get()) {
+		return NODE_THROW("Layer object already destroyed");
+	}
+
+	DatasetLock lock(Layer::parentDataset(args[0]->ToObject()));
+
+	GeometryArray *array = ObjectWrap::Unwrap<GeometryArray>(args.This());
+	int n = array->geoms_.size();
+
+	Handle<Value> fids = TypedArray::New(GDT_Float64, n);
+	if (fids.IsEmpty() || !fids->IsObject()) {
+		return scope.Close(fids); //TypedArray::New threw an error
+	}
+	double *fid_data = static_cast<double*>(TypedArray::Data(fids->ToObject()));
+
+	OGRLayer *ogr_layer = layer->get();
+	OGRFeature *feature = new OGRFeature(ogr_layer->GetLayerDefn());
+	for (int i = 0; i < n; i++) {
+		feature->SetFID(OGRNullFID);
+		//SetGeometry() copies, so the array keeps its geometries
+		feature->SetGeometry(array->geoms_[i]);
+		OGRErr err = ogr_layer->CreateFeature(feature);
+		if (err) {
+			delete feature;
+			return NODE_THROW_OGRERR(err);
+		}
+		fid_data[i] = (double) feature->GetFID();
+	}
+	delete feature;
+
+	return scope.Close(fids);
+}
+
+} // namespace node_gdal
@@ -0,0 +1,67 @@
+#ifndef __NODE_OGR_GEOMETRY_ARRAY_H__
+#define __NODE_OGR_GEOMETRY_ARRAY_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// ogr
+#include <ogrsf_frmts.h>
+
+// std
+#include <vector>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// A list of geometries that stay native: created in bulk from WKB / WKT and
+// handed to native operations without a JS wrapper per geometry.
+// Entries can be NULL (empty WKB range).
+
+class GeometryArray: public node::ObjectWrap {
+public:
+	static Persistent<FunctionTemplate> constructor;
+	static void Initialize(Handle<Object> target);
+	static Handle<Value> New(const Arguments &args);
+	static Handle<Value> New(std::vector<OGRGeometry*> &geoms);
+	static Handle<Value> toString(const Arguments &args);
+
+	static Handle<Value> fromWKBMany(const Arguments &args);
+	static Handle<Value> fromWKTMany(const Arguments &args);
+
+	static Handle<Value> count(const Arguments &args);
+	static Handle<Value> get(const Arguments &args);
+	static Handle<Value> getEnvelopes(const Arguments &args);
+	static Handle<Value> buffer(const Arguments &args);
+	static Handle<Value> transform(const Arguments &args);
+	static Handle<Value> transformTo(const Arguments &args);
+	static Handle<Value> intersects(const Arguments &args);
+	static Handle<Value> equals(const Arguments &args);
+	static Handle<Value> disjoint(const Arguments &args);
+	static Handle<Value> touches(const Arguments &args);
+	static Handle<Value> crosses(const Arguments &args);
+	static Handle<Value> within(const Arguments &args);
+	static Handle<Value> contains(const Arguments &args);
+	static Handle<Value> overlaps(const Arguments &args);
+	static Handle<Value> writeTo(const Arguments &args);
+
+	GeometryArray();
+	GeometryArray(std::vector<OGRGeometry*> &geoms);
+	inline std::vector<OGRGeometry*> &get() {
+		return geoms_;
+	}
+
+private:
+	~GeometryArray();
+	static Handle<Value> predicate(const Arguments &args, int op);
+	std::vector<OGRGeometry*> geoms_;
+	int size_;
+};
+
+}
+#endif
@@ -134,8 +134,9 @@ Handle<Value> Layer::New(OGRLayer *raw, OGRDataSource *raw_parent, bool result_s
 	if (!raw) {
 		return v8::Null();
 	}
-	if (cache.has(raw)) {
-		return cache.get(raw);
+	Handle<Object> cached = cache.find(raw);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	Layer *wrapped = new Layer(raw);
@@ -150,15 +151,11 @@ Handle<Value> Layer::New(OGRLayer *raw, OGRDataSource *raw_parent, bool result_s
 	if (raw_parent) {
 		Handle<Value> ds;
 		#if GDAL_VERSION_MAJOR >= 2
-			if (Dataset::dataset_cache.has(raw_parent)) {
-				ds = Dataset::dataset_cache.get(raw_parent);
-			}
+			ds = Dataset::dataset_cache.find(raw_parent);
 		#else
-			if (Dataset::datasource_cache.has(raw_parent)) {
-				ds = Dataset::datasource_cache.get(raw_parent);
-			}
+			ds = Dataset::datasource_cache.find(raw_parent);
 		#endif
-		else {
+		if (ds.IsEmpty()) {
 			LOG("Layer's parent dataset disappeared from cache (layer = %p, dataset = %p)", raw, raw_parent);
 			return NODE_THROW("Layer's parent dataset disappeared from cache");
 			//ds = Dataset::New(raw_parent); //should never happen
@@ -171,6 +168,15 @@ Handle<Value> Layer::New(OGRLayer *raw, OGRDataSource *raw_parent, bool result_s
 	return scope.Close(obj);
 }
 
+Dataset *Layer::parentDataset(Handle<Object> layer_obj)
+{
+	Handle<Value> ds_obj = layer_obj->GetHiddenValue(String::NewSymbol("ds_"));
+	if (ds_obj.IsEmpty() || !ds_obj->IsObject()) {
+		return NULL;
+	}
+	return ObjectWrap::Unwrap<Dataset>(ds_obj->ToObject());
+}
+
 Handle<Value> Layer::toString(const Arguments& args)
 {
 	HandleScope scope;
@@ -186,8 +192,39 @@ Handle<Value> Layer::toString(const Arguments& args)
 	return scope.Close(SafeString::New(ss.str().c_str()));
 }
 
-NODE_WRAPPED_METHOD_WITH_OGRERR_RESULT(Layer, syncToDisk, SyncToDisk);
-NODE_WRAPPED_METHOD_WITH_RESULT_1_STRING_PARAM(Layer, testCapability, Boolean, TestCapability, "capability");
+Handle<Value> Layer::syncToDisk(const Arguments& args)
+{
+	HandleScope scope;
+
+	Layer *layer = ObjectWrap::Unwrap<Layer>(args.This());
+	if (!layer->this_) {
+		return NODE_THROW("Layer object has already been destroyed");
+	}
+
+	DatasetLock lock(Layer::parentDataset(args.This()));
+
+	int err = layer->this_->SyncToDisk();
+	if (err) return NODE_THROW_OGRERR(err);
+
+	return Undefined();
+}
+
+Handle<Value> Layer::testCapability(const Arguments& args)
+{
+	HandleScope scope;
+
+	std::string capability;
+	NODE_ARG_STR(0, "capability", capability);
+
+	Layer *layer = ObjectWrap::Unwrap<Layer>(args.This());
+	if (!layer->this_) {
+		return NODE_THROW("Layer object has already been destroyed");
+	}
+
+	DatasetLock lock(Layer::parentDataset(args.This()));
+
+	return scope.Close(Boolean::New(layer->this_->TestCapability(capability.c_str())));
+}
 
 Handle<Value> Layer::getExtent(const Arguments& args)
 {
@@ -198,6 +235,8 @@ Handle<Value> Layer::getExtent(const Arguments& args)
 		return NODE_THROW("Layer object has already been destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(args.This()));
+
 	int force = 1;
 	NODE_ARG_BOOL_OPT(0, "force", force);
 
@@ -227,6 +266,8 @@ Handle<Value> Layer::getSpatialFilter(const Arguments& args)
 		return NODE_THROW("Layer object has already been destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(args.This()));
+
 	return scope.Close(Geometry::New(layer->this_->GetSpatialFilter(), false));
 }
 
@@ -239,6 +280,8 @@ Handle<Value> Layer::setSpatialFilter(const Arguments& args)
 		return NODE_THROW("Layer object has already been destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(args.This()));
+
 	if(args.Length() == 1) {
 		Geometry *filter = NULL;
 		NODE_ARG_WRAPPED_OPT(0, "filter", Geometry, filter);
@@ -272,6 +315,8 @@ Handle<Value> Layer::setAttributeFilter(const Arguments& args)
 		return NODE_THROW("Layer object has already been destroyed");
 	}
 
+	DatasetLock lock(Layer::parentDataset(args.This()));
+
 	std::string filter = "";
 	NODE_ARG_OPT_STR(0, "filter", filter);
 
@@ -313,6 +358,9 @@ Handle<Value> Layer::srsGetter(Local<String> property, const AccessorInfo &info)
 	if (!layer->this_) {
 		return NODE_THROW("Layer object has already been destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(info.This()));
+
 	return scope.Close(SpatialReference::New(layer->this_->GetSpatialRef(), false));
 }
 
@@ -323,6 +371,9 @@ Handle<Value> Layer::nameGetter(Local<String> property, const AccessorInfo &info
 	if (!layer->this_) {
 		return NODE_THROW("Layer object has already been destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(info.This()));
+
 	return scope.Close(SafeString::New(layer->this_->GetName()));
 }
 
@@ -333,6 +384,9 @@ Handle<Value> Layer::geomColumnGetter(Local<String> property, const AccessorInfo
 	if (!layer->this_) {
 		return NODE_THROW("Layer object has already been destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(info.This()));
+
 	return scope.Close(SafeString::New(layer->this_->GetGeometryColumn()));
 }
 
@@ -343,6 +397,9 @@ Handle<Value> Layer::fidColumnGetter(Local<String> property, const AccessorInfo
 	if (!layer->this_) {
 		return NODE_THROW("Layer object has already been destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(info.This()));
+
 	return scope.Close(SafeString::New(layer->this_->GetFIDColumn()));
 }
 
@@ -353,6 +410,9 @@ Handle<Value> Layer::geomTypeGetter(Local<String> property, const AccessorInfo &
 	if (!layer->this_) {
 		return NODE_THROW("Layer object has already been destroyed");
 	}
+
+	DatasetLock lock(Layer::parentDataset(info.This()));
+
 	return scope.Close(Integer::New(layer->this_->GetGeomType()));
 }
 
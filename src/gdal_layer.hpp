@@ -67,6 +67,9 @@ public:
 	#endif
 	void dispose();
 
+	//wrapper of the dataset owning the layer (used to serialize access with async workers)
+	static Dataset *parentDataset(Handle<Object> layer_obj);
+
 private:
 	~Layer();
 	OGRLayer *this_;
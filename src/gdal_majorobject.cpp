@@ -1,6 +1,7 @@
 #include "gdal_common.hpp"
 #include "gdal_majorobject.hpp"
 #include "gdal_driver.hpp"
+#include "gdal_dataset.hpp"
 
 #include <stdlib.h>
 
@@ -75,6 +76,8 @@ Handle<Value> MajorObject::getMetadata(const Arguments& args)
 		return NODE_THROW("MajorObject object has already been destroyed");
 	}
 
+	DatasetLock lock(Dataset::owner(args.This()));
+
 	return scope.Close(getMetadata(obj->this_, domain.empty() ? NULL : domain.c_str()));
 }
 
@@ -112,6 +115,8 @@ Handle<Value> MajorObject::descriptionGetter(Local<String> property, const Acces
 		return NODE_THROW("MajorObject object has already been destroyed");
 	}
 
+	DatasetLock lock(Dataset::owner(info.This()));
+
 	return scope.Close(SafeString::New(obj->this_->GetDescription()));
 }
 
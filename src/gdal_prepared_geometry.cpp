@@ -0,0 +1,252 @@
+#include "gdal_common.hpp"
+#include "gdal_geometry.hpp"
+#include "gdal_geometry_array.hpp"
+#include "gdal_prepared_geometry.hpp"
+#include "typed_array.hpp"
+
+#include <sstream>
+
+namespace node_gdal {
+
+Persistent<FunctionTemplate> PreparedGeometry::constructor;
+
+void PreparedGeometry::Initialize(Handle<Object> target)
+{
+	HandleScope scope;
+
+	constructor = Persistent<FunctionTemplate>::New(FunctionTemplate::New(PreparedGeometry::New));
+	constructor->InstanceTemplate()->SetInternalFieldCount(1);
+	constructor->SetClassName(String::NewSymbol("PreparedGeometry"));
+
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toString", toString);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "intersects", intersects);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "contains", contains);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "containsProperly", containsProperly);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "covers", covers);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "within", within);
+
+	target->Set(String::NewSymbol("PreparedGeometry"), constructor->GetFunction());
+}
+
+PreparedGeometry::PreparedGeometry()
+	: ObjectWrap()
+#ifdef HAVE_GEOS
+	, context_(NULL),
+	  geom_(NULL),
+	  prepared_(NULL)
+#endif
+{
+}
+
+PreparedGeometry::~PreparedGeometry()
+{
+#ifdef HAVE_GEOS
+	LOG("Disposing PreparedGeometry [%p]", prepared_);
+	if (prepared_) GEOSPreparedGeom_destroy_r(context_, prepared_);
+	if (geom_) GEOSGeom_destroy_r(context_, geom_);
+	if (context_) OGRGeometry::freeGEOSContext(context_);
+	prepared_ = NULL;
+	geom_ = NULL;
+	context_ = NULL;
+#endif
+}
+
+Handle<Value> PreparedGeometry::New(const Arguments& args)
+{
+	HandleScope scope;
+
+	if (!args.IsConstructCall()) {
+		return NODE_THROW("Cannot call constructor as function, you need to use 'new' keyword");
+	}
+
+	if (args[0]->IsExternal()) {
+		Local<External> ext = Local<External>::Cast(args[0]);
+		void* ptr = ext->Value();
+		PreparedGeometry *f = static_cast<PreparedGeometry *>(ptr);
+		f->Wrap(args.This());
+		return args.This();
+	} else {
+		return NODE_THROW("Cannot create PreparedGeometry directly, use geometry.prepare()");
+	}
+}
+
+Handle<Value> PreparedGeometry::New(OGRGeometry *geom)
+{
+	HandleScope scope;
+
+#ifdef HAVE_GEOS
+	PreparedGeometry *wrapped = new PreparedGeometry();
+
+	//OGR's context sends GEOS errors through CPLError()
+	CPLErrorReset();
+	wrapped->context_ = OGRGeometry::createGEOSContext();
+	wrapped->geom_ = geom->exportToGEOS(wrapped->context_);
+	if (wrapped->geom_) {
+		wrapped->prepared_ = GEOSPrepare_r(wrapped->context_, wrapped->geom_);
+	}
+	if (!wrapped->prepared_) {
+		delete wrapped;
+		const char *msg = CPLGetLastErrorMsg();
+		return NODE_THROW(msg[0] ? msg : "Error preparing geometry");
+	}
+	geom->getEnvelope(&wrapped->envelope_);
+
+	v8::Handle<v8::Value> ext = v8::External::New(wrapped);
+	v8::Handle<v8::Object> obj = PreparedGeometry::constructor->GetFunction()->NewInstance(1, &ext);
+
+	return scope.Close(obj);
+#else
+	return NODE_THROW("GEOS support not available, prepared geometries require the bundled GDAL");
+#endif
+}
+
+Handle<Value> PreparedGeometry::toString(const Arguments& args)
+{
+	HandleScope scope;
+	return scope.Close(String::New("PreparedGeometry"));
+}
+
+#ifdef HAVE_GEOS
+
+//returns 0, 1, or 2 on a GEOS exception
+char PreparedGeometry::evaluate(int op, const GEOSGeometry *other)
+{
+	switch (op) {
+		case INTERSECTS:        return GEOSPreparedIntersects_r(context_, prepared_, other);
+		case CONTAINS:          return GEOSPreparedContains_r(context_, prepared_, other);
+		case CONTAINS_PROPERLY: return GEOSPreparedContainsProperly_r(context_, prepared_, other);
+		case COVERS:            return GEOSPreparedCovers_r(context_, prepared_, other);
+		default:                return GEOSPreparedWithin_r(context_, prepared_, other);
+	}
+}
+
+char PreparedGeometry::evaluate(int op, OGRGeometry *other)
+{
+	GEOSGeometry *geos_other = other->exportToGEOS(context_);
+	if (!geos_other) return 2;
+
+	char result = evaluate(op, geos_other);
+	GEOSGeom_destroy_r(context_, geos_other);
+	return result;
+}
+
+char PreparedGeometry::evaluatePoint(int op, double x, double y)
+{
+	//a point outside the envelope can't touch the geometry, skip building it
+	if (op != WITHIN && (x < envelope_.MinX || x > envelope_.MaxX || y < envelope_.MinY || y > envelope_.MaxY)) {
+		return 0;
+	}
+
+	GEOSCoordSequence *seq = GEOSCoordSeq_create_r(context_, 1, 2);
+	if (!seq) return 2;
+	GEOSCoordSeq_setX_r(context_, seq, 0, x);
+	GEOSCoordSeq_setY_r(context_, seq, 0, y);
+	GEOSGeometry *point = GEOSGeom_createPoint_r(context_, seq);
+	if (!point) return 2;
+
+	char result = evaluate(op, point);
+	GEOSGeom_destroy_r(context_, point);
+	return result;
+}
+
+#else
+
+char PreparedGeometry::evaluate(int op, OGRGeometry *other)
+{
+	CPLError(CE_Failure, CPLE_NotSupported, "GEOS support not available");
+	return 2;
+}
+
+#endif
+
+//predicate(Geometry) : boolean
+//predicate(Float64Array coords, [int stride = 2]) : Uint8Array
+//predicate(GeometryArray) : Uint8Array
+Handle<Value> PreparedGeometry::predicate(const Arguments& args, int op)
+{
+	HandleScope scope;
+
+#ifdef HAVE_GEOS
+	PreparedGeometry *prepared = ObjectWrap::Unwrap<PreparedGeometry>(args.This());
+
+	if (args.Length() < 1) {
+		return NODE_THROW("geometry, GeometryArray or Float64Array of coordinates must be given");
+	}
+
+	CPLErrorReset();
+
+	if (IS_WRAPPED(args[0], Geometry)) {
+		Geometry *geom = ObjectWrap::Unwrap<Geometry>(args[0]->ToObject());
+		char result = prepared->evaluate(op, geom->get());
+		if (result == 2) {
+			return NODE_THROW_LAST_CPLERR();
+		}
+		return scope.Close(Boolean::New(result == 1));
+	}
+
+	if (IS_WRAPPED(args[0], GeometryArray)) {
+		std::vector<OGRGeometry*> &geoms = ObjectWrap::Unwrap<GeometryArray>(args[0]->ToObject())->get();
+		int n = geoms.size();
+
+		Handle<Value> result = TypedArray::New(GDT_Byte, n);
+		if (result.IsEmpty() || !result->IsObject()) {
+			return scope.Close(result); //TypedArray::New threw an error
+		}
+		unsigned char *data = static_cast<unsigned char*>(TypedArray::Data(result->ToObject()));
+
+		//null entries give 0
+		for (int i = 0; i < n; i++) {
+			data[i] = 0;
+			if (!geoms[i]) continue;
+			char value = prepared->evaluate(op, geoms[i]);
+			if (value == 2) {
+				return NODE_THROW_LAST_CPLERR();
+			}
+			data[i] = value;
+		}
+		return scope.Close(result);
+	}
+
+	if (args[0]->IsObject() && TypedArray::Identify(args[0]->ToObject()) == GDT_Float64) {
+		Handle<Object> coords = args[0]->ToObject();
+		int stride = 2;
+		NODE_ARG_INT_OPT(1, "stride", stride);
+		if (stride < 2) {
+			return NODE_THROW("stride must be at least 2");
+		}
+		int length = TypedArray::Length(coords);
+		if (length % stride) {
+			return NODE_THROW("Coordinate array length must be a multiple of stride");
+		}
+		const double *xy = static_cast<const double*>(TypedArray::Data(coords));
+		int n = length / stride;
+
+		Handle<Value> result = TypedArray::New(GDT_Byte, n);
+		if (result.IsEmpty() || !result->IsObject()) {
+			return scope.Close(result); //TypedArray::New threw an error
+		}
+		unsigned char *data = static_cast<unsigned char*>(TypedArray::Data(result->ToObject()));
+
+		for (int i = 0; i < n; i++) {
+			char value = prepared->evaluatePoint(op, xy[i * stride], xy[i * stride + 1]);
+			if (value == 2) {
+				return NODE_THROW_LAST_CPLERR();
+			}
+			data[i] = value;
+		}
+		return scope.Close(result);
+	}
+
+	return NODE_THROW("geometry, GeometryArray or Float64Array of coordinates expected");
+#else
+	return NODE_THROW("GEOS support not available");
+#endif
+}
+
+Handle<Value> PreparedGeometry::intersects(const Arguments& args)       { return predicate(args, INTERSECTS); }
+Handle<Value> PreparedGeometry::contains(const Arguments& args)         { return predicate(args, CONTAINS); }
+Handle<Value> PreparedGeometry::containsProperly(const Arguments& args) { return predicate(args, CONTAINS_PROPERLY); }
+Handle<Value> PreparedGeometry::covers(const Arguments& args)           { return predicate(args, COVERS); }
+Handle<Value> PreparedGeometry::within(const Arguments& args)           { return predicate(args, WITHIN); }
+
+} // namespace node_gdal
@@ -0,0 +1,69 @@
+#ifndef __NODE_OGR_PREPARED_GEOMETRY_H__
+#define __NODE_OGR_PREPARED_GEOMETRY_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// ogr
+#include <ogrsf_frmts.h>
+
+#ifdef HAVE_GEOS
+// geos
+#include <geos_c.h>
+#endif
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// A geometry converted to GEOS and indexed once (GEOSPrepare), for testing
+// many geometries or points against the same geometry.
+
+class PreparedGeometry: public node::ObjectWrap {
+public:
+	static Persistent<FunctionTemplate> constructor;
+	static void Initialize(Handle<Object> target);
+	static Handle<Value> New(const Arguments &args);
+	static Handle<Value> New(OGRGeometry *geom);
+	static Handle<Value> toString(const Arguments &args);
+
+	static Handle<Value> intersects(const Arguments &args);
+	static Handle<Value> contains(const Arguments &args);
+	static Handle<Value> containsProperly(const Arguments &args);
+	static Handle<Value> covers(const Arguments &args);
+	static Handle<Value> within(const Arguments &args);
+
+	enum {
+		INTERSECTS,
+		CONTAINS,
+		CONTAINS_PROPERLY,
+		COVERS,
+		WITHIN
+	};
+
+	//1 if the predicate holds, 0 if not, 2 on error (see CPLGetLastErrorMsg())
+	char evaluate(int op, OGRGeometry *other);
+
+	PreparedGeometry();
+
+private:
+	~PreparedGeometry();
+	static Handle<Value> predicate(const Arguments &args, int op);
+#ifdef HAVE_GEOS
+	char evaluate(int op, const GEOSGeometry *other);
+	char evaluatePoint(int op, double x, double y);
+
+	GEOSContextHandle_t context_;
+	GEOSGeometry *geom_;
+	const GEOSPreparedGeometry *prepared_;
+	OGREnvelope envelope_;
+#endif
+};
+
+}
+#endif
@@ -6,9 +6,14 @@
 #include "gdal_dataset.hpp"
 #include "collections/rasterband_overviews.hpp"
 #include "collections/rasterband_pixels.hpp"
+#include "async_worker.hpp"
 
+#include <algorithm>
 #include <limits>
+#include <string>
+#include <vector>
 #include <cpl_port.h>
+#include <cpl_multiproc.h>
 
 namespace node_gdal {
 
@@ -30,6 +35,11 @@ void RasterBand::Initialize(Handle<Object> target)
 	NODE_SET_PROTOTYPE_METHOD(constructor, "getStatistics", getStatistics);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "setStatistics", setStatistics);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "computeStatistics", computeStatistics);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "computeStatisticsAsync", computeStatisticsAsync);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "getHistogram", getHistogram);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "getHistogramAsync", getHistogramAsync);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "getDefaultHistogram", getDefaultHistogram);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "setDefaultHistogram", setDefaultHistogram);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "getMaskBand", getMaskBand);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "getMaskFlags", getMaskFlags);
 	NODE_SET_PROTOTYPE_METHOD(constructor, "createMaskBand", createMaskBand);
@@ -39,9 +49,6 @@ void RasterBand::Initialize(Handle<Object> target)
 	//NODE_SET_PROTOTYPE_METHOD(constructor, "rasterIO", rasterIO);
 	//NODE_SET_PROTOTYPE_METHOD(constructor, "getColorTable", getColorTable);
 	//NODE_SET_PROTOTYPE_METHOD(constructor, "setColorTable", setColorTable);
-	//NODE_SET_PROTOTYPE_METHOD(constructor, "getHistogram", getHistogram);
-	//NODE_SET_PROTOTYPE_METHOD(constructor, "getDefaultHistogram", getDefaultHistogram);
-	//NODE_SET_PROTOTYPE_METHOD(constructor, "setDefaultHistogram", setDefaultHistogram);
 
 	ATTR_DONT_ENUM(constructor, "ds", dsGetter, READ_ONLY_SETTER);
 	ATTR(constructor, "id", idGetter, READ_ONLY_SETTER);
@@ -94,16 +101,18 @@ void RasterBand::dispose()
 		int n = this_->GetOverviewCount();
 		for(int i = 0; i < n; i++) {
 			band = this_->GetOverview(i);
-			if (RasterBand::cache.has(band)) {
-				band_wrapped = ObjectWrap::Unwrap<RasterBand>(RasterBand::cache.get(band));
+			Handle<Object> cached = RasterBand::cache.find(band);
+			if (!cached.IsEmpty()) {
+				band_wrapped = ObjectWrap::Unwrap<RasterBand>(cached);
 				band_wrapped->dispose();
 			}
 		}
 
 		//dispose of wrapped mask band
 		band = this_->GetMaskBand();
-		if (RasterBand::cache.has(band)) {
-			band_wrapped = ObjectWrap::Unwrap<RasterBand>(RasterBand::cache.get(band));
+		Handle<Object> cached = RasterBand::cache.find(band);
+		if (!cached.IsEmpty()) {
+			band_wrapped = ObjectWrap::Unwrap<RasterBand>(cached);
 			band_wrapped->dispose();
 		}
 
@@ -145,8 +154,9 @@ Handle<Value> RasterBand::New(GDALRasterBand *raw, GDALDataset *raw_parent)
 	if (!raw) {
 		return Null();
 	}
-	if (cache.has(raw)) {
-		return cache.get(raw);
+	Handle<Object> cached = cache.find(raw);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	RasterBand *wrapped = new RasterBand(raw);
@@ -161,10 +171,8 @@ Handle<Value> RasterBand::New(GDALRasterBand *raw, GDALDataset *raw_parent)
 		//DONT USE GDALRasterBand.GetDataset() ... it will return a "fake" dataset for overview bands
 		//https://github.com/naturalatlas/node-gdal/blob/master/deps/libgdal/gdal/frmts/gtiff/geotiff.cpp#L84
 
-		Handle<Value> ds;
-		if (Dataset::dataset_cache.has(raw_parent)) {
-			ds = Dataset::dataset_cache.get(raw_parent);
-		} else {
+		Handle<Value> ds = Dataset::dataset_cache.find(raw_parent);
+		if (ds.IsEmpty()) {
 			LOG("Band's parent dataset disappeared from cache (band = %p, dataset = %p)", raw, raw_parent);
 			return NODE_THROW("Band's parent dataset disappeared from cache");
 			//ds = Dataset::New(raw_parent); //this should never happen
@@ -177,21 +185,70 @@ Handle<Value> RasterBand::New(GDALRasterBand *raw, GDALDataset *raw_parent)
 	return scope.Close(obj);
 }
 
+Dataset *RasterBand::parentDataset(Handle<Object> band_obj)
+{
+	Handle<Value> ds_obj = band_obj->GetHiddenValue(String::NewSymbol("ds_"));
+	if (ds_obj.IsEmpty() || !ds_obj->IsObject()) {
+		return NULL;
+	}
+	return ObjectWrap::Unwrap<Dataset>(ds_obj->ToObject());
+}
+
 Handle<Value> RasterBand::toString(const Arguments& args)
 {
 	HandleScope scope;
 	return scope.Close(String::New("RasterBand"));
 }
 
-NODE_WRAPPED_METHOD(RasterBand, flush, FlushCache);
-NODE_WRAPPED_METHOD_WITH_RESULT(RasterBand, getMaskFlags, Integer, GetMaskFlags);
-NODE_WRAPPED_METHOD_WITH_CPLERR_RESULT_1_INTEGER_PARAM(RasterBand, createMaskBand, CreateMaskBand, "number of desired samples");
+Handle<Value> RasterBand::flush(const Arguments& args)
+{
+	HandleScope scope;
+
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
+	if (!band->this_) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+	band->this_->FlushCache();
+	return Undefined();
+}
+
+Handle<Value> RasterBand::getMaskFlags(const Arguments& args)
+{
+	HandleScope scope;
+
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
+	if (!band->this_) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+	return scope.Close(Integer::New(band->this_->GetMaskFlags()));
+}
+
+Handle<Value> RasterBand::createMaskBand(const Arguments& args)
+{
+	HandleScope scope;
+	int flags;
+	NODE_ARG_INT(0, "number of desired samples", flags);
+
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
+	if (!band->this_) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+	int err = band->this_->CreateMaskBand(flags);
+	if (err) {
+		return NODE_THROW_CPLERR(err);
+	}
+	return Undefined();
+}
 
 Handle<Value> RasterBand::getMaskBand(const Arguments& args)
 {
 	HandleScope scope;
 
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -211,6 +268,7 @@ Handle<Value> RasterBand::fill(const Arguments& args)
 	NODE_ARG_DOUBLE_OPT(1, "imaginary value", real);
 
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -225,25 +283,48 @@ Handle<Value> RasterBand::fill(const Arguments& args)
 
 // --- Custom error handling to handle VRT errors --- 
 // see: https://github.com/mapbox/mapnik-omnivore/issues/10
-
-std::string stats_file_err = "";
-CPLErrorHandler last_err_handler;
-void CPL_STDCALL statisticsErrorHandler(CPLErr eErrClass, int err_no, const char *msg) {
-	if(err_no == CPLE_OpenFailed) {
-		stats_file_err = msg;
+//
+// CPL error handler stacks are per thread, so the capture only sees errors raised
+// on the thread that created it and concurrent scans don't interfere.
+
+class StatsErrorCapture {
+public:
+	StatsErrorCapture()
+	{
+		CPLPushErrorHandlerEx(StatsErrorCapture::handler, this);
 	}
-	if(last_err_handler) {
-		last_err_handler(eErrClass, err_no, msg);
+	~StatsErrorCapture()
+	{
+		CPLPopErrorHandler();
 	}
+
+	std::string file_err;
+
+private:
+	static void CPL_STDCALL handler(CPLErr eErrClass, int err_no, const char *msg)
+	{
+		StatsErrorCapture *capture = static_cast<StatsErrorCapture*>(CPLGetErrorHandlerUserData());
+		if (err_no == CPLE_OpenFailed) {
+			capture->file_err = msg;
+		}
+		if (error_handler) {
+			error_handler(eErrClass, err_no, msg);
+		}
+	}
+};
+
+static Handle<Value> statisticsResult(double min, double max, double mean, double std_dev)
+{
+	HandleScope scope;
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("min"), Number::New(min));
+	result->Set(String::NewSymbol("max"), Number::New(max));
+	result->Set(String::NewSymbol("mean"), Number::New(mean));
+	result->Set(String::NewSymbol("std_dev"), Number::New(std_dev));
+
+	return scope.Close(result);
 }
-void pushStatsErrorHandler() {
-	last_err_handler = CPLSetErrorHandler(statisticsErrorHandler);
-}
-void popStatsErrorHandler() {
-	if(!last_err_handler) return;
-	CPLSetErrorHandler(last_err_handler);
-}
-	
 
 Handle<Value> RasterBand::getStatistics(const Arguments& args)
 {
@@ -254,15 +335,15 @@ Handle<Value> RasterBand::getStatistics(const Arguments& args)
 	NODE_ARG_BOOL(1, "force", force);
 
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 	
-	pushStatsErrorHandler();
+	StatsErrorCapture capture;
 	CPLErr err = band->this_->GetStatistics(approx, force, &min, &max, &mean, &std_dev);
-	popStatsErrorHandler();
-	if (!stats_file_err.empty()){
-		NODE_THROW(stats_file_err.c_str());
+	if (!capture.file_err.empty()){
+		return NODE_THROW(capture.file_err.c_str());
 	} else if (err) {
 		if (!force && err == CE_Warning) {
 			return NODE_THROW("Statistics cannot be efficiently computed without scanning raster");
@@ -270,13 +351,7 @@ Handle<Value> RasterBand::getStatistics(const Arguments& args)
 		return NODE_THROW_CPLERR(err);
 	}
 
-	Local<Object> result = Object::New();
-	result->Set(String::NewSymbol("min"), Number::New(min));
-	result->Set(String::NewSymbol("max"), Number::New(max));
-	result->Set(String::NewSymbol("mean"), Number::New(mean));
-	result->Set(String::NewSymbol("std_dev"), Number::New(std_dev));
-
-	return scope.Close(result);
+	return scope.Close(statisticsResult(min, max, mean, std_dev));
 }
 
 Handle<Value> RasterBand::computeStatistics(const Arguments& args)
@@ -287,26 +362,370 @@ Handle<Value> RasterBand::computeStatistics(const Arguments& args)
 	NODE_ARG_BOOL(0, "allow approximation", approx);
 
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
 
-	pushStatsErrorHandler();
+	StatsErrorCapture capture;
 	CPLErr err = band->this_->ComputeStatistics(approx, &min, &max, &mean, &std_dev, NULL, NULL);
-	popStatsErrorHandler();
-	if (!stats_file_err.empty()){
-		NODE_THROW(stats_file_err.c_str());
+	if (!capture.file_err.empty()){
+		return NODE_THROW(capture.file_err.c_str());
 	} else if (err) {
 		return NODE_THROW_CPLERR(err);
 	}
 
-	Local<Object> result = Object::New();
-	result->Set(String::NewSymbol("min"), Number::New(min));
-	result->Set(String::NewSymbol("max"), Number::New(max));
-	result->Set(String::NewSymbol("mean"), Number::New(mean));
-	result->Set(String::NewSymbol("std_dev"), Number::New(std_dev));
+	return scope.Close(statisticsResult(min, max, mean, std_dev));
+}
 
-	return scope.Close(result);
+// --- computeStatisticsAsync() ---
+
+//min / max and the running mean and sum of squared deviations (Welford), which unlike
+//the sum of squares doesn't lose the variance to cancellation when the values share a
+//large offset. accumulators of different parts are combined with Chan's formula
+struct StatsAccumulator {
+	StatsAccumulator()
+		: min(std::numeric_limits<double>::max()), max(-std::numeric_limits<double>::max()),
+		  mean(0), m2(0), count(0)
+	{}
+
+	inline void add(double value)
+	{
+		if (value < min) min = value;
+		if (value > max) max = value;
+		count++;
+		double delta = value - mean;
+		mean += delta / (double) count;
+		m2 += delta * (value - mean);
+	}
+
+	void merge(const StatsAccumulator &other)
+	{
+		if (other.count == 0) return;
+		if (count == 0) {
+			*this = other;
+			return;
+		}
+		if (other.min < min) min = other.min;
+		if (other.max > max) max = other.max;
+		double n_a = (double) count;
+		double n_b = (double) other.count;
+		double n = n_a + n_b;
+		double delta = other.mean - mean;
+		mean += delta * (n_b / n);
+		m2 += other.m2 + delta * delta * (n_a * n_b / n);
+		count += other.count;
+	}
+
+	double min;
+	double max;
+	double mean;
+	double m2;
+	GUIntBig count;
+};
+
+class StatisticsJob;
+
+//the blocks of the band one thread reduces: every n-th block starting at `first`
+struct StatsPart {
+	StatisticsJob *job;
+	GDALRasterBand *band;
+	GDALDataset *ds; //separate handle owned by the part, NULL for the caller's band
+	int first;
+	StatsAccumulator acc;
+	std::string error;
+};
+
+class StatisticsJob {
+public:
+	StatisticsJob()
+		: band(NULL), ds(NULL), approx(false), threads(0), progress(NULL), progress_arg(NULL),
+		  min(0), max(0), mean(0), std_dev(0), block_x(0), block_y(0), size_x(0), size_y(0),
+		  n_blocks_x(0), n_blocks(0), n_parts(0), has_nodata(0), nodata(0), blocks_done(0), stop(false)
+	{}
+
+	//returns an error message or ""
+	std::string run()
+	{
+		//the band may have been destroyed while the job was queued
+		GDALRasterBand *raw = band->get();
+		if (!raw) return "RasterBand object has already been destroyed";
+
+		StatsErrorCapture capture;
+		std::string error;
+
+		std::vector<StatsPart> parts;
+		if (!approx && !GDALDataTypeIsComplex(raw->GetRasterDataType())) {
+			openParts(raw, parts);
+		}
+
+		if (parts.empty()) {
+			//approximate statistics only sample the band, so GDAL's own implementation is used
+			CPLErr err = raw->ComputeStatistics(approx, &min, &max, &mean, &std_dev, progress, progress_arg);
+			if (!capture.file_err.empty()) return capture.file_err;
+			if (err) return lastError("Error computing statistics");
+			return "";
+		}
+
+		reduce(raw, parts);
+
+		StatsAccumulator total;
+		for (unsigned int i = 0; i < parts.size(); i++) {
+			if (error.empty() && !parts[i].error.empty()) error = parts[i].error;
+			total.merge(parts[i].acc);
+			if (parts[i].ds) GDALClose(parts[i].ds);
+		}
+		if (!capture.file_err.empty()) return capture.file_err;
+		if (!error.empty()) return error;
+		if (total.count == 0) return "Failed to compute statistics, no valid pixels found in sampling.";
+
+		min = total.min;
+		max = total.max;
+		mean = total.mean;
+		//population standard deviation, like ComputeStatistics()
+		std_dev = sqrt(total.m2 / (double) total.count);
+
+		//like ComputeStatistics(), store the result with the band
+		raw->SetStatistics(min, max, mean, std_dev);
+		return "";
+	}
+
+	Handle<Value> result()
+	{
+		return statisticsResult(min, max, mean, std_dev);
+	}
+
+	RasterBand *band;
+	Dataset *ds;
+	bool approx;
+	int threads;
+	GDALProgressFunc progress;
+	void *progress_arg;
+
+private:
+	//opens a read-only handle to the band's file for each extra thread. bands that
+	//can't be reopened (MEM datasets, overviews, ...) are reduced on this thread only
+	void openParts(GDALRasterBand *raw, std::vector<StatsPart> &parts)
+	{
+		int block_x, block_y;
+		raw->GetBlockSize(&block_x, &block_y);
+		n_blocks_x = (raw->GetXSize() + block_x - 1) / block_x;
+		n_blocks = n_blocks_x * ((raw->GetYSize() + block_y - 1) / block_y);
+
+		int n = threads > 0 ? threads : CPLGetNumCPUs();
+		if (n > n_blocks) n = n_blocks;
+		if (n < 1) n = 1;
+
+		StatsPart part;
+		part.job = this;
+		part.band = raw;
+		part.ds = NULL;
+		part.first = 0;
+		parts.push_back(part);
+
+		GDALDataset *parent = band->getParent();
+		if (n == 1 || !parent || raw->GetDataset() != parent || raw->GetBand() < 1) return;
+		GDALDriver *driver = parent->GetDriver();
+		if (!driver || EQUAL(driver->GetDescription(), "MEM")) return;
+
+		//make pending writes visible to the other handles
+		parent->FlushCache();
+
+		CPLPushErrorHandler(CPLQuietErrorHandler);
+		for (int i = 1; i < n; i++) {
+			GDALDataset *copy = (GDALDataset*) GDALOpen(parent->GetDescription(), GA_ReadOnly);
+			if (!copy) break;
+			if (copy->GetRasterCount() < raw->GetBand() ||
+			    copy->GetRasterXSize() != parent->GetRasterXSize() ||
+			    copy->GetRasterYSize() != parent->GetRasterYSize()) {
+				GDALClose(copy);
+				break;
+			}
+			part.band = copy->GetRasterBand(raw->GetBand());
+			part.ds = copy;
+			part.first = i;
+			parts.push_back(part);
+		}
+		CPLPopErrorHandler();
+	}
+
+	//runs parts[1..] on their own threads and parts[0] on this one
+	void reduce(GDALRasterBand *raw, std::vector<StatsPart> &parts)
+	{
+		raw->GetBlockSize(&block_x, &block_y);
+		size_x = raw->GetXSize();
+		size_y = raw->GetYSize();
+		n_parts = parts.size();
+		has_nodata = 0;
+		nodata = raw->GetNoDataValue(&has_nodata);
+		has_nodata = has_nodata && !CPLIsNan(nodata);
+		blocks_done = 0;
+		stop = false;
+		uv_mutex_init(&lock);
+
+		std::vector<uv_thread_t> tids(parts.size());
+		for (unsigned int i = 1; i < parts.size(); i++) {
+			uv_thread_create(&tids[i], StatisticsJob::reducePart, &parts[i]);
+		}
+		reducePart(&parts[0]);
+		for (unsigned int i = 1; i < parts.size(); i++) {
+			uv_thread_join(&tids[i]);
+		}
+
+		uv_mutex_destroy(&lock);
+	}
+
+	static void reducePart(void *arg)
+	{
+		StatsPart *part = static_cast<StatsPart*>(arg);
+		StatisticsJob *job = part->job;
+		bool reports_progress = part->first == 0 && job->progress;
+
+		//errors raised on other threads don't reach the caller's capture
+		StatsErrorCapture capture;
+		CPLErrorReset();
+
+		std::vector<double> data((size_t) job->block_x * job->block_y);
+
+		for (int i = part->first; i < job->n_blocks; i += job->n_parts) {
+			uv_mutex_lock(&job->lock);
+			bool stop = job->stop;
+			uv_mutex_unlock(&job->lock);
+			if (stop) break;
+
+			int x = (i % job->n_blocks_x) * job->block_x;
+			int y = (i / job->n_blocks_x) * job->block_y;
+			int w = std::min(job->block_x, job->size_x - x);
+			int h = std::min(job->block_y, job->size_y - y);
+
+			if (part->band->RasterIO(GF_Read, x, y, w, h, &data[0], w, h, GDT_Float64, 0, 0) != CE_None) {
+				part->error = capture.file_err.empty() ? lastError("Error reading block") : capture.file_err;
+				job->cancel();
+				return;
+			}
+
+			StatsAccumulator &acc = part->acc;
+			int n = w * h;
+			for (int j = 0; j < n; j++) {
+				double value = data[j];
+				if (CPLIsNan(value)) continue;
+				if (job->has_nodata && ARE_REAL_EQUAL(value, job->nodata)) continue;
+				acc.add(value);
+			}
+
+			uv_mutex_lock(&job->lock);
+			int done = ++job->blocks_done;
+			uv_mutex_unlock(&job->lock);
+
+			if (reports_progress && !job->progress(done / (double) job->n_blocks, "Compute Statistics", job->progress_arg)) {
+				part->error = "User terminated";
+				job->cancel();
+				return;
+			}
+		}
+
+		if (!capture.file_err.empty()) part->error = capture.file_err;
+	}
+
+	void cancel()
+	{
+		uv_mutex_lock(&lock);
+		stop = true;
+		uv_mutex_unlock(&lock);
+	}
+
+	static std::string lastError(const char *fallback)
+	{
+		std::string msg = CPLGetLastErrorMsg();
+		return msg.empty() ? fallback : msg;
+	}
+
+	double min;
+	double max;
+	double mean;
+	double std_dev;
+
+	//shared by the threads of reduce()
+	int block_x, block_y;
+	int size_x, size_y;
+	int n_blocks_x, n_blocks;
+	int n_parts;
+	int has_nodata;
+	double nodata;
+	int blocks_done;
+	bool stop;
+	uv_mutex_t lock;
+};
+
+class StatisticsWorker : public AsyncProgressWorker {
+public:
+	StatisticsWorker(Handle<Function> callback, Handle<Function> progress_cb, const StatisticsJob &job)
+		: AsyncProgressWorker(callback, progress_cb), job(job)
+	{
+		this->job.progress = AsyncProgressWorker::ProgressFunc;
+		this->job.progress_arg = this;
+	}
+
+	void Execute()
+	{
+		CPLErrorReset();
+		if (job.ds) job.ds->lock();
+		std::string error = job.run();
+		if (job.ds) job.ds->unlock();
+		if (!error.empty()) SetErrorMessage(error.c_str());
+	}
+
+	Handle<Value> GetResult()
+	{
+		return job.result();
+	}
+
+	StatisticsJob job;
+};
+
+Handle<Value> RasterBand::computeStatisticsAsync(const Arguments& args)
+{
+	HandleScope scope;
+
+	StatisticsJob job;
+	Handle<Function> callback;
+	Handle<Function> progress_cb;
+	Handle<Object> options = Object::New();
+	int approx;
+
+	NODE_ARG_BOOL(0, "allow approximation", approx);
+	if (args.Length() > 1 && !args[1]->IsUndefined() && !args[1]->IsNull()) {
+		if (!args[1]->IsObject()) return NODE_THROW("options must be an object");
+		options = args[1]->ToObject();
+	}
+	NODE_ARG_CALLBACK(2, "callback", callback);
+
+	job.band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	if (!job.band->this_) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+	job.ds = RasterBand::parentDataset(args.This());
+	job.approx = approx;
+
+	Handle<Value> val = options->Get(String::NewSymbol("threads"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsInt32() || val->Int32Value() < 1) return NODE_THROW("threads must be a positive integer");
+		job.threads = val->Int32Value();
+	}
+
+	val = options->Get(String::NewSymbol("progress"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsFunction()) return NODE_THROW("progress must be a function");
+		progress_cb = Handle<Function>::Cast(val);
+	}
+
+	StatisticsWorker *worker = new StatisticsWorker(callback, progress_cb, job);
+
+	//keep the band (and through it the dataset) alive until the scan is done
+	worker->SaveToPersistent("band", args.This());
+	AsyncWorker::Queue(worker);
+
+	return Undefined();
 }
 
 Handle<Value> RasterBand::setStatistics(const Arguments& args)
@@ -320,6 +739,7 @@ Handle<Value> RasterBand::setStatistics(const Arguments& args)
 	NODE_ARG_DOUBLE(3, "standard deviation", std_dev);
 
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -332,6 +752,378 @@ Handle<Value> RasterBand::setStatistics(const Arguments& args)
 	return Undefined();
 }
 
+// --- getHistogram() and getHistogramAsync() ---
+
+class HistogramJob {
+public:
+	HistogramJob()
+		: band(NULL), ds(NULL), has_range(false), min(0), max(0), buckets(256),
+		  include_out_of_range(false), approx_ok(false), progress(NULL), progress_arg(NULL)
+	{}
+
+	//returns an error message or ""
+	std::string run()
+	{
+		//the band may have been destroyed while the job was queued
+		GDALRasterBand *raw = band->get();
+		if (!raw) return "RasterBand object has already been destroyed";
+
+		if (!has_range) {
+			std::string err = defaultRange(raw);
+			if (!err.empty()) return err;
+		}
+
+		histogram.assign(buckets, 0);
+
+		GDALDataType type = raw->GetRasterDataType();
+		const char *pixel_type = raw->GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+		bool signed_byte = pixel_type && EQUAL(pixel_type, "SIGNEDBYTE");
+
+		if (!approx_ok && type == GDT_Byte && !signed_byte) {
+			return binBlocks<GByte>(raw);
+		}
+		if (!approx_ok && type == GDT_UInt16) {
+			return binBlocks<GUInt16>(raw);
+		}
+
+		std::vector<int> counts(buckets, 0);
+		CPLErr err = raw->GetHistogram(min, max, buckets, &counts[0], include_out_of_range, approx_ok, progress, progress_arg);
+		if (err) return lastError("Error computing histogram");
+		for (int i = 0; i < buckets; i++) histogram[i] = counts[i];
+		return "";
+	}
+
+	Handle<Value> result()
+	{
+		HandleScope scope;
+		Local<Array> array = Array::New(buckets);
+		for (int i = 0; i < buckets; i++) {
+			array->Set(i, Number::New((double) histogram[i]));
+		}
+		return scope.Close(array);
+	}
+
+	RasterBand *band;
+	Dataset *ds;
+	bool has_range;
+	double min;
+	double max;
+	int buckets;
+	bool include_out_of_range;
+	bool approx_ok;
+	GDALProgressFunc progress;
+	void *progress_arg;
+
+private:
+	//same range GDALRasterBand::GetDefaultHistogram() uses
+	std::string defaultRange(GDALRasterBand *raw)
+	{
+		const char *pixel_type = raw->GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+		if (raw->GetRasterDataType() == GDT_Byte && !(pixel_type && EQUAL(pixel_type, "SIGNEDBYTE"))) {
+			min = -0.5;
+			max = 255.5;
+			return "";
+		}
+		if (raw->GetStatistics(TRUE, TRUE, &min, &max, NULL, NULL) != CE_None) {
+			return lastError("Error computing the histogram range");
+		}
+		double half_bucket = buckets > 1 ? (max - min) / (2 * (buckets - 1)) : 0.5;
+		min -= half_bucket;
+		max += half_bucket;
+		//constant bands have min == max, which would make the bucket width 0
+		if (!(max > min)) {
+			min -= 0.5;
+			max += 0.5;
+		}
+		return "";
+	}
+
+	//Byte / UInt16 bands: every possible value is mapped to its bucket up front, so
+	//binning a block is a table lookup per pixel. four partial histograms are
+	//filled in turn so consecutive equal pixels don't serialize on one counter.
+	template <typename T>
+	std::string binBlocks(GDALRasterBand *raw)
+	{
+		const int n_values = 1 << (8 * sizeof(T));
+		const int discard = buckets;
+
+		std::vector<int> lut(n_values);
+		int has_nodata = 0;
+		double nodata = raw->GetNoDataValue(&has_nodata);
+		has_nodata = has_nodata && !CPLIsNan(nodata) && !CSLTestBoolean(CPLGetConfigOption("GDAL_NODATA_IN_HISTOGRAM", "NO"));
+		double scale = buckets / (max - min);
+		for (int v = 0; v < n_values; v++) {
+			//compared as double, the position may not fit in an int
+			double pos = floor((v - min) * scale);
+			int i;
+			if (has_nodata && ARE_REAL_EQUAL((double) v, nodata)) i = discard;
+			else if (pos < 0) i = include_out_of_range ? 0 : discard;
+			else if (pos >= buckets) i = include_out_of_range ? buckets - 1 : discard;
+			else i = (int) pos;
+			lut[v] = i;
+		}
+
+		std::vector<GUIntBig> partial(4 * (buckets + 1), 0);
+		GUIntBig *h0 = &partial[0];
+		GUIntBig *h1 = h0 + buckets + 1;
+		GUIntBig *h2 = h1 + buckets + 1;
+		GUIntBig *h3 = h2 + buckets + 1;
+
+		int block_x, block_y;
+		raw->GetBlockSize(&block_x, &block_y);
+		int size_x = raw->GetXSize();
+		int size_y = raw->GetYSize();
+		int blocks_x = (size_x + block_x - 1) / block_x;
+		int blocks_y = (size_y + block_y - 1) / block_y;
+
+		for (int by = 0; by < blocks_y; by++) {
+			if (progress && !progress(by / (double) blocks_y, "Compute Histogram", progress_arg)) {
+				CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+				return "User terminated";
+			}
+			int h = std::min(block_y, size_y - by * block_y);
+			for (int bx = 0; bx < blocks_x; bx++) {
+				int w = std::min(block_x, size_x - bx * block_x);
+
+				GDALRasterBlock *block = raw->GetLockedBlockRef(bx, by);
+				if (!block) return lastError("Error reading block");
+				const T *data = static_cast<const T*>(block->GetDataRef());
+				if (!data) {
+					block->DropLock();
+					return lastError("Error reading block");
+				}
+
+				for (int y = 0; y < h; y++) {
+					const T *row = data + (size_t) y * block_x;
+					int x = 0;
+					for (; x + 4 <= w; x += 4) {
+						h0[lut[row[x]]]++;
+						h1[lut[row[x + 1]]]++;
+						h2[lut[row[x + 2]]]++;
+						h3[lut[row[x + 3]]]++;
+					}
+					for (; x < w; x++) {
+						h0[lut[row[x]]]++;
+					}
+				}
+				block->DropLock();
+			}
+		}
+
+		for (int i = 0; i < buckets; i++) {
+			histogram[i] = h0[i] + h1[i] + h2[i] + h3[i];
+		}
+		if (progress) progress(1.0, "Compute Histogram", progress_arg);
+		return "";
+	}
+
+	static std::string lastError(const char *fallback)
+	{
+		std::string msg = CPLGetLastErrorMsg();
+		return msg.empty() ? fallback : msg;
+	}
+
+	std::vector<GUIntBig> histogram;
+};
+
+class HistogramWorker : public AsyncProgressWorker {
+public:
+	HistogramWorker(Handle<Function> callback, Handle<Function> progress_cb, const HistogramJob &job)
+		: AsyncProgressWorker(callback, progress_cb), job(job)
+	{
+		this->job.progress = AsyncProgressWorker::ProgressFunc;
+		this->job.progress_arg = this;
+	}
+
+	void Execute()
+	{
+		CPLErrorReset();
+		if (job.ds) job.ds->lock();
+		std::string error = job.run();
+		if (job.ds) job.ds->unlock();
+		if (!error.empty()) SetErrorMessage(error.c_str());
+	}
+
+	Handle<Value> GetResult()
+	{
+		return job.result();
+	}
+
+	HistogramJob job;
+};
+
+//parses ([options]) shared by both versions
+static Handle<Value> parseHistogramArgs(const Arguments& args, HistogramJob &job, Handle<Function> &progress_cb)
+{
+	job.band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	if (!job.band->get()) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+	job.ds = RasterBand::parentDataset(args.This());
+
+	Handle<Object> options = Object::New();
+	if (args.Length() > 0 && !args[0]->IsUndefined() && !args[0]->IsNull() && !args[0]->IsFunction()) {
+		if (!args[0]->IsObject()) return NODE_THROW("options must be an object");
+		options = args[0]->ToObject();
+	}
+
+	Handle<Value> min = options->Get(String::NewSymbol("min"));
+	Handle<Value> max = options->Get(String::NewSymbol("max"));
+	if (!min->IsUndefined() || !max->IsUndefined()) {
+		if (!min->IsNumber() || !max->IsNumber()) return NODE_THROW("min and max must both be given as numbers");
+		job.min = min->NumberValue();
+		job.max = max->NumberValue();
+		if (!(job.min < job.max)) return NODE_THROW("min must be less than max");
+		job.has_range = true;
+	}
+
+	Handle<Value> val = options->Get(String::NewSymbol("buckets"));
+	if (!val->IsUndefined()) {
+		if (!val->IsInt32() || val->Int32Value() < 1) return NODE_THROW("buckets must be a positive integer");
+		job.buckets = val->Int32Value();
+	}
+
+	job.include_out_of_range = options->Get(String::NewSymbol("includeOutOfRange"))->BooleanValue();
+	job.approx_ok = options->Get(String::NewSymbol("approxOK"))->BooleanValue();
+
+	val = options->Get(String::NewSymbol("progress"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsFunction()) return NODE_THROW("progress must be a function");
+		progress_cb = Handle<Function>::Cast(val);
+	}
+
+	return Handle<Value>();
+}
+
+Handle<Value> RasterBand::getHistogram(const Arguments& args)
+{
+	HandleScope scope;
+
+	HistogramJob job;
+	Handle<Function> progress_cb;
+	Handle<Value> error = parseHistogramArgs(args, job, progress_cb);
+	if (!error.IsEmpty()) return error;
+
+	if (!progress_cb.IsEmpty()) {
+		job.progress = SyncProgressFunc;
+		job.progress_arg = &progress_cb;
+	}
+
+	TryCatch try_catch;
+
+	CPLErrorReset();
+	if (job.ds) job.ds->lock();
+	std::string msg = job.run();
+	if (job.ds) job.ds->unlock();
+
+	if (try_catch.HasCaught()) {
+		return try_catch.ReThrow();
+	}
+	if (!msg.empty()) {
+		return NODE_THROW(msg.c_str());
+	}
+
+	return scope.Close(job.result());
+}
+
+Handle<Value> RasterBand::getHistogramAsync(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Function> callback;
+	NODE_ARG_CALLBACK(1, "callback", callback);
+
+	HistogramJob job;
+	Handle<Function> progress_cb;
+	Handle<Value> error = parseHistogramArgs(args, job, progress_cb);
+	if (!error.IsEmpty()) return error;
+
+	HistogramWorker *worker = new HistogramWorker(callback, progress_cb, job);
+
+	//keep the band (and through it the dataset) alive until the scan is done
+	worker->SaveToPersistent("band", args.This());
+	AsyncWorker::Queue(worker);
+
+	return Undefined();
+}
+
+Handle<Value> RasterBand::getDefaultHistogram(const Arguments& args)
+{
+	HandleScope scope;
+	double min, max;
+	int buckets = 0;
+	int *histogram = NULL;
+	int force = 1;
+
+	NODE_ARG_BOOL_OPT(0, "force", force);
+
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
+	if (!band->this_) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+
+	CPLErr err = band->this_->GetDefaultHistogram(&min, &max, &buckets, &histogram, force, NULL, NULL);
+	if (err == CE_Warning && !force) {
+		VSIFree(histogram);
+		return Null();
+	}
+	if (err) {
+		VSIFree(histogram);
+		return NODE_THROW_CPLERR(err);
+	}
+
+	Local<Array> counts = Array::New(buckets);
+	for (int i = 0; i < buckets; i++) {
+		counts->Set(i, Integer::New(histogram[i]));
+	}
+	VSIFree(histogram);
+
+	Local<Object> result = Object::New();
+	result->Set(String::NewSymbol("min"), Number::New(min));
+	result->Set(String::NewSymbol("max"), Number::New(max));
+	result->Set(String::NewSymbol("histogram"), counts);
+
+	return scope.Close(result);
+}
+
+Handle<Value> RasterBand::setDefaultHistogram(const Arguments& args)
+{
+	HandleScope scope;
+	double min, max;
+	Handle<Array> counts;
+
+	NODE_ARG_DOUBLE(0, "min", min);
+	NODE_ARG_DOUBLE(1, "max", max);
+	NODE_ARG_ARRAY(2, "histogram", counts);
+
+	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(args.This());
+	DatasetLock lock(parentDataset(args.This()));
+	if (!band->this_) {
+		return NODE_THROW("RasterBand object has already been destroyed");
+	}
+
+	int n = counts->Length();
+	if (n < 1) {
+		return NODE_THROW("histogram must not be empty");
+	}
+	std::vector<int> histogram(n);
+	for (int i = 0; i < n; i++) {
+		Handle<Value> val = counts->Get(i);
+		if (!val->IsNumber()) {
+			return NODE_THROW("histogram must only contain numbers");
+		}
+		histogram[i] = val->Int32Value();
+	}
+
+	CPLErr err = band->this_->SetDefaultHistogram(min, max, n, &histogram[0]);
+
+	if (err) {
+		return NODE_THROW_CPLERR(err);
+	}
+	return Undefined();
+}
+
 Handle<Value> RasterBand::dsGetter(Local<String> property, const AccessorInfo &info)
 {
 	HandleScope scope;
@@ -354,6 +1146,7 @@ Handle<Value> RasterBand::idGetter(Local<String> property, const AccessorInfo &i
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -367,6 +1160,7 @@ Handle<Value> RasterBand::sizeGetter(Local<String> property, const AccessorInfo
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -381,6 +1175,7 @@ Handle<Value> RasterBand::blockSizeGetter(Local<String> property, const Accessor
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -398,6 +1193,7 @@ Handle<Value> RasterBand::minimumGetter(Local<String> property, const AccessorIn
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -411,6 +1207,7 @@ Handle<Value> RasterBand::maximumGetter(Local<String> property, const AccessorIn
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -424,6 +1221,7 @@ Handle<Value> RasterBand::offsetGetter(Local<String> property, const AccessorInf
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -437,6 +1235,7 @@ Handle<Value> RasterBand::scaleGetter(Local<String> property, const AccessorInfo
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -450,6 +1249,7 @@ Handle<Value> RasterBand::noDataValueGetter(Local<String> property, const Access
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -465,6 +1265,7 @@ Handle<Value> RasterBand::unitTypeGetter(Local<String> property, const AccessorI
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -477,6 +1278,7 @@ Handle<Value> RasterBand::dataTypeGetter(Local<String> property, const AccessorI
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -491,6 +1293,7 @@ Handle<Value> RasterBand::readOnlyGetter(Local<String> property, const AccessorI
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -503,6 +1306,7 @@ Handle<Value> RasterBand::hasArbitraryOverviewsGetter(Local<String> property, co
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -515,6 +1319,7 @@ Handle<Value> RasterBand::categoryNamesGetter(Local<String> property, const Acce
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -538,6 +1343,7 @@ Handle<Value> RasterBand::colorInterpretationGetter(Local<String> property, cons
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		return NODE_THROW("RasterBand object has already been destroyed");
 	}
@@ -550,6 +1356,7 @@ void RasterBand::unitTypeSetter(Local<String> property, Local<Value> value, cons
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		NODE_THROW("RasterBand object has already been destroyed");
 		return;
@@ -570,6 +1377,7 @@ void RasterBand::noDataValueSetter(Local<String> property, Local<Value> value, c
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		NODE_THROW("RasterBand object has already been destroyed"); 
 		return;
@@ -596,6 +1404,7 @@ void RasterBand::scaleSetter(Local<String> property, Local<Value> value, const A
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		NODE_THROW("RasterBand object has already been destroyed");
 		return;
@@ -616,6 +1425,7 @@ void RasterBand::offsetSetter(Local<String> property, Local<Value> value, const
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		NODE_THROW("RasterBand object has already been destroyed"); 
 		return;
@@ -636,6 +1446,7 @@ void RasterBand::categoryNamesSetter(Local<String> property, Local<Value> value,
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		NODE_THROW("RasterBand object has already been destroyed"); 
 		return;
@@ -672,6 +1483,7 @@ void RasterBand::colorInterpretationSetter(Local<String> property, Local<Value>
 {
 	HandleScope scope;
 	RasterBand *band = ObjectWrap::Unwrap<RasterBand>(info.This());
+	DatasetLock lock(parentDataset(info.This()));
 	if (!band->this_) {
 		NODE_THROW("RasterBand object has already been destroyed");
 		return;
@@ -30,7 +30,12 @@ public:
 	static Handle<Value> fill(const Arguments &args);
 	static Handle<Value> getStatistics(const Arguments &args);
 	static Handle<Value> computeStatistics(const Arguments &args);
+	static Handle<Value> computeStatisticsAsync(const Arguments &args);
 	static Handle<Value> setStatistics(const Arguments &args);
+	static Handle<Value> getHistogram(const Arguments &args);
+	static Handle<Value> getHistogramAsync(const Arguments &args);
+	static Handle<Value> getDefaultHistogram(const Arguments &args);
+	static Handle<Value> setDefaultHistogram(const Arguments &args);
 	static Handle<Value> getMaskBand(const Arguments &args);
 	static Handle<Value> getMaskFlags(const Arguments &args);
 	static Handle<Value> createMaskBand(const Arguments &args);
@@ -40,9 +45,6 @@ public:
 	//static Handle<Value> setColorTable(const Arguments &args);
 	//static Handle<Value> rasterIO(const Arguments &args);
 	//static Handle<Value> buildOverviews(const Arguments &args);
-	//static Handle<Value> getHistogram(const Arguments &args);
-	//static Handle<Value> getDefaultHistogram(const Arguments &args);
-	//static Handle<Value> setDefaultHistogram(const Arguments &args);
 
 	static Handle<Value> dsGetter(Local<String> property, const AccessorInfo &info);
 	static Handle<Value> sizeGetter(Local<String> property, const AccessorInfo &info);
@@ -81,6 +83,9 @@ public:
 	}
 	void dispose();
 
+	//wrapper of the dataset owning the band (used to serialize access with async workers)
+	static Dataset *parentDataset(Handle<Object> band_obj);
+
 private:
 	~RasterBand();
 	GDALRasterBand *this_;
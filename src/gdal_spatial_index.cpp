@@ -0,0 +1,749 @@
+#include "gdal_common.hpp"
+#include "gdal_geometry.hpp"
+#include "gdal_geometry_array.hpp"
+#include "gdal_prepared_geometry.hpp"
+#include "gdal_spatial_index.hpp"
+#include "fast_buffer.hpp"
+#include "typed_array.hpp"
+
+#include <node_buffer.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <sstream>
+
+namespace node_gdal {
+
+//toBuffer() layout, in host byte order:
+//  "NGSI", version, node size, item count, node count, level count (uint32)
+//  node boxes (double * 4 * nodes), node indices (int32 * nodes), level bounds (uint32 * levels)
+//  item ids (int32 * items), WKB offsets (uint32 * (items + 1)), WKB
+static const char SERIALIZED_MAGIC[4] = {'N', 'G', 'S', 'I'};
+static const unsigned int SERIALIZED_VERSION = 1;
+static const unsigned int SERIALIZED_HEADER_SIZE = 24;
+
+struct TreeEntry {
+	double box[4];
+	int index;
+};
+
+static bool compareCenterX(const TreeEntry &a, const TreeEntry &b)
+{
+	return a.box[0] + a.box[2] < b.box[0] + b.box[2];
+}
+
+static bool compareCenterY(const TreeEntry &a, const TreeEntry &b)
+{
+	return a.box[1] + a.box[3] < b.box[1] + b.box[3];
+}
+
+//orders entries so each run of node_size entries is a compact tile:
+//vertical slices by center x, then by center y within each slice
+static void sortTiles(std::vector<TreeEntry> &entries, int node_size)
+{
+	int count = entries.size();
+	int nodes = (count + node_size - 1) / node_size;
+	int slices = (int) std::ceil(std::sqrt((double) nodes));
+	int slice_size = slices * node_size;
+
+	std::sort(entries.begin(), entries.end(), compareCenterX);
+	for (int i = 0; i < count; i += slice_size) {
+		std::sort(entries.begin() + i, entries.begin() + std::min(i + slice_size, count), compareCenterY);
+	}
+}
+
+static inline bool boxesIntersect(const double *a, const double *b)
+{
+	return a[0] <= b[2] && a[2] >= b[0] && a[1] <= b[3] && a[3] >= b[1];
+}
+
+static inline double boxDistance(const double *box, double x, double y)
+{
+	double dx = std::max(std::max(box[0] - x, 0.0), x - box[2]);
+	double dy = std::max(std::max(box[1] - y, 0.0), y - box[3]);
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+//reads {minX, minY, maxX, maxY} into box
+static std::string parseBox(Handle<Value> val, double *box)
+{
+	if (!val->IsObject()) return "envelope must be an object";
+	Handle<Object> obj = val->ToObject();
+	const char *keys[] = {"minX", "minY", "maxX", "maxY"};
+	for (int i = 0; i < 4; i++) {
+		Handle<Value> num = obj->Get(String::NewSymbol(keys[i]));
+		if (!num->IsNumber()) return std::string("envelope.") + keys[i] + " must be a number";
+		box[i] = num->NumberValue();
+		if (CPLIsNan(box[i])) return std::string("envelope.") + keys[i] + " must not be NaN";
+	}
+	if (box[0] > box[2] || box[1] > box[3]) return "envelope min must not be greater than max";
+	return "";
+}
+
+static bool geometryBox(OGRGeometry *geom, double *box)
+{
+	if (!geom || geom->IsEmpty()) return false;
+	OGREnvelope envelope;
+	geom->getEnvelope(&envelope);
+	box[0] = envelope.MinX;
+	box[1] = envelope.MinY;
+	box[2] = envelope.MaxX;
+	box[3] = envelope.MaxY;
+	return true;
+}
+
+Persistent<FunctionTemplate> SpatialIndex::constructor;
+
+void SpatialIndex::Initialize(Handle<Object> target)
+{
+	HandleScope scope;
+
+	constructor = Persistent<FunctionTemplate>::New(FunctionTemplate::New(SpatialIndex::New));
+	constructor->InstanceTemplate()->SetInternalFieldCount(1);
+	constructor->SetClassName(String::NewSymbol("SpatialIndex"));
+
+	NODE_SET_METHOD(constructor, "fromBuffer", SpatialIndex::fromBuffer);
+
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toString", toString);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "toBuffer", toBuffer);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "count", count);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "insert", insert);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "bulkLoad", bulkLoad);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "query", query);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "queryGeometry", queryGeometry);
+	NODE_SET_PROTOTYPE_METHOD(constructor, "nearest", nearest);
+
+	target->Set(String::NewSymbol("SpatialIndex"), constructor->GetFunction());
+}
+
+SpatialIndex::SpatialIndex(int node_size)
+	: ObjectWrap(),
+	  node_size_(node_size),
+	  dirty_(false),
+	  size_(0)
+{
+	LOG("Created SpatialIndex [node size %d]", node_size_);
+}
+
+SpatialIndex::~SpatialIndex()
+{
+	LOG("Disposing SpatialIndex [%d items]", (int) item_ids_.size());
+	for (unsigned int i = 0; i < item_geoms_.size(); i++) {
+		if (item_geoms_[i]) OGRGeometryFactory::destroyGeometry(item_geoms_[i]);
+	}
+	item_geoms_.clear();
+	V8::AdjustAmountOfExternalAllocatedMemory(-size_);
+}
+
+Handle<Value> SpatialIndex::New(const Arguments& args)
+{
+	HandleScope scope;
+
+	if (!args.IsConstructCall()) {
+		return NODE_THROW("Cannot call constructor as function, you need to use 'new' keyword");
+	}
+
+	if (args[0]->IsExternal()) {
+		Local<External> ext = Local<External>::Cast(args[0]);
+		void* ptr = ext->Value();
+		SpatialIndex *f = static_cast<SpatialIndex *>(ptr);
+		f->Wrap(args.This());
+		return args.This();
+	}
+
+	int node_size = 16;
+	if (args.Length() > 0 && !args[0]->IsUndefined() && !args[0]->IsNull()) {
+		if (!args[0]->IsObject()) {
+			return NODE_THROW("options must be an object");
+		}
+		Handle<Value> val = args[0]->ToObject()->Get(String::NewSymbol("nodeSize"));
+		if (!val->IsUndefined()) {
+			if (!val->IsInt32() || val->Int32Value() < 2 || val->Int32Value() > 256) {
+				return NODE_THROW("nodeSize must be an integer between 2 and 256");
+			}
+			node_size = val->Int32Value();
+		}
+	}
+
+	SpatialIndex *f = new SpatialIndex(node_size);
+	f->Wrap(args.This());
+	return args.This();
+}
+
+Handle<Value> SpatialIndex::toString(const Arguments& args)
+{
+	HandleScope scope;
+	return scope.Close(String::New("SpatialIndex"));
+}
+
+//takes ownership of geom (can be NULL)
+void SpatialIndex::add(int id, const double *box, OGRGeometry *geom)
+{
+	item_boxes_.insert(item_boxes_.end(), box, box + 4);
+	item_ids_.push_back(id);
+	item_geoms_.push_back(geom);
+
+	int size = 4 * sizeof(double) + sizeof(int) + sizeof(OGRGeometry*) + (geom ? geom->WkbSize() : 0);
+	V8::AdjustAmountOfExternalAllocatedMemory(size);
+	size_ += size;
+	dirty_ = true;
+}
+
+//packs the items bottom-up, one level at a time, until a level holds a single node
+void SpatialIndex::build()
+{
+	int n = item_ids_.size();
+
+	V8::AdjustAmountOfExternalAllocatedMemory(-(int) (boxes_.size() * sizeof(double) + indices_.size() * sizeof(int)));
+	size_ -= boxes_.size() * sizeof(double) + indices_.size() * sizeof(int);
+	boxes_.clear();
+	indices_.clear();
+	level_bounds_.clear();
+
+	std::vector<TreeEntry> level(n);
+	for (int i = 0; i < n; i++) {
+		std::memcpy(level[i].box, &item_boxes_[i * 4], 4 * sizeof(double));
+		level[i].index = i;
+	}
+
+	while (!level.empty()) {
+		int count = level.size();
+		int start = indices_.size();
+
+		sortTiles(level, node_size_);
+		for (int i = 0; i < count; i++) {
+			boxes_.insert(boxes_.end(), level[i].box, level[i].box + 4);
+			indices_.push_back(level[i].index);
+		}
+		level_bounds_.push_back(indices_.size());
+		if (count == 1) break;
+
+		std::vector<TreeEntry> parents;
+		parents.reserve((count + node_size_ - 1) / node_size_);
+		for (int i = 0; i < count; i += node_size_) {
+			TreeEntry parent = level[i];
+			parent.index = start + i;
+			int end = std::min(i + node_size_, count);
+			for (int j = i + 1; j < end; j++) {
+				parent.box[0] = std::min(parent.box[0], level[j].box[0]);
+				parent.box[1] = std::min(parent.box[1], level[j].box[1]);
+				parent.box[2] = std::max(parent.box[2], level[j].box[2]);
+				parent.box[3] = std::max(parent.box[3], level[j].box[3]);
+			}
+			parents.push_back(parent);
+		}
+		level.swap(parents);
+	}
+
+	V8::AdjustAmountOfExternalAllocatedMemory(boxes_.size() * sizeof(double) + indices_.size() * sizeof(int));
+	size_ += boxes_.size() * sizeof(double) + indices_.size() * sizeof(int);
+	dirty_ = false;
+}
+
+//item positions (in insertion order) whose box intersects box
+void SpatialIndex::search(const double *box, std::vector<int> &items)
+{
+	if (dirty_) build();
+	if (indices_.empty()) return;
+
+	std::vector<std::pair<int, int> > stack; //node, level
+	stack.push_back(std::make_pair((int) indices_.size() - 1, (int) level_bounds_.size() - 1));
+	while (!stack.empty()) {
+		int node = stack.back().first;
+		int level = stack.back().second;
+		stack.pop_back();
+
+		if (!boxesIntersect(&boxes_[node * 4], box)) continue;
+		if (level == 0) {
+			items.push_back(indices_[node]);
+			continue;
+		}
+		int end = std::min(indices_[node] + node_size_, (int) level_bounds_[level - 1]);
+		for (int child = indices_[node]; child < end; child++) {
+			stack.push_back(std::make_pair(child, level - 1));
+		}
+	}
+
+	std::sort(items.begin(), items.end());
+}
+
+Handle<Value> SpatialIndex::count(const Arguments& args)
+{
+	HandleScope scope;
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+
+	return scope.Close(Integer::New(index->item_ids_.size()));
+}
+
+Handle<Value> SpatialIndex::insert(const Arguments& args)
+{
+	HandleScope scope;
+
+	int id;
+	NODE_ARG_INT(0, "id", id);
+	if (args.Length() < 2) {
+		return NODE_THROW("envelope or geometry must be given");
+	}
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+
+	double box[4];
+	if (IS_WRAPPED(args[1], Geometry)) {
+		OGRGeometry *geom = ObjectWrap::Unwrap<Geometry>(args[1]->ToObject())->get();
+		if (!geometryBox(geom, box)) {
+			return NODE_THROW("geometry must not be empty");
+		}
+		//a copy, so the index stays valid whatever happens to the geometry
+		index->add(id, box, geom->clone());
+	} else {
+		std::string err = parseBox(args[1], box);
+		if (!err.empty()) {
+			return NODE_THROW(err.c_str());
+		}
+		index->add(id, box, NULL);
+	}
+
+	return Undefined();
+}
+
+//NaN boxes and NULL / empty geometries are skipped
+Handle<Value> SpatialIndex::bulkLoad(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> items_obj;
+	Handle<Object> ids_obj;
+	NODE_ARG_OBJECT(0, "boxes", items_obj);
+	if (args.Length() > 1 && !args[1]->IsUndefined() && !args[1]->IsNull()) {
+		NODE_ARG_OBJECT(1, "ids", ids_obj);
+	}
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+
+	GeometryArray *array = NULL;
+	double *boxes = NULL;
+	int n;
+	if (IS_WRAPPED(items_obj, GeometryArray)) {
+		array = ObjectWrap::Unwrap<GeometryArray>(items_obj);
+		n = array->get().size();
+	} else if (TypedArray::Identify(items_obj) == GDT_Float64 && TypedArray::Length(items_obj) % 4 == 0) {
+		boxes = static_cast<double*>(TypedArray::Data(items_obj));
+		n = TypedArray::Length(items_obj) / 4;
+	} else {
+		return NODE_THROW("boxes must be a GeometryArray or a Float64Array of [minX, minY, maxX, maxY] boxes");
+	}
+
+	//ids default to the position in the array
+	int *ids = NULL;
+	if (!ids_obj.IsEmpty()) {
+		if (TypedArray::Identify(ids_obj) != GDT_Int32 || TypedArray::Length(ids_obj) != n) {
+			return NODE_THROW("ids must be an Int32Array with one id per box");
+		}
+		ids = static_cast<int*>(TypedArray::Data(ids_obj));
+	}
+
+	index->item_boxes_.reserve(index->item_boxes_.size() + n * 4);
+	index->item_ids_.reserve(index->item_ids_.size() + n);
+	index->item_geoms_.reserve(index->item_geoms_.size() + n);
+
+	double box[4];
+	for (int i = 0; i < n; i++) {
+		int id = ids ? ids[i] : i;
+		if (array) {
+			OGRGeometry *geom = array->get()[i];
+			if (!geometryBox(geom, box)) continue;
+			index->add(id, box, geom->clone());
+		} else {
+			double *b = boxes + i * 4;
+			if (CPLIsNan(b[0]) || CPLIsNan(b[1]) || CPLIsNan(b[2]) || CPLIsNan(b[3])) continue;
+			index->add(id, b, NULL);
+		}
+	}
+
+	return Undefined();
+}
+
+Handle<Value> SpatialIndex::query(const Arguments& args)
+{
+	HandleScope scope;
+
+	double box[4];
+	std::string err = parseBox(args[0], box);
+	if (!err.empty()) {
+		return NODE_THROW(err.c_str());
+	}
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+
+	std::vector<int> items;
+	index->search(box, items);
+
+	Handle<Value> result = TypedArray::New(GDT_Int32, items.size());
+	if (result.IsEmpty() || !result->IsObject()) {
+		return scope.Close(result); //TypedArray::New threw an error
+	}
+	int *data = static_cast<int*>(TypedArray::Data(result->ToObject()));
+	for (unsigned int i = 0; i < items.size(); i++) {
+		data[i] = index->item_ids_[items[i]];
+	}
+
+	return scope.Close(result);
+}
+
+//candidates from the tree are tested exactly against the prepared query geometry;
+//items inserted without a geometry are tested as their box
+Handle<Value> SpatialIndex::queryGeometry(const Arguments& args)
+{
+	HandleScope scope;
+
+	Geometry *geom;
+	std::string predicate = "intersects";
+	NODE_ARG_WRAPPED(0, "geometry", Geometry, geom);
+	NODE_ARG_OPT_STR(1, "predicate", predicate);
+
+	int op;
+	if (predicate == "intersects") {
+		op = PreparedGeometry::INTERSECTS;
+	} else if (predicate == "contains") {
+		op = PreparedGeometry::CONTAINS;
+	} else if (predicate == "containsProperly") {
+		op = PreparedGeometry::CONTAINS_PROPERLY;
+	} else if (predicate == "covers") {
+		op = PreparedGeometry::COVERS;
+	} else if (predicate == "within") {
+		op = PreparedGeometry::WITHIN;
+	} else {
+		return NODE_THROW("predicate must be 'intersects', 'contains', 'containsProperly', 'covers' or 'within'");
+	}
+
+	double box[4];
+	if (!geometryBox(geom->get(), box)) {
+		return NODE_THROW("geometry must not be empty");
+	}
+
+	Handle<Value> prepared_obj = PreparedGeometry::New(geom->get());
+	if (prepared_obj.IsEmpty() || !prepared_obj->IsObject()) {
+		return scope.Close(prepared_obj); //PreparedGeometry::New threw an error
+	}
+	PreparedGeometry *prepared = ObjectWrap::Unwrap<PreparedGeometry>(prepared_obj->ToObject());
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+
+	std::vector<int> items;
+	index->search(box, items);
+
+	OGRLinearRing *ring = new OGRLinearRing();
+	ring->setNumPoints(5);
+	OGRPolygon item_box;
+	item_box.addRingDirectly(ring);
+
+	std::vector<int> ids;
+	CPLErrorReset();
+	for (unsigned int i = 0; i < items.size(); i++) {
+		OGRGeometry *candidate = index->item_geoms_[items[i]];
+		if (!candidate) {
+			const double *b = &index->item_boxes_[items[i] * 4];
+			ring->setPoint(0, b[0], b[1]);
+			ring->setPoint(1, b[2], b[1]);
+			ring->setPoint(2, b[2], b[3]);
+			ring->setPoint(3, b[0], b[3]);
+			ring->setPoint(4, b[0], b[1]);
+			candidate = &item_box;
+		}
+
+		char result = prepared->evaluate(op, candidate);
+		if (result == 2) {
+			const char *msg = CPLGetLastErrorMsg();
+			return NODE_THROW(msg[0] ? msg : "Error evaluating predicate");
+		}
+		if (result) ids.push_back(index->item_ids_[items[i]]);
+	}
+
+	Handle<Value> result = TypedArray::New(GDT_Int32, ids.size());
+	if (result.IsEmpty() || !result->IsObject()) {
+		return scope.Close(result); //TypedArray::New threw an error
+	}
+	if (!ids.empty()) {
+		std::memcpy(TypedArray::Data(result->ToObject()), &ids[0], ids.size() * sizeof(int));
+	}
+
+	return scope.Close(result);
+}
+
+struct NearestEntry {
+	double distance;
+	int node;
+	int level; //-1 once an item's exact distance is known
+	bool operator<(const NearestEntry &other) const {
+		return distance > other.distance; //closest first in a priority_queue
+	}
+};
+
+//best-first search: nodes and items are visited by distance to their box,
+//items with a geometry are pushed back with their exact distance
+Handle<Value> SpatialIndex::nearest(const Arguments& args)
+{
+	HandleScope scope;
+
+	double x, y;
+	int k = 1;
+	NODE_ARG_DOUBLE(0, "x", x);
+	NODE_ARG_DOUBLE(1, "y", y);
+	NODE_ARG_INT_OPT(2, "k", k);
+	if (k < 0) {
+		return NODE_THROW("k must not be negative");
+	}
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+	if (index->dirty_) index->build();
+
+	std::vector<int> ids;
+	std::priority_queue<NearestEntry> queue;
+	OGRPoint point(x, y);
+
+	if (!index->indices_.empty() && k > 0) {
+		NearestEntry root;
+		root.node = index->indices_.size() - 1;
+		root.level = index->level_bounds_.size() - 1;
+		root.distance = boxDistance(&index->boxes_[root.node * 4], x, y);
+		queue.push(root);
+	}
+
+	while (!queue.empty() && (int) ids.size() < k) {
+		NearestEntry entry = queue.top();
+		queue.pop();
+
+		if (entry.level == -1) {
+			ids.push_back(index->item_ids_[entry.node]);
+			continue;
+		}
+		if (entry.level == 0) {
+			int item = index->indices_[entry.node];
+			OGRGeometry *geom = index->item_geoms_[item];
+			NearestEntry exact;
+			exact.node = item;
+			exact.level = -1;
+			exact.distance = geom ? geom->Distance(&point) : -1;
+			//Distance() is -1 without GEOS, the box distance is the best we have then
+			if (exact.distance < 0) exact.distance = entry.distance;
+			queue.push(exact);
+			continue;
+		}
+
+		int end = std::min(index->indices_[entry.node] + index->node_size_, (int) index->level_bounds_[entry.level - 1]);
+		for (int child = index->indices_[entry.node]; child < end; child++) {
+			NearestEntry next;
+			next.node = child;
+			next.level = entry.level - 1;
+			next.distance = boxDistance(&index->boxes_[child * 4], x, y);
+			queue.push(next);
+		}
+	}
+
+	Handle<Value> result = TypedArray::New(GDT_Int32, ids.size());
+	if (result.IsEmpty() || !result->IsObject()) {
+		return scope.Close(result); //TypedArray::New threw an error
+	}
+	if (!ids.empty()) {
+		std::memcpy(TypedArray::Data(result->ToObject()), &ids[0], ids.size() * sizeof(int));
+	}
+
+	return scope.Close(result);
+}
+
+Handle<Value> SpatialIndex::toBuffer(const Arguments& args)
+{
+	HandleScope scope;
+
+	SpatialIndex *index = ObjectWrap::Unwrap<SpatialIndex>(args.This());
+	if (index->dirty_) index->build();
+
+	unsigned int n_items = index->item_ids_.size();
+	unsigned int n_nodes = index->indices_.size();
+	unsigned int n_levels = index->level_bounds_.size();
+
+	std::vector<unsigned int> wkb_offsets(n_items + 1, 0);
+	double wkb_size = 0;
+	for (unsigned int i = 0; i < n_items; i++) {
+		if (index->item_geoms_[i]) wkb_size += index->item_geoms_[i]->WkbSize();
+		wkb_offsets[i + 1] = (unsigned int) wkb_size;
+	}
+
+	double total = SERIALIZED_HEADER_SIZE
+		+ (double) n_nodes * (4 * sizeof(double) + sizeof(int))
+		+ (double) n_levels * sizeof(unsigned int)
+		+ (double) n_items * sizeof(int)
+		+ (double) (n_items + 1) * sizeof(unsigned int)
+		+ wkb_size;
+	if (total > 0x7fffffff) {
+		return NODE_THROW("Spatial index is too large to serialize");
+	}
+
+	unsigned char *data;
+	Handle<Value> result = FastBuffer::New((int) total, &data);
+
+	unsigned int header[5] = {SERIALIZED_VERSION, (unsigned int) index->node_size_, n_items, n_nodes, n_levels};
+	std::memcpy(data, SERIALIZED_MAGIC, 4);
+	std::memcpy(data + 4, header, sizeof(header));
+	unsigned char *p = data + SERIALIZED_HEADER_SIZE;
+
+	if (n_nodes) {
+		std::memcpy(p, &index->boxes_[0], n_nodes * 4 * sizeof(double));
+		p += n_nodes * 4 * sizeof(double);
+		std::memcpy(p, &index->indices_[0], n_nodes * sizeof(int));
+		p += n_nodes * sizeof(int);
+		std::memcpy(p, &index->level_bounds_[0], n_levels * sizeof(unsigned int));
+		p += n_levels * sizeof(unsigned int);
+		std::memcpy(p, &index->item_ids_[0], n_items * sizeof(int));
+		p += n_items * sizeof(int);
+	}
+	std::memcpy(p, &wkb_offsets[0], (n_items + 1) * sizeof(unsigned int));
+	p += (n_items + 1) * sizeof(unsigned int);
+
+	for (unsigned int i = 0; i < n_items; i++) {
+		if (!index->item_geoms_[i]) continue;
+		OGRErr err = index->item_geoms_[i]->exportToWkb(wkbNDR, p + wkb_offsets[i]);
+		if (err) {
+			return NODE_THROW_OGRERR(err);
+		}
+	}
+
+	return scope.Close(result);
+}
+
+//restores a toBuffer() result into this (empty) index, returns an error message on failure
+std::string SpatialIndex::load(const unsigned char *data, size_t length)
+{
+	unsigned int header[5];
+	if (length < SERIALIZED_HEADER_SIZE || std::memcmp(data, SERIALIZED_MAGIC, 4) != 0) {
+		return "Buffer is not a serialized SpatialIndex";
+	}
+	std::memcpy(header, data + 4, sizeof(header));
+	if (header[0] != SERIALIZED_VERSION) {
+		return "Unsupported SpatialIndex version or byte order";
+	}
+
+	unsigned int node_size = header[1];
+	unsigned int n_items = header[2];
+	unsigned int n_nodes = header[3];
+	unsigned int n_levels = header[4];
+	if (node_size < 2 || node_size > 256 || n_nodes < n_items || (n_items == 0) != (n_nodes == 0) ||
+	    (n_levels == 0) != (n_nodes == 0) || n_levels > n_nodes) {
+		return "Corrupt SpatialIndex header";
+	}
+
+	double expected = SERIALIZED_HEADER_SIZE
+		+ (double) n_nodes * (4 * sizeof(double) + sizeof(int))
+		+ (double) n_levels * sizeof(unsigned int)
+		+ (double) n_items * sizeof(int)
+		+ (double) (n_items + 1) * sizeof(unsigned int);
+	if (expected > length) {
+		return "SpatialIndex buffer is truncated";
+	}
+
+	const unsigned char *p = data + SERIALIZED_HEADER_SIZE;
+	node_size_ = node_size;
+
+	boxes_.resize(n_nodes * 4);
+	indices_.resize(n_nodes);
+	level_bounds_.resize(n_levels);
+	item_ids_.resize(n_items);
+	if (n_nodes) {
+		std::memcpy(&boxes_[0], p, n_nodes * 4 * sizeof(double));
+		p += n_nodes * 4 * sizeof(double);
+		std::memcpy(&indices_[0], p, n_nodes * sizeof(int));
+		p += n_nodes * sizeof(int);
+		std::memcpy(&level_bounds_[0], p, n_levels * sizeof(unsigned int));
+		p += n_levels * sizeof(unsigned int);
+		std::memcpy(&item_ids_[0], p, n_items * sizeof(int));
+		p += n_items * sizeof(int);
+	}
+	std::vector<unsigned int> wkb_offsets(n_items + 1);
+	std::memcpy(&wkb_offsets[0], p, (n_items + 1) * sizeof(unsigned int));
+	p += (n_items + 1) * sizeof(unsigned int);
+
+	//the traversal trusts the tree structure, so check it before using it
+	if (n_nodes && (level_bounds_[0] != n_items || level_bounds_[n_levels - 1] != n_nodes)) {
+		return "Corrupt SpatialIndex tree";
+	}
+	for (unsigned int level = 1; level < n_levels; level++) {
+		if (level_bounds_[level] <= level_bounds_[level - 1]) return "Corrupt SpatialIndex tree";
+	}
+	if (n_nodes && level_bounds_[n_levels - 1] - (n_levels > 1 ? level_bounds_[n_levels - 2] : 0) != 1) {
+		return "Corrupt SpatialIndex tree"; //the top level is the root
+	}
+	for (unsigned int level = 0; level < n_levels; level++) {
+		unsigned int start = level ? level_bounds_[level - 1] : 0;
+		unsigned int child_start = level > 1 ? level_bounds_[level - 2] : 0;
+		for (unsigned int node = start; node < level_bounds_[level]; node++) {
+			unsigned int value = indices_[node];
+			bool valid = level == 0 ? value < n_items : (value >= child_start && value < level_bounds_[level - 1]);
+			if (!valid) return "Corrupt SpatialIndex tree";
+		}
+	}
+	//each item has exactly one leaf, with a real box (build() sorts them again after an insert)
+	std::vector<bool> seen(n_items, false);
+	for (unsigned int i = 0; i < n_items; i++) {
+		const double *b = &boxes_[i * 4];
+		if (seen[indices_[i]] || CPLIsNan(b[0]) || CPLIsNan(b[1]) || CPLIsNan(b[2]) || CPLIsNan(b[3])) {
+			return "Corrupt SpatialIndex tree";
+		}
+		seen[indices_[i]] = true;
+	}
+
+	//item boxes (for rebuilding after later inserts) are the leaf boxes
+	item_boxes_.resize(n_items * 4);
+	for (unsigned int i = 0; i < n_items; i++) {
+		std::memcpy(&item_boxes_[indices_[i] * 4], &boxes_[i * 4], 4 * sizeof(double));
+	}
+
+	size_t wkb_length = length - (p - data);
+	item_geoms_.resize(n_items, (OGRGeometry*) NULL);
+	for (unsigned int i = 0; i < n_items; i++) {
+		if (wkb_offsets[i] > wkb_offsets[i + 1] || wkb_offsets[i + 1] > wkb_length) {
+			return "SpatialIndex buffer is truncated";
+		}
+		if (wkb_offsets[i + 1] == wkb_offsets[i]) continue;
+
+		OGRErr err = OGRGeometryFactory::createFromWkb((unsigned char*) p + wkb_offsets[i], NULL, &item_geoms_[i], wkb_offsets[i + 1] - wkb_offsets[i]);
+		if (err) {
+			std::ostringstream msg;
+			msg << "Error parsing geometry " << i << ": " << getOGRErrMsg(err);
+			return msg.str();
+		}
+	}
+
+	size_ = boxes_.size() * sizeof(double) + indices_.size() * sizeof(int)
+		+ n_items * (4 * sizeof(double) + sizeof(int) + sizeof(OGRGeometry*))
+		+ wkb_offsets[n_items];
+	V8::AdjustAmountOfExternalAllocatedMemory(size_);
+	dirty_ = false;
+	return "";
+}
+
+Handle<Value> SpatialIndex::fromBuffer(const Arguments& args)
+{
+	HandleScope scope;
+
+	Handle<Object> buffer;
+	NODE_ARG_OBJECT(0, "buffer", buffer);
+	if (!Buffer::HasInstance(buffer)) {
+		return NODE_THROW("buffer must be a Buffer");
+	}
+
+	SpatialIndex *wrapped = new SpatialIndex(16);
+	std::string err = wrapped->load((unsigned char*) Buffer::Data(buffer), Buffer::Length(buffer));
+	if (!err.empty()) {
+		delete wrapped;
+		return NODE_THROW(err.c_str());
+	}
+
+	v8::Handle<v8::Value> ext = v8::External::New(wrapped);
+	v8::Handle<v8::Object> obj = SpatialIndex::constructor->GetFunction()->NewInstance(1, &ext);
+
+	return scope.Close(obj);
+}
+
+} // namespace node_gdal
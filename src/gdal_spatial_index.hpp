@@ -0,0 +1,71 @@
+#ifndef __NODE_OGR_SPATIAL_INDEX_H__
+#define __NODE_OGR_SPATIAL_INDEX_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// ogr
+#include <ogrsf_frmts.h>
+
+// std
+#include <string>
+#include <vector>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// A packed R-tree of boxes with integer ids (Sort-Tile-Recursive bulk loading).
+// Items can keep a copy of their geometry to refine queries with exact
+// predicates. The tree is rebuilt lazily by the first query after an insert.
+
+class SpatialIndex: public node::ObjectWrap {
+public:
+	static Persistent<FunctionTemplate> constructor;
+	static void Initialize(Handle<Object> target);
+	static Handle<Value> New(const Arguments &args);
+	static Handle<Value> toString(const Arguments &args);
+
+	static Handle<Value> fromBuffer(const Arguments &args);
+	static Handle<Value> toBuffer(const Arguments &args);
+
+	static Handle<Value> count(const Arguments &args);
+	static Handle<Value> insert(const Arguments &args);
+	static Handle<Value> bulkLoad(const Arguments &args);
+	static Handle<Value> query(const Arguments &args);
+	static Handle<Value> queryGeometry(const Arguments &args);
+	static Handle<Value> nearest(const Arguments &args);
+
+	SpatialIndex(int node_size);
+
+private:
+	~SpatialIndex();
+
+	void add(int id, const double *box, OGRGeometry *geom);
+	void build();
+	void search(const double *box, std::vector<int> &items);
+	std::string load(const unsigned char *data, size_t length);
+
+	int node_size_;
+	bool dirty_;
+	int size_;
+
+	//items, in insertion order
+	std::vector<double> item_boxes_;
+	std::vector<int> item_ids_;
+	std::vector<OGRGeometry*> item_geoms_;
+
+	//the tree: leaves (one per item) followed by each level of nodes up to the root.
+	//indices_ holds the item of a leaf, or the position of the first child of a node
+	std::vector<double> boxes_;
+	std::vector<int> indices_;
+	std::vector<unsigned int> level_bounds_;
+};
+
+}
+#endif
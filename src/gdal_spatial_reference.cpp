@@ -142,8 +142,9 @@ Handle<Value> SpatialReference::New(OGRSpatialReference *raw, bool owned)
 	if (!raw) {
 		return v8::Null();
 	}
-	if (cache.has(raw)) {
-		return cache.get(raw);
+	Handle<Object> cached = cache.find(raw);
+	if (!cached.IsEmpty()) {
+		return cached;
 	}
 
 	//make a copy of spatialreference owned by a layer, feature, etc
@@ -0,0 +1,473 @@
+
+#include "gdal_common.hpp"
+#include "gdal_warper.hpp"
+#include "gdal_dataset.hpp"
+#include "gdal_geometry.hpp"
+#include "async_worker.hpp"
+
+#include <ogr_spatialref.h>
+
+// std
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+void Warper::Initialize(Handle<Object> target)
+{
+	NODE_SET_METHOD(target, "reprojectImage", reprojectImage);
+	NODE_SET_METHOD(target, "reprojectImageAsync", reprojectImageAsync);
+}
+
+// maps georeferenced coordinates to pixel/line coordinates of a dataset
+// (GDALWarpOptions::hCutline must be given in source pixel coordinates)
+class InvGeoTransformCT : public OGRCoordinateTransformation {
+public:
+	InvGeoTransformCT(double *inv_geotransform)
+	{
+		memcpy(gt, inv_geotransform, sizeof(gt));
+	}
+
+	OGRSpatialReference *GetSourceCS() { return NULL; }
+	OGRSpatialReference *GetTargetCS() { return NULL; }
+
+	int Transform(int count, double *x, double *y, double *z = NULL)
+	{
+		return TransformEx(count, x, y, z, NULL);
+	}
+
+	int TransformEx(int count, double *x, double *y, double *z = NULL, int *success = NULL)
+	{
+		for (int i = 0; i < count; i++) {
+			double px = gt[0] + x[i] * gt[1] + y[i] * gt[2];
+			double py = gt[3] + x[i] * gt[4] + y[i] * gt[5];
+			x[i] = px;
+			y[i] = py;
+			if (success) success[i] = TRUE;
+		}
+		return TRUE;
+	}
+
+private:
+	double gt[6];
+};
+
+struct WarpJob {
+	Dataset *src;
+	Dataset *dst;
+	std::vector<int> src_bands;
+	std::vector<int> dst_bands;
+	GDALResampleAlg resampling;
+	double memory_limit;
+	std::string threads;
+	bool multithread;
+	bool has_src_nodata, has_dst_nodata;
+	double src_nodata, dst_nodata;
+	OGRGeometry *cutline; //georeferenced, owned by the job
+	GDALProgressFunc progress;
+	void *progress_arg;
+
+	WarpJob()
+		: src(NULL), dst(NULL), resampling(GRA_NearestNeighbour), memory_limit(0), threads(""),
+		  multithread(false), has_src_nodata(false), has_dst_nodata(false), src_nodata(0), dst_nodata(0),
+		  cutline(NULL), progress(NULL), progress_arg(NULL)
+	{}
+
+	~WarpJob()
+	{
+		if (cutline) OGRGeometryFactory::destroyGeometry(cutline);
+	}
+};
+
+static bool parseResampling(std::string name, GDALResampleAlg &alg)
+{
+	for (unsigned int i = 0; i < name.length(); i++) {
+		name[i] = tolower(name[i]);
+	}
+	if (name == "near" || name == "nearestneighbour" || name == "nearest") {
+		alg = GRA_NearestNeighbour;
+	} else if (name == "bilinear") {
+		alg = GRA_Bilinear;
+	} else if (name == "cubic") {
+		alg = GRA_Cubic;
+	} else if (name == "cubicspline") {
+		alg = GRA_CubicSpline;
+	} else if (name == "lanczos") {
+		alg = GRA_Lanczos;
+	} else if (name == "average") {
+		alg = GRA_Average;
+	} else if (name == "mode") {
+		alg = GRA_Mode;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static std::string parseBands(Handle<Value> val, const char *name, int n_bands, std::vector<int> &bands)
+{
+	if (val->IsUndefined() || val->IsNull()) return "";
+	if (!val->IsArray()) {
+		return std::string(name) + " must be an array of band numbers";
+	}
+	Handle<Array> array = Handle<Array>::Cast(val);
+	for (unsigned int i = 0; i < array->Length(); i++) {
+		Handle<Value> band = array->Get(i);
+		if (!band->IsInt32() || band->Int32Value() < 1 || band->Int32Value() > n_bands) {
+			return std::string(name) + " contains an invalid band number";
+		}
+		bands.push_back(band->Int32Value());
+	}
+	return "";
+}
+
+//reads the options object given to reprojectImage(). returns an error message or ""
+static std::string parseWarpOptions(Handle<Object> options, WarpJob &job)
+{
+	HandleScope scope;
+
+	Handle<Value> src_obj = options->Get(String::NewSymbol("src"));
+	Handle<Value> dst_obj = options->Get(String::NewSymbol("dst"));
+	if (!Dataset::constructor->HasInstance(src_obj)) {
+		return "src must be an instance of Dataset";
+	}
+	if (!Dataset::constructor->HasInstance(dst_obj)) {
+		return "dst must be an instance of Dataset";
+	}
+	job.src = ObjectWrap::Unwrap<Dataset>(src_obj->ToObject());
+	job.dst = ObjectWrap::Unwrap<Dataset>(dst_obj->ToObject());
+	if (!job.src->getDataset() || !job.dst->getDataset()) {
+		return "Dataset object has already been destroyed";
+	}
+
+	int n_src_bands = job.src->getDataset()->GetRasterCount();
+	int n_dst_bands = job.dst->getDataset()->GetRasterCount();
+
+	std::string err;
+	err = parseBands(options->Get(String::NewSymbol("srcBands")), "srcBands", n_src_bands, job.src_bands);
+	if (!err.empty()) return err;
+	err = parseBands(options->Get(String::NewSymbol("dstBands")), "dstBands", n_dst_bands, job.dst_bands);
+	if (!err.empty()) return err;
+
+	if (job.src_bands.empty()) {
+		for (int i = 1; i <= n_src_bands; i++) job.src_bands.push_back(i);
+	}
+	if (job.dst_bands.empty()) {
+		job.dst_bands = job.src_bands;
+		for (unsigned int i = 0; i < job.dst_bands.size(); i++) {
+			if (job.dst_bands[i] > n_dst_bands) {
+				return "dst does not have enough bands, specify dstBands";
+			}
+		}
+	}
+	if (job.src_bands.size() != job.dst_bands.size()) {
+		return "srcBands and dstBands must have the same length";
+	}
+	if (job.src_bands.empty()) {
+		return "src does not have any bands";
+	}
+
+	Handle<Value> val = options->Get(String::NewSymbol("resampling"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsString() || !parseResampling(TOSTR(val), job.resampling)) {
+			return "Invalid resampling algorithm";
+		}
+	}
+
+	val = options->Get(String::NewSymbol("memoryLimit"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsNumber() || val->NumberValue() < 0) {
+			return "memoryLimit must be a positive number";
+		}
+		job.memory_limit = val->NumberValue();
+	}
+
+	val = options->Get(String::NewSymbol("multithread"));
+	job.multithread = val->IsTrue();
+
+	val = options->Get(String::NewSymbol("threads"));
+	if (val->IsInt32() && val->Int32Value() > 0) {
+		job.threads = TOSTR(val);
+	} else if (val->IsString() && TOSTR(val) == "ALL_CPUS") {
+		job.threads = "ALL_CPUS";
+	} else if (!val->IsUndefined() && !val->IsNull()) {
+		return "threads must be a positive integer or 'ALL_CPUS'";
+	} else if (job.multithread) {
+		job.threads = "ALL_CPUS";
+	}
+
+	val = options->Get(String::NewSymbol("srcNodata"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsNumber()) return "srcNodata must be a number";
+		job.has_src_nodata = true;
+		job.src_nodata = val->NumberValue();
+	}
+
+	val = options->Get(String::NewSymbol("dstNodata"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!val->IsNumber()) return "dstNodata must be a number";
+		job.has_dst_nodata = true;
+		job.dst_nodata = val->NumberValue();
+	}
+
+	val = options->Get(String::NewSymbol("cutline"));
+	if (!val->IsUndefined() && !val->IsNull()) {
+		if (!Geometry::constructor->HasInstance(val)) {
+			return "cutline must be an instance of Geometry";
+		}
+		Geometry *geom = ObjectWrap::Unwrap<Geometry>(val->ToObject());
+		if (!geom->get()) {
+			return "Geometry object has already been destroyed";
+		}
+		OGRwkbGeometryType type = wkbFlatten(geom->get()->getGeometryType());
+		if (type != wkbPolygon && type != wkbMultiPolygon) {
+			return "cutline must be a Polygon or MultiPolygon";
+		}
+		job.cutline = geom->get()->clone();
+	}
+
+	return "";
+}
+
+//converts the cutline from georeferenced coordinates to source pixel coordinates
+static bool transformCutline(GDALDataset *src, OGRGeometry *cutline, std::string &error)
+{
+	const char *wkt = src->GetProjectionRef();
+	OGRSpatialReference *cutline_srs = cutline->getSpatialReference();
+
+	if (cutline_srs && wkt && *wkt) {
+		OGRSpatialReference src_srs(wkt);
+		if (!cutline_srs->IsSame(&src_srs)) {
+			OGRCoordinateTransformation *ct = OGRCreateCoordinateTransformation(cutline_srs, &src_srs);
+			if (!ct) {
+				error = "Unable to transform cutline to the source projection";
+				return false;
+			}
+			OGRErr err = cutline->transform(ct);
+			OGRCoordinateTransformation::DestroyCT(ct);
+			if (err) {
+				error = "Unable to transform cutline to the source projection";
+				return false;
+			}
+		}
+	}
+
+	double gt[6], inv_gt[6];
+	if (src->GetGeoTransform(gt) != CE_None || !GDALInvGeoTransform(gt, inv_gt)) {
+		error = "src must have a valid geotransform to use a cutline";
+		return false;
+	}
+
+	InvGeoTransformCT ct(inv_gt);
+	cutline->assignSpatialReference(NULL);
+	if (cutline->transform(&ct)) {
+		error = "Unable to transform cutline to pixel coordinates";
+		return false;
+	}
+	return true;
+}
+
+//runs the warp. the caller must hold the locks of both datasets
+static bool runWarp(WarpJob &job, std::string &error)
+{
+	GDALDataset *src = job.src->getDataset();
+	GDALDataset *dst = job.dst->getDataset();
+
+	//the datasets may have been closed while the job was queued
+	if (!src || !dst) {
+		error = "Dataset object has already been destroyed";
+		return false;
+	}
+
+	if (job.cutline && !transformCutline(src, job.cutline, error)) {
+		return false;
+	}
+
+	int n = job.src_bands.size();
+
+	GDALWarpOptions *options = GDALCreateWarpOptions();
+	options->hSrcDS = src;
+	options->hDstDS = dst;
+	options->eResampleAlg = job.resampling;
+	options->dfWarpMemoryLimit = job.memory_limit;
+	options->nBandCount = n;
+	options->panSrcBands = (int *) CPLMalloc(sizeof(int) * n);
+	options->panDstBands = (int *) CPLMalloc(sizeof(int) * n);
+	for (int i = 0; i < n; i++) {
+		options->panSrcBands[i] = job.src_bands[i];
+		options->panDstBands[i] = job.dst_bands[i];
+	}
+
+	if (job.has_src_nodata) {
+		options->padfSrcNoDataReal = (double *) CPLMalloc(sizeof(double) * n);
+		options->padfSrcNoDataImag = (double *) CPLMalloc(sizeof(double) * n);
+		for (int i = 0; i < n; i++) {
+			options->padfSrcNoDataReal[i] = job.src_nodata;
+			options->padfSrcNoDataImag[i] = 0;
+		}
+	}
+	if (job.has_dst_nodata) {
+		options->padfDstNoDataReal = (double *) CPLMalloc(sizeof(double) * n);
+		options->padfDstNoDataImag = (double *) CPLMalloc(sizeof(double) * n);
+		for (int i = 0; i < n; i++) {
+			options->padfDstNoDataReal[i] = job.dst_nodata;
+			options->padfDstNoDataImag[i] = 0;
+		}
+		options->papszWarpOptions = CSLSetNameValue(options->papszWarpOptions, "INIT_DEST", "NO_DATA");
+	}
+	if (!job.threads.empty()) {
+		options->papszWarpOptions = CSLSetNameValue(options->papszWarpOptions, "NUM_THREADS", job.threads.c_str());
+	}
+	if (job.cutline) {
+		//GDALDestroyWarpOptions() takes care of it
+		options->hCutline = job.cutline;
+		job.cutline = NULL;
+	}
+	if (job.progress) {
+		options->pfnProgress = job.progress;
+		options->pProgressArg = job.progress_arg;
+	}
+
+	options->pTransformerArg = GDALCreateGenImgProjTransformer2(src, dst, NULL);
+	if (!options->pTransformerArg) {
+		error = CPLGetLastErrorMsg();
+		GDALDestroyWarpOptions(options);
+		return false;
+	}
+	options->pfnTransformer = GDALGenImgProjTransform;
+
+	GDALWarpOperation operation;
+	CPLErr err = operation.Initialize(options);
+	if (err == CE_None) {
+		int w = dst->GetRasterXSize();
+		int h = dst->GetRasterYSize();
+		if (job.multithread) {
+			err = operation.ChunkAndWarpMulti(0, 0, w, h);
+		} else {
+			err = operation.ChunkAndWarpImage(0, 0, w, h);
+		}
+	}
+
+	if (err != CE_None) {
+		error = CPLGetLastErrorMsg();
+		if (error.empty()) error = "Error reprojecting image";
+	}
+
+	GDALDestroyGenImgProjTransformer(options->pTransformerArg);
+	GDALDestroyWarpOptions(options);
+
+	return err == CE_None;
+}
+
+//locks both datasets, always in the same order so concurrent jobs can't deadlock
+static void lockDatasets(Dataset *a, Dataset *b)
+{
+	if (a == b) {
+		a->lock();
+	} else if (a < b) {
+		a->lock();
+		b->lock();
+	} else {
+		b->lock();
+		a->lock();
+	}
+}
+
+static void unlockDatasets(Dataset *a, Dataset *b)
+{
+	a->unlock();
+	if (a != b) b->unlock();
+}
+
+class WarpWorker : public AsyncProgressWorker {
+public:
+	WarpWorker(Handle<Function> callback, Handle<Function> progress_cb)
+		: AsyncProgressWorker(callback, progress_cb)
+	{
+		job.progress = AsyncProgressWorker::ProgressFunc;
+		job.progress_arg = this;
+	}
+
+	void Execute()
+	{
+		std::string error;
+		lockDatasets(job.src, job.dst);
+		bool ok = runWarp(job, error);
+		unlockDatasets(job.src, job.dst);
+		if (!ok) SetErrorMessage(error.c_str());
+	}
+
+	WarpJob job;
+};
+
+Handle<Value> Warper::reprojectImage(const Arguments &args)
+{
+	HandleScope scope;
+
+	Handle<Object> options;
+	NODE_ARG_OBJECT(0, "options", options);
+
+	WarpJob job;
+	std::string error = parseWarpOptions(options, job);
+	if (!error.empty()) {
+		return NODE_THROW(error.c_str());
+	}
+
+	Handle<Function> progress_cb;
+	Handle<Value> progress_obj = options->Get(String::NewSymbol("progress"));
+	if (progress_obj->IsFunction()) {
+		progress_cb = Handle<Function>::Cast(progress_obj);
+		job.progress = SyncProgressFunc;
+		job.progress_arg = &progress_cb;
+		//ChunkAndWarpMulti() warps chunks (and reports progress) on its own threads,
+		//the JS callback can only be called from this one
+		job.multithread = false;
+	}
+
+	TryCatch try_catch;
+
+	lockDatasets(job.src, job.dst);
+	bool ok = runWarp(job, error);
+	unlockDatasets(job.src, job.dst);
+
+	if (try_catch.HasCaught()) {
+		return try_catch.ReThrow();
+	}
+	if (!ok) {
+		return NODE_THROW(error.c_str());
+	}
+
+	return Undefined();
+}
+
+Handle<Value> Warper::reprojectImageAsync(const Arguments &args)
+{
+	HandleScope scope;
+
+	Handle<Object> options;
+	Handle<Function> callback;
+	NODE_ARG_OBJECT(0, "options", options);
+	NODE_ARG_CALLBACK(1, "callback", callback);
+
+	Handle<Function> progress_cb;
+	Handle<Value> progress_obj = options->Get(String::NewSymbol("progress"));
+	if (progress_obj->IsFunction()) {
+		progress_cb = Handle<Function>::Cast(progress_obj);
+	}
+
+	WarpWorker *worker = new WarpWorker(callback, progress_cb);
+	std::string error = parseWarpOptions(options, worker->job);
+	if (!error.empty()) {
+		worker->Destroy();
+		return NODE_THROW(error.c_str());
+	}
+
+	//keep the datasets alive until the warp is done
+	worker->SaveToPersistent("src", options->Get(String::NewSymbol("src")));
+	worker->SaveToPersistent("dst", options->Get(String::NewSymbol("dst")));
+	AsyncWorker::Queue(worker);
+
+	return Undefined();
+}
+
+} // namespace node_gdal
@@ -0,0 +1,31 @@
+#ifndef __NODE_GDAL_WARPER_H__
+#define __NODE_GDAL_WARPER_H__
+
+// v8
+#include <v8.h>
+
+// node
+#include <node.h>
+
+// gdal
+#include <gdal_priv.h>
+#include <gdalwarper.h>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Image reprojection through GDALWarpOperation (gdal.reprojectImage)
+
+namespace Warper {
+
+	void Initialize(Handle<Object> target);
+
+	Handle<Value> reprojectImage(const Arguments &args);
+	Handle<Value> reprojectImageAsync(const Arguments &args);
+
+}
+
+}
+#endif
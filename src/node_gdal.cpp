@@ -27,10 +27,15 @@
 #include "gdal_linestring.hpp"
 #include "gdal_linearring.hpp"
 #include "gdal_geometrycollection.hpp"
+#include "gdal_geometry_array.hpp"
+#include "gdal_prepared_geometry.hpp"
+#include "gdal_spatial_index.hpp"
 #include "gdal_multipoint.hpp"
 #include "gdal_multilinestring.hpp"
 #include "gdal_multipolygon.hpp"
 #include "gdal_geometry.hpp"
+#include "gdal_warper.hpp"
+#include "gdal_algorithms.hpp"
 
 #include "gdal.hpp"
 #include "field_types.hpp"
@@ -47,6 +52,7 @@
 #include "collections/linestring_points.hpp"
 #include "collections/rasterband_overviews.hpp"
 #include "collections/rasterband_pixels.hpp"
+#include "collections/rasterband_blocks.hpp"
 #include "collections/gdal_drivers.hpp"
 
 // std
@@ -60,18 +66,21 @@ namespace node_gdal {
 	using namespace v8;
 
 	FILE *log_file = NULL;
+	CPLErrorHandler error_handler = CPLDefaultErrorHandler;
 
 	extern "C" {
 
 		static Handle<Value> QuietOutput(const Arguments &args)
 		{
-			CPLSetErrorHandler(CPLQuietErrorHandler);
+			error_handler = CPLQuietErrorHandler;
+			CPLSetErrorHandler(error_handler);
 			return Undefined();
 		}
 
 		static Handle<Value> VerboseOutput(const Arguments &args)
 		{
-			CPLSetErrorHandler(CPLDefaultErrorHandler);
+			error_handler = CPLDefaultErrorHandler;
+			CPLSetErrorHandler(error_handler);
 			return Undefined();
 		}
 
@@ -111,10 +120,14 @@ namespace node_gdal {
 		{
 
 			NODE_SET_METHOD(target, "open", open);
+			NODE_SET_METHOD(target, "openBuffer", openBuffer);
 			NODE_SET_METHOD(target, "setConfigOption", setConfigOption);
 			NODE_SET_METHOD(target, "getConfigOption", getConfigOption);
 			NODE_SET_METHOD(target, "decToDMS", decToDMS);
 
+			Warper::Initialize(target);
+			Algorithms::Initialize(target);
+
 			MajorObject::Initialize(target);
 			Driver::Initialize(target);
 			Dataset::Initialize(target);
@@ -133,6 +146,9 @@ namespace node_gdal {
 			MultiPoint::Initialize(target);
 			MultiLineString::Initialize(target);
 			MultiPolygon::Initialize(target);
+			GeometryArray::Initialize(target);
+			PreparedGeometry::Initialize(target);
+			SpatialIndex::Initialize(target);
 			SpatialReference::Initialize(target);
 			CoordinateTransformation::Initialize(target);
 
@@ -147,6 +163,7 @@ namespace node_gdal {
 			LineStringPoints::Initialize(target);
 			RasterBandOverviews::Initialize(target);
 			RasterBandPixels::Initialize(target);
+			RasterBandBlocks::Initialize(target);
 
 			//calls GDALRegisterAll()
 			GDALDrivers::Initialize(target);
@@ -1,4 +1,3 @@
-
 #ifndef __OBJ_CACHE_H__
 #define __OBJ_CACHE_H__
 
@@ -9,19 +8,26 @@
 #include <node.h>
 #include <node_object_wrap.h>
 
-#include <map>
+#include <vector>
+#include <stdint.h>
 
 #include "gdal_common.hpp"
 
 template <typename K>
-struct ObjectCacheItem {
-	v8::Persistent<v8::Object> handle;
-	K key;
-	K alias;
+struct ObjectCacheSlot {
+	K key;                             //NULL if the slot is empty
+	K link;                            //alias of the key, or the key an alias points to
+	bool is_alias;
+	v8::Persistent<v8::Object> handle; //empty for aliases
 };
 
 // a class for maintaining a map of native pointers and persistent JS handles
 // objects are removed from cache and their destructor is called when they go out of scope
+//
+// entries live in an open-addressing hash table (linear probing, backward shift
+// deletion) so lookups don't allocate and touch a single cache line in the
+// common case. the weak callback only needs the handle it's given, so no
+// per-entry state is allocated for it.
 
 template <typename K>
 class ObjectCache {
@@ -31,33 +37,32 @@ public:
 	void add(K key, K alias, v8::Handle<v8::Object> obj);
 
 	//fetch the V8 obj that wraps the native pointer (or alias)
-	//call has() before calling to get() to ensure handle exists
-	v8::Handle<v8::Object> get(K key);
+	//returns an empty handle if it hasn't been wrapped
+	v8::Handle<v8::Object> find(K key);
 
-	//check if native pointer has been wrapped, or if an alias wraps it
-	bool has(K key);
 	void erase(K key);
 
 	ObjectCache();
 	~ObjectCache();
 
 private:
-	ObjectCacheItem<K> getItem(K key);
-	void erase(ObjectCacheItem<K> key);
+	static const size_t npos = (size_t) -1;
+
+	size_t hash(K key);
+	size_t indexOf(K key);
+	void insert(const ObjectCacheSlot<K> &slot);
+	void remove(size_t i);
+	void grow();
 	static void WeakCallback(v8::Persistent<v8::Value> object, void *parameter);
-	std::map<K, ObjectCacheItem<K> > cache;
-	std::map<K, K> aliases;
-};
 
-template <typename K>
-struct CallbackParameters {
-	ObjectCacheItem<K> item;
-	ObjectCache<K> *cache;
+	std::vector<ObjectCacheSlot<K> > slots;
+	size_t mask;
+	size_t count;
 };
 
 template <typename K>
 ObjectCache<K>::ObjectCache()
-	: cache(), aliases()
+	: slots(), mask(0), count(0)
 {
 }
 
@@ -67,74 +72,166 @@ ObjectCache<K>::~ObjectCache()
 }
 
 template <typename K>
-void ObjectCache<K>::add(K key, K alias, v8::Handle<v8::Object> obj)
+size_t ObjectCache<K>::hash(K key)
 {
-	ObjectCacheItem<K> item;
-	item.key    = key;
-	item.alias  = alias;
-	item.handle = v8::Persistent<v8::Object>::New(obj);
-
-	CallbackParameters<K> *params = (CallbackParameters<K>*) malloc(sizeof(CallbackParameters<K>)) ;
-	params->item  = item;
-	params->cache = this;
+	//pointers are aligned, so mix the high bits into the low ones (fibonacci hashing)
+	uint64_t p = (uint64_t) (uintptr_t) key;
+	p *= 0x9E3779B97F4A7C15ULL;
+	return (size_t) (p ^ (p >> 32));
+}
 
-	item.handle.MakeWeak(params, ObjectCache::WeakCallback);
+template <typename K>
+size_t ObjectCache<K>::indexOf(K key)
+{
+	if (slots.empty() || !key) return npos;
 
-	//add it to the map
-	cache[key] = item;
-	if(alias) {
-		aliases[alias] = key;
+	size_t i = hash(key) & mask;
+	while (slots[i].key) {
+		if (slots[i].key == key) return i;
+		i = (i + 1) & mask;
 	}
+	return npos;
 }
 
-
 template <typename K>
-void ObjectCache<K>::add(K key, v8::Handle<v8::Object> obj)
+void ObjectCache<K>::insert(const ObjectCacheSlot<K> &slot)
 {
-	add(key, NULL, obj);
+	//keep the load factor under 1/2 so probe sequences stay short
+	if ((count + 1) * 2 > slots.size()) {
+		grow();
+	}
+
+	size_t i = hash(slot.key) & mask;
+	while (slots[i].key && slots[i].key != slot.key) {
+		i = (i + 1) & mask;
+	}
+	if (!slots[i].key) {
+		count++;
+	} else if (!slots[i].handle.IsEmpty()) {
+		//the key was wrapped again, the previous handle would otherwise leak
+		slots[i].handle.Dispose();
+		slots[i].handle.Clear();
+	}
+	slots[i] = slot;
 }
 
 template <typename K>
-bool ObjectCache<K>::has(K key)
+void ObjectCache<K>::grow()
 {
-	return cache.count(key) > 0 || aliases.count(key) > 0;
+	std::vector<ObjectCacheSlot<K> > old;
+	old.swap(slots);
+
+	ObjectCacheSlot<K> empty;
+	empty.key      = NULL;
+	empty.link     = NULL;
+	empty.is_alias = false;
+
+	size_t size = old.empty() ? 16 : old.size() * 2;
+	slots.assign(size, empty);
+	mask  = size - 1;
+	count = 0;
+
+	for (size_t i = 0; i < old.size(); i++) {
+		if (old[i].key) insert(old[i]);
+	}
 }
 
 template <typename K>
-v8::Handle<v8::Object> ObjectCache<K>::get(K key)
+void ObjectCache<K>::remove(size_t i)
 {
-	return getItem(key).handle;
+	//backward shift deletion: pull later entries of the probe sequence into the hole
+	size_t j = i;
+	while (true) {
+		slots[i].key = NULL;
+		while (true) {
+			j = (j + 1) & mask;
+			if (!slots[j].key) {
+				count--;
+				return;
+			}
+			size_t k = hash(slots[j].key) & mask;
+			//move slot j into the hole unless its home lies cyclically in (i, j]
+			bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+			if (!stays) break;
+		}
+		slots[i] = slots[j];
+		i = j;
+	}
 }
 
 template <typename K>
-ObjectCacheItem<K> ObjectCache<K>::getItem(K key)
+void ObjectCache<K>::add(K key, K alias, v8::Handle<v8::Object> obj)
 {
-	//return handle to existing object if already wrapped
-	//check by calling has() first
-	if (aliases.count(key) > 0) {
-		key = aliases[key];
+	ObjectCacheSlot<K> slot;
+	slot.key      = key;
+	slot.link     = alias;
+	slot.is_alias = false;
+	slot.handle   = v8::Persistent<v8::Object>::New(obj);
+	slot.handle.MakeWeak(this, ObjectCache::WeakCallback);
+
+	insert(slot);
+
+	//an alias never replaces the entry of another live object
+	size_t existing = indexOf(alias);
+	if (alias && (existing == npos || slots[existing].is_alias)) {
+		ObjectCacheSlot<K> alias_slot;
+		alias_slot.key      = alias;
+		alias_slot.link     = key;
+		alias_slot.is_alias = true;
+		insert(alias_slot);
 	}
-	return cache[key];
 }
 
+template <typename K>
+void ObjectCache<K>::add(K key, v8::Handle<v8::Object> obj)
+{
+	add(key, NULL, obj);
+}
 
 template <typename K>
-void ObjectCache<K>::erase(K key)
+v8::Handle<v8::Object> ObjectCache<K>::find(K key)
 {
-	if(has(key)){
-		erase(getItem(key));
+	size_t i = indexOf(key);
+	if (i != npos && slots[i].is_alias) {
+		i = indexOf(slots[i].link);
+	}
+	if (i == npos) {
+		return v8::Handle<v8::Object>();
 	}
+	return slots[i].handle;
 }
 
 template <typename K>
-void ObjectCache<K>::erase(ObjectCacheItem<K> item)
+void ObjectCache<K>::erase(K key)
 {
+	size_t i = indexOf(key);
+	if (i == npos) return;
+
+	if (slots[i].is_alias) {
+		K alias = key;
+		key = slots[i].link;
+		size_t j = indexOf(key);
+		//the key may have been reused since the alias was added, only follow a matching back-link
+		if (j == npos || slots[j].is_alias || slots[j].link != alias) {
+			LOG("ObjectCache erasing stale alias [%p]", alias);
+			remove(i);
+			return;
+		}
+		i = j;
+	}
 
-	LOG("ObjectCache erasing [%p]", item.key);
-	cache.erase(item.key);
-	if(item.alias){
-		LOG("ObjectCache erasing alias [%p]", item.alias);
-		aliases.erase(item.alias);
+	K alias = slots[i].link;
+
+	LOG("ObjectCache erasing [%p]", key);
+	remove(i);
+
+	if (alias) {
+		//the alias address may have been reused as a key (or alias) of another live object
+		i = indexOf(alias);
+		if (i != npos && slots[i].is_alias && slots[i].link == key) {
+			LOG("ObjectCache erasing alias [%p]", alias);
+			remove(i);
+		}
 	}
 }
 
@@ -142,17 +239,12 @@ template <typename K>
 void ObjectCache<K>::WeakCallback(v8::Persistent<v8::Value> object, void *parameter)
 {
 	//called when only reference to object is weak - after garbage collection
-	CallbackParameters<K> *params = (CallbackParameters<K>*) parameter;
-
-	//remove it from the map
-	LOG("ObjectCache Weak Callback [%p]", params->item.key);
-	//params->cache->erase(params->item);
+	//the wrapper's destructor takes care of erasing the entry
+	LOG("ObjectCache Weak Callback [%p]", parameter);
 
 	//clear the reference to it
 	object.Dispose();
 	object.Clear();
-
-	free(params);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,584 @@
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+var assert = require('chai').assert;
+
+describe('gdal', function() {
+	afterEach(gc);
+
+	var createRaster = function(w, h, type, values) {
+		var ds = gdal.open('temp', 'w', 'MEM', w, h, 1, type);
+		ds.geoTransform = [0, 1, 0, h, 0, -1];
+		var data = type === gdal.GDT_Float32 ? new Float32Array(values) : new Uint8Array(values);
+		ds.bands.get(1).pixels.write(0, 0, w, h, data);
+		return ds;
+	};
+	var createLayer = function(field_type) {
+		var ds = gdal.open('', 'w', 'Memory');
+		var layer = ds.layers.create('polygons', null, gdal.Polygon);
+		layer.fields.add(new gdal.FieldDefn('val', field_type || gdal.OFTInteger));
+		return layer;
+	};
+	var fieldValues = function(layer) {
+		var values = [];
+		layer.features.forEach(function(feature) {
+			values.push(feature.fields.get('val'));
+		});
+		return values.sort();
+	};
+
+	describe('polygonize()', function() {
+		var regions = [
+			1, 1, 2, 2,
+			1, 1, 2, 2,
+			3, 3, 2, 2,
+			3, 3, 2, 2
+		];
+
+		it('should write a polygon for each region', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			var layer = createLayer();
+			gdal.polygonize({src: src.bands.get(1), dst: layer, pixValField: 'val'});
+			assert.deepEqual(fieldValues(layer), [1, 2, 3]);
+			layer.features.forEach(function(feature) {
+				var area = feature.getGeometry().getArea();
+				assert.equal(area, feature.fields.get('val') === 2 ? 8 : 4);
+			});
+		});
+		it('should accept the field index', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			var layer = createLayer();
+			gdal.polygonize({src: src.bands.get(1), dst: layer, pixValField: 0});
+			assert.deepEqual(fieldValues(layer), [1, 2, 3]);
+		});
+		it('should respect the mask and connectedness', function() {
+			var src = createRaster(2, 2, gdal.GDT_Byte, [1, 0, 0, 1]);
+			var band = src.bands.get(1);
+
+			var layer = createLayer();
+			gdal.polygonize({src: band, mask: band, dst: layer, connectedness: 4});
+			assert.equal(layer.features.count(), 2);
+
+			layer = createLayer();
+			gdal.polygonize({src: band, mask: band, dst: layer, connectedness: 8});
+			assert.equal(layer.features.count(), 1);
+		});
+		it('should compare floating point bands as floats', function() {
+			var src = createRaster(2, 1, gdal.GDT_Float32, [0.5, 1.5]);
+			var layer = createLayer(gdal.OFTReal);
+			gdal.polygonize({src: src.bands.get(1), dst: layer, pixValField: 'val'});
+			assert.deepEqual(fieldValues(layer), [0.5, 1.5]);
+		});
+		it('should report progress', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			var calls = [];
+			gdal.polygonize({src: src.bands.get(1), dst: createLayer(), progress: function(complete) {
+				calls.push(complete);
+			}});
+			assert.isAbove(calls.length, 0);
+			assert.equal(calls[calls.length - 1], 1);
+		});
+		it('should cancel if progress returns false', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			assert.throws(function() {
+				gdal.polygonize({src: src.bands.get(1), dst: createLayer(), progress: function() {
+					return false;
+				}});
+			});
+		});
+		it('should throw if the field does not exist', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			assert.throws(function() {
+				gdal.polygonize({src: src.bands.get(1), dst: createLayer(), pixValField: 'bogus'});
+			}, /not found/);
+		});
+		it('should throw if connectedness is invalid', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			assert.throws(function() {
+				gdal.polygonize({src: src.bands.get(1), dst: createLayer(), connectedness: 6});
+			}, /connectedness/);
+		});
+		it('should throw if the source dataset is closed', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, regions);
+			var band = src.bands.get(1);
+			src.close();
+			assert.throws(function() {
+				gdal.polygonize({src: band, dst: createLayer()});
+			}, /already been destroyed/);
+		});
+	});
+	describe('polygonizeAsync()', function() {
+		it('should polygonize on the thread pool', function(done) {
+			var src = createRaster(4, 4, gdal.GDT_Byte, [
+				1, 1, 2, 2,
+				1, 1, 2, 2,
+				3, 3, 2, 2,
+				3, 3, 2, 2
+			]);
+			var layer = createLayer();
+			var progress = 0;
+			gdal.polygonizeAsync({src: src.bands.get(1), dst: layer, pixValField: 'val', progress: function(complete) {
+				progress = complete;
+			}}, function(err) {
+				if (err) return done(err);
+				assert.deepEqual(fieldValues(layer), [1, 2, 3]);
+				assert.equal(progress, 1);
+				done();
+			});
+		});
+	});
+	describe('rasterize()', function() {
+		var topLeft = 'POLYGON((0 4,2 4,2 2,0 2,0 4))';
+		var bottomRight = 'POLYGON((2 2,4 2,4 0,2 0,2 2))';
+
+		var createTarget = function(n_bands) {
+			var ds = gdal.open('temp', 'w', 'MEM', 4, 4, n_bands || 1, gdal.GDT_Byte);
+			ds.geoTransform = [0, 1, 0, 4, 0, -1];
+			return ds;
+		};
+		var readBand = function(ds, i) {
+			return Array.prototype.slice.call(ds.bands.get(i || 1).pixels.read(0, 0, 4, 4));
+		};
+		var createPolygonLayer = function() {
+			var layer = createLayer();
+			[[topLeft, 3], [bottomRight, 5]].forEach(function(item) {
+				var feature = new gdal.Feature(layer);
+				feature.setGeometry(gdal.Geometry.fromWKT(item[0]));
+				feature.fields.set('val', item[1]);
+				layer.features.add(feature);
+			});
+			return layer;
+		};
+
+		it('should burn geometries', function() {
+			var ds = createTarget();
+			gdal.rasterize({dst: ds, geometries: [gdal.Geometry.fromWKT(topLeft)], burnValues: 9});
+			assert.deepEqual(readBand(ds), [
+				9, 9, 0, 0,
+				9, 9, 0, 0,
+				0, 0, 0, 0,
+				0, 0, 0, 0
+			]);
+		});
+		it('should burn a value per geometry', function() {
+			var ds = createTarget();
+			gdal.rasterize({dst: ds, geometries: [gdal.Geometry.fromWKT(topLeft), gdal.Geometry.fromWKT(bottomRight)], burnValues: [1, 2]});
+			var data = readBand(ds);
+			assert.equal(data[0], 1);
+			assert.equal(data[15], 2);
+			assert.equal(data[3], 0);
+		});
+		it('should burn a value per band', function() {
+			var ds = createTarget(2);
+			gdal.rasterize({dst: ds, bands: [1, 2], geometries: [gdal.Geometry.fromWKT(topLeft)], burnValues: [4, 6]});
+			assert.equal(readBand(ds, 1)[0], 4);
+			assert.equal(readBand(ds, 2)[0], 6);
+		});
+		it('should accept WKB buffers and packed WKB', function() {
+			var geoms = [gdal.Geometry.fromWKT(topLeft), gdal.Geometry.fromWKT(bottomRight)];
+			var wkbs = geoms.map(function(geom) { return geom.toWKB(); });
+
+			var ds = createTarget();
+			gdal.rasterize({dst: ds, geometries: wkbs, burnValues: [1, 2]});
+			var expected = readBand(ds);
+			assert.equal(expected[0], 1);
+
+			var offsets = new Uint32Array([0, wkbs[0].length, wkbs[0].length + wkbs[1].length]);
+			ds = createTarget();
+			gdal.rasterize({dst: ds, geometries: {wkb: Buffer.concat(wkbs), offsets: offsets}, burnValues: new Float64Array([1, 2])});
+			assert.deepEqual(readBand(ds), expected);
+		});
+		it('should burn layers with an attribute', function() {
+			var ds = createTarget();
+			gdal.rasterize({dst: ds, layers: [createPolygonLayer()], attribute: 'val'});
+			var data = readBand(ds);
+			assert.equal(data[0], 3);
+			assert.equal(data[15], 5);
+		});
+		it('should support allTouched', function() {
+			var line = gdal.Geometry.fromWKT('LINESTRING(0.1 3.9,3.9 0.1)');
+			var ds = createTarget();
+			gdal.rasterize({dst: ds, geometries: [line], burnValues: 1});
+			var normal = readBand(ds).reduce(function(a, b) { return a + b; });
+			ds = createTarget();
+			gdal.rasterize({dst: ds, geometries: [line], burnValues: 1, allTouched: true});
+			var touched = readBand(ds).reduce(function(a, b) { return a + b; });
+			assert.isTrue(touched >= normal);
+		});
+		it('should add values with mergeAlg "add"', function() {
+			var ds = createTarget();
+			var geom = gdal.Geometry.fromWKT(topLeft);
+			gdal.rasterize({dst: ds, geometries: [geom, geom], burnValues: 2, mergeAlg: 'add'});
+			assert.equal(readBand(ds)[0], 4);
+		});
+		it('should throw if burnValues do not match', function() {
+			assert.throws(function() {
+				gdal.rasterize({dst: createTarget(), geometries: [gdal.Geometry.fromWKT(topLeft)], burnValues: [1, 2, 3]});
+			}, /burnValues/);
+		});
+		it('should throw if neither or both of layers and geometries are given', function() {
+			assert.throws(function() {
+				gdal.rasterize({dst: createTarget(), burnValues: 1});
+			}, /layers or geometries/);
+		});
+		it('should throw on invalid WKB', function() {
+			assert.throws(function() {
+				gdal.rasterize({dst: createTarget(), geometries: [new Buffer([1, 2, 3])], burnValues: 1});
+			}, /Invalid WKB/);
+		});
+	});
+	describe('rasterizeAsync()', function() {
+		it('should rasterize on the thread pool', function(done) {
+			var ds = gdal.open('temp', 'w', 'MEM', 4, 4, 1, gdal.GDT_Byte);
+			ds.geoTransform = [0, 1, 0, 4, 0, -1];
+			var wkb = gdal.Geometry.fromWKT('POLYGON((0 4,4 4,4 0,0 0,0 4))').toWKB();
+			gdal.rasterizeAsync({dst: ds, geometries: [wkb], burnValues: 8}, function(err) {
+				if (err) return done(err);
+				Array.prototype.forEach.call(ds.bands.get(1).pixels.read(0, 0, 4, 4), function(value) {
+					assert.equal(value, 8);
+				});
+				done();
+			});
+		});
+	});
+	describe('contourGenerate()', function() {
+		// a ramp rising 10 units per column: 0, 10, 20, 30
+		var createDEM = function() {
+			var values = [];
+			for (var y = 0; y < 4; y++) {
+				for (var x = 0; x < 4; x++) values.push(x * 10);
+			}
+			return createRaster(4, 4, gdal.GDT_Float32, values);
+		};
+		var createContourLayer = function() {
+			var ds = gdal.open('', 'w', 'Memory');
+			var layer = ds.layers.create('contours', null, gdal.LineString);
+			layer.fields.add(new gdal.FieldDefn('id', gdal.OFTInteger));
+			layer.fields.add(new gdal.FieldDefn('elev', gdal.OFTReal));
+			return layer;
+		};
+		var elevations = function(layer) {
+			var values = [];
+			layer.features.forEach(function(feature) {
+				values.push(feature.fields.get('elev'));
+			});
+			return values.sort(function(a, b) { return a - b; });
+		};
+
+		it('should generate contours at intervals', function() {
+			var layer = createContourLayer();
+			gdal.contourGenerate({src: createDEM().bands.get(1), dst: layer, interval: 10, base: 5, idField: 'id', elevField: 'elev'});
+			assert.deepEqual(elevations(layer), [5, 15, 25]);
+			layer.features.forEach(function(feature) {
+				assert.instanceOf(feature.getGeometry(), gdal.LineString);
+			});
+		});
+		it('should generate contours at fixed levels', function() {
+			var layer = createContourLayer();
+			gdal.contourGenerate({src: createDEM().bands.get(1), dst: layer, fixedLevels: [12, 18], elevField: 1});
+			assert.deepEqual(elevations(layer), [12, 18]);
+		});
+		it('should report progress', function() {
+			var calls = [];
+			gdal.contourGenerate({src: createDEM().bands.get(1), dst: createContourLayer(), interval: 10, progress: function(complete) {
+				calls.push(complete);
+			}});
+			assert.isAbove(calls.length, 0);
+			assert.equal(calls[calls.length - 1], 1);
+		});
+		it('should throw if neither interval nor fixedLevels is given', function() {
+			assert.throws(function() {
+				gdal.contourGenerate({src: createDEM().bands.get(1), dst: createContourLayer()});
+			}, /interval or fixedLevels/);
+		});
+	});
+	describe('contourGenerateAsync()', function() {
+		it('should generate contours on the thread pool', function(done) {
+			var values = [];
+			for (var i = 0; i < 16; i++) values.push((i % 4) * 10);
+			var src = createRaster(4, 4, gdal.GDT_Float32, values);
+			var ds = gdal.open('', 'w', 'Memory');
+			var layer = ds.layers.create('contours', null, gdal.LineString);
+			gdal.contourGenerateAsync({src: src.bands.get(1), dst: layer, interval: 10, base: 5}, function(err) {
+				if (err) return done(err);
+				assert.equal(layer.features.count(), 3);
+				done();
+			});
+		});
+	});
+	describe('computeProximity()', function() {
+		it('should write the distance to the nearest target pixel', function() {
+			var src = createRaster(4, 1, gdal.GDT_Byte, [1, 0, 0, 0]);
+			var dst = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Float32);
+			gdal.computeProximity({src: src.bands.get(1), dst: dst.bands.get(1)});
+			var data = Array.prototype.slice.call(dst.bands.get(1).pixels.read(0, 0, 4, 1));
+			assert.deepEqual(data, [0, 1, 2, 3]);
+		});
+		it('should respect values and maxDist', function() {
+			var src = createRaster(4, 1, gdal.GDT_Byte, [1, 0, 0, 2]);
+			var dst = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Float32);
+			gdal.computeProximity({src: src.bands.get(1), dst: dst.bands.get(1), values: [2], maxDist: 2, noData: -1});
+			var data = Array.prototype.slice.call(dst.bands.get(1).pixels.read(0, 0, 4, 1));
+			assert.deepEqual(data, [-1, 2, 1, 0]);
+		});
+		it('should throw if distUnits is invalid', function() {
+			var src = createRaster(4, 1, gdal.GDT_Byte, [1, 0, 0, 0]);
+			assert.throws(function() {
+				gdal.computeProximity({src: src.bands.get(1), dst: src.bands.get(1), distUnits: 'miles'});
+			}, /distUnits/);
+		});
+	});
+	describe('sieveFilter()', function() {
+		it('should remove small regions', function() {
+			var src = createRaster(4, 4, gdal.GDT_Byte, [
+				1, 1, 1, 1,
+				1, 2, 1, 1,
+				1, 1, 1, 1,
+				1, 1, 1, 1
+			]);
+			var band = src.bands.get(1);
+			gdal.sieveFilter({src: band, dst: band, threshold: 2});
+			Array.prototype.forEach.call(band.pixels.read(0, 0, 4, 4), function(value) {
+				assert.equal(value, 1);
+			});
+		});
+		it('should throw if threshold is missing', function() {
+			var src = createRaster(2, 2, gdal.GDT_Byte, [1, 1, 1, 1]);
+			assert.throws(function() {
+				gdal.sieveFilter({src: src.bands.get(1), dst: src.bands.get(1)});
+			}, /threshold/);
+		});
+	});
+	describe('fillNodata()', function() {
+		it('should interpolate nodata pixels', function() {
+			var src = createRaster(3, 1, gdal.GDT_Float32, [10, 0, 20]);
+			var band = src.bands.get(1);
+			band.noDataValue = 0;
+			gdal.fillNodata({src: band, searchDist: 5});
+			var data = band.pixels.read(0, 0, 3, 1);
+			assert.isTrue(data[1] >= 10 && data[1] <= 20);
+		});
+		it('should report progress while smoothing', function() {
+			var src = createRaster(3, 3, gdal.GDT_Float32, [10, 10, 10, 10, 0, 20, 20, 20, 20]);
+			var band = src.bands.get(1);
+			band.noDataValue = 0;
+			var calls = 0;
+			gdal.fillNodata({src: band, searchDist: 5, smoothingIterations: 2, progress: function() {
+				calls++;
+			}});
+			assert.isTrue(calls > 0);
+			assert.notEqual(band.pixels.get(1, 1), 0);
+		});
+	});
+	describe('filter async variants', function() {
+		it('should run computeProximityAsync() on the thread pool', function(done) {
+			var src = createRaster(4, 1, gdal.GDT_Byte, [1, 0, 0, 0]);
+			var dst = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Float32);
+			gdal.computeProximityAsync({src: src.bands.get(1), dst: dst.bands.get(1)}, function(err) {
+				if (err) return done(err);
+				assert.equal(dst.bands.get(1).pixels.get(3, 0), 3);
+				done();
+			});
+		});
+		it('should run sieveFilterAsync() on the thread pool', function(done) {
+			var src = createRaster(3, 3, gdal.GDT_Byte, [1, 1, 1, 1, 2, 1, 1, 1, 1]);
+			var band = src.bands.get(1);
+			gdal.sieveFilterAsync({src: band, dst: band, threshold: 2}, function(err) {
+				if (err) return done(err);
+				assert.equal(band.pixels.get(1, 1), 1);
+				done();
+			});
+		});
+		it('should run fillNodataAsync() on the thread pool', function(done) {
+			var src = createRaster(3, 1, gdal.GDT_Float32, [10, 0, 20]);
+			var band = src.bands.get(1);
+			band.noDataValue = 0;
+			gdal.fillNodataAsync({src: band}, function(err) {
+				if (err) return done(err);
+				assert.notEqual(band.pixels.get(1, 0), 0);
+				done();
+			});
+		});
+		it('should run fillNodataAsync() with smoothing on the thread pool', function(done) {
+			var src = createRaster(3, 3, gdal.GDT_Float32, [10, 10, 10, 10, 0, 20, 20, 20, 20]);
+			var band = src.bands.get(1);
+			band.noDataValue = 0;
+			gdal.fillNodataAsync({src: band, smoothingIterations: 2}, function(err) {
+				if (err) return done(err);
+				assert.notEqual(band.pixels.get(1, 1), 0);
+				done();
+			});
+		});
+	});
+	describe('grid()', function() {
+		var points = {
+			xs: new Float64Array([0.5, 3.5]),
+			ys: new Float64Array([3.5, 0.5]),
+			zs: new Float64Array([10, 20])
+		};
+		var bounds = {minX: 0, minY: 0, maxX: 4, maxY: 4};
+		it('should return a typed array', function() {
+			var data = gdal.grid({
+				xs: points.xs, ys: points.ys, zs: points.zs,
+				algorithm: 'nearest',
+				outBounds: bounds,
+				outSize: {x: 4, y: 4}
+			});
+			assert.instanceOf(data, Float64Array);
+			assert.equal(data.length, 16);
+			//row 0 is the north edge
+			assert.equal(data[0], 10);
+			assert.equal(data[15], 20);
+		});
+		it('should pass options to the algorithm', function() {
+			var data = gdal.grid({
+				xs: [0.5], ys: [0.5], zs: [5],
+				algorithm: 'average',
+				options: {radius1: 1, radius2: 1, nodata: -1},
+				outBounds: bounds,
+				outSize: {x: 4, y: 4},
+				type: 'Float32'
+			});
+			assert.instanceOf(data, Float32Array);
+			assert.equal(data[12], 5);
+			assert.equal(data[3], -1);
+		});
+		it('should interpolate with invdist', function() {
+			var data = gdal.grid({
+				xs: points.xs, ys: points.ys, zs: points.zs,
+				outBounds: bounds,
+				outSize: {x: 4, y: 4},
+				threads: 2
+			});
+			assert.closeTo(data[0], 10, 0.01);
+			assert.isTrue(data[5] > 10 && data[5] < 20);
+		});
+		it('should write into a band', function() {
+			var ds = createRaster(4, 4, gdal.GDT_Float32, new Array(16));
+			var band = ds.bands.get(1);
+			var result = gdal.grid({xs: points.xs, ys: points.ys, zs: points.zs, algorithm: 'nearest', dst: band});
+			assert.isUndefined(result);
+			assert.equal(band.pixels.get(0, 0), 10);
+			assert.equal(band.pixels.get(3, 3), 20);
+		});
+		it('should throw if the coordinate arrays differ in length', function() {
+			assert.throws(function() {
+				gdal.grid({xs: [0, 1], ys: [0], zs: [0, 1], outBounds: bounds, outSize: {x: 1, y: 1}});
+			}, /same length/);
+		});
+		it('should throw for unsupported algorithms', function() {
+			assert.throws(function() {
+				gdal.grid({xs: [0], ys: [0], zs: [0], algorithm: 'linear', outBounds: bounds, outSize: {x: 1, y: 1}});
+			}, /linear/);
+		});
+		it('should run gridAsync() on the thread pool', function(done) {
+			gdal.gridAsync({
+				xs: points.xs, ys: points.ys, zs: points.zs,
+				algorithm: 'nearest',
+				outBounds: bounds,
+				outSize: {x: 4, y: 4}
+			}, function(err, data) {
+				if (err) return done(err);
+				assert.equal(data[15], 20);
+				done();
+			});
+		});
+	});
+	describe('zonalStatistics()', function() {
+		var createZones = function() {
+			var layer = createLayer();
+			[
+				['POLYGON((0 4,2 4,2 2,0 2,0 4))', 1],
+				['POLYGON((2 2,4 2,4 0,2 0,2 2))', 2],
+				['POLYGON((10 10,11 10,11 11,10 10))', 3]
+			].forEach(function(item) {
+				var feature = new gdal.Feature(layer);
+				feature.setGeometry(gdal.Geometry.fromWKT(item[0]));
+				feature.fields.set('val', item[1]);
+				layer.features.add(feature);
+			});
+			return layer;
+		};
+		var createValues = function() {
+			return createRaster(4, 4, gdal.GDT_Float32, [
+				1,  2,  3,  4,
+				5,  6,  7,  8,
+				9,  10, 11, 12,
+				13, 14, 15, 16
+			]);
+		};
+
+		it('should return columns of statistics per feature', function() {
+			var layer = createZones();
+			var result = gdal.zonalStatistics(createValues().bands.get(1), layer);
+			assert.instanceOf(result.fid, Float64Array);
+			assert.deepEqual(Array.prototype.slice.call(result.count), [4, 4, 0]);
+			assert.deepEqual(Array.prototype.slice.call(result.sum), [14, 54, 0]);
+			assert.deepEqual(Array.prototype.slice.call(result.min).slice(0, 2), [1, 11]);
+			assert.deepEqual(Array.prototype.slice.call(result.max).slice(0, 2), [6, 16]);
+			assert.equal(result.mean[0], 3.5);
+			assert.isTrue(isNaN(result.mean[2]));
+			assert.equal(result.fid[1], layer.features.get(result.fid[1]).fid);
+		});
+		it('should only compute the requested statistics', function() {
+			var result = gdal.zonalStatistics(createValues().bands.get(1), createZones(), {stats: ['count'], field: 'val'});
+			assert.deepEqual(Object.keys(result).sort(), ['count', 'fid', 'val']);
+			assert.deepEqual(result.val, [1, 2, 3]);
+		});
+		it('should skip nodata pixels', function() {
+			var band = createValues().bands.get(1);
+			band.noDataValue = 1;
+			var result = gdal.zonalStatistics(band, createZones(), {stats: ['count', 'min']});
+			assert.equal(result.count[0], 3);
+			assert.equal(result.min[0], 2);
+		});
+		it('should support allTouched', function() {
+			var layer = createLayer();
+			var feature = new gdal.Feature(layer);
+			feature.setGeometry(gdal.Geometry.fromWKT('POLYGON((0.9 3.1,1.1 3.1,1.1 2.9,0.9 2.9,0.9 3.1))'));
+			layer.features.add(feature);
+			var band = createValues().bands.get(1);
+			assert.equal(gdal.zonalStatistics(band, layer, {stats: ['count']}).count[0], 0);
+			assert.equal(gdal.zonalStatistics(band, layer, {stats: ['count'], allTouched: true}).count[0], 4);
+		});
+		it('should burn the members of geometry collections by their own type', function() {
+			var layer = createLayer();
+			[
+				'GEOMETRYCOLLECTION(POINT(0.5 3.5),POINT(3.5 0.5))',
+				'GEOMETRYCOLLECTION(POINT(0.5 3.5),POLYGON((2 2,4 2,4 0,2 0,2 2)))'
+			].forEach(function(wkt) {
+				var feature = new gdal.Feature(layer);
+				feature.setGeometry(gdal.Geometry.fromWKT(wkt));
+				layer.features.add(feature);
+			});
+			var result = gdal.zonalStatistics(createValues().bands.get(1), layer, {stats: ['count', 'sum']});
+			assert.deepEqual(Array.prototype.slice.call(result.count), [2, 5]);
+			assert.deepEqual(Array.prototype.slice.call(result.sum), [17, 55]);
+		});
+		it('should handle features extending far beyond the band', function() {
+			var layer = createLayer();
+			[
+				'POLYGON((0 4,1e12 4,1e12 -1e12,0 -1e12,0 4))',
+				'POLYGON((1e12 1e12,2e12 1e12,2e12 2e12,1e12 1e12))'
+			].forEach(function(wkt) {
+				var feature = new gdal.Feature(layer);
+				feature.setGeometry(gdal.Geometry.fromWKT(wkt));
+				layer.features.add(feature);
+			});
+			var result = gdal.zonalStatistics(createValues().bands.get(1), layer, {stats: ['count']});
+			assert.deepEqual(Array.prototype.slice.call(result.count), [16, 0]);
+		});
+		it('should throw for unknown statistics', function() {
+			assert.throws(function() {
+				gdal.zonalStatistics(createValues().bands.get(1), createZones(), {stats: ['median']});
+			}, /median/);
+		});
+		it('should run zonalStatisticsAsync() on the thread pool', function(done) {
+			gdal.zonalStatisticsAsync(createValues().bands.get(1), createZones(), {threads: 2}, function(err, result) {
+				if (err) return done(err);
+				assert.deepEqual(Array.prototype.slice.call(result.sum), [14, 54, 0]);
+				done();
+			});
+		});
+	});
+});
@@ -27,6 +27,44 @@ describe('gdal', function() {
 			});
 		});
 	});
+	describe('openBuffer()', function() {
+		it('should open a raster dataset', function() {
+			var ds = gdal.openBuffer(fs.readFileSync(__dirname + '/data/sample.tif'));
+			assert.instanceOf(ds, gdal.Dataset);
+			assert.equal(ds.driver.description, 'GTiff');
+			assert.deepEqual(ds.rasterSize, gdal.open(__dirname + '/data/sample.tif').rasterSize);
+		});
+		it('should open a vector dataset with the given driver', function() {
+			var ds = gdal.openBuffer(fs.readFileSync(__dirname + '/data/park.geo.json'), {driver: 'GeoJSON'});
+			assert.equal(ds.driver.description, 'GeoJSON');
+			assert.equal(ds.layers.count(), 1);
+		});
+		it('should throw if no driver can open the buffer', function() {
+			assert.throws(function() {
+				gdal.openBuffer(fs.readFileSync(__dirname + '/data/sample.tif'), {driver: 'GeoJSON'});
+			}, /Error opening dataset/);
+			assert.throws(function() {
+				gdal.openBuffer(new Buffer('not a dataset'));
+			}, /Error opening dataset/);
+		});
+		it('should throw if not given a buffer', function() {
+			assert.throws(function() {
+				gdal.openBuffer({});
+			}, /Buffer/);
+		});
+		it('should remove the in-memory file when the dataset is closed', function() {
+			var ds = gdal.openBuffer(fs.readFileSync(__dirname + '/data/sample.tif'));
+			var filename = ds.description;
+			assert.match(filename, /^\/vsimem\//);
+			var other = gdal.open(filename);
+			assert.instanceOf(other, gdal.Dataset);
+			other.close();
+			ds.close();
+			assert.throws(function() {
+				gdal.open(filename);
+			});
+		});
+	});
 	describe('decToDMS()', function() {
 		it('should throw when axis not provided', function() {
 			assert.throws(function() {
@@ -31,4 +31,76 @@ describe('gdal.CoordinateTransformation', function() {
 		assert.closeTo(pt.x, 1564201.4044502454, 0.000001);
 		assert.closeTo(pt.y, 3370263.469590679, 0.000001);
 	});
+	describe('transformPoints()', function() {
+		var srs0 = gdal.SpatialReference.fromEPSG(4326);
+		var srs1 = gdal.SpatialReference.fromEPSG(32632);
+
+		it('should transform separate arrays in place', function() {
+			var ct = new gdal.CoordinateTransformation(srs0, srs1);
+			var xs = new Float64Array([20, 21]);
+			var ys = new Float64Array([30, 31]);
+			var success = ct.transformPoints(xs, ys);
+
+			var expected = ct.transformPoint(20, 30);
+			assert.instanceOf(success, Uint8Array);
+			assert.deepEqual([success[0], success[1]], [1, 1]);
+			assert.closeTo(xs[0], expected.x, 0.000001);
+			assert.closeTo(ys[0], expected.y, 0.000001);
+		});
+		it('should transform an interleaved array', function() {
+			var ct = new gdal.CoordinateTransformation(srs0, srs1);
+			var coords = new Float64Array([20, 30, 0, 21, 31, 0]);
+			var success = ct.transformPoints(coords, 3);
+
+			var expected = ct.transformPoint(21, 31);
+			assert.equal(success.length, 2);
+			assert.closeTo(coords[3], expected.x, 0.000001);
+			assert.closeTo(coords[4], expected.y, 0.000001);
+		});
+		it('should flag points that fail', function() {
+			var srs = gdal.SpatialReference.fromProj4('+proj=ortho +lat_0=0 +lon_0=0 +ellps=WGS84');
+			var ct = new gdal.CoordinateTransformation(srs0, srs);
+			var xs = new Float64Array([0, 180]);
+			var ys = new Float64Array([0, 0]);
+			var success = ct.transformPoints(xs, ys);
+			assert.equal(success[0], 1);
+			assert.equal(success[1], 0);
+		});
+		it('should throw if arrays are not Float64Arrays', function() {
+			var ct = new gdal.CoordinateTransformation(srs0, srs1);
+			assert.throws(function() {
+				ct.transformPoints([20, 30]);
+			});
+			assert.throws(function() {
+				ct.transformPoints(new Float64Array(2), new Float32Array(2));
+			});
+		});
+		it('should throw if lengths do not match', function() {
+			var ct = new gdal.CoordinateTransformation(srs0, srs1);
+			assert.throws(function() {
+				ct.transformPoints(new Float64Array(2), new Float64Array(3));
+			});
+			assert.throws(function() {
+				ct.transformPoints(new Float64Array(5), 2);
+			});
+		});
+	});
+	describe('transformPointsAsync()', function() {
+		it('should transform the arrays on the thread pool', function(done) {
+			var srs0 = gdal.SpatialReference.fromEPSG(4326);
+			var srs1 = gdal.SpatialReference.fromEPSG(32632);
+			var ct = new gdal.CoordinateTransformation(srs0, srs1);
+			var xs = new Float64Array([20]);
+			var ys = new Float64Array([30]);
+			var expected = ct.transformPoint(20, 30);
+
+			ct.transformPointsAsync(xs, ys, function(err, success) {
+				if (err) return done(err);
+				assert.equal(success[0], 1);
+				assert.closeTo(xs[0], expected.x, 0.000001);
+				assert.closeTo(ys[0], expected.y, 0.000001);
+				done();
+			});
+		});
+	});
 });
\ No newline at end of file
@@ -467,6 +467,72 @@ describe('gdal.Dataset', function() {
 				});
 			});
 		});
+		describe('readBands()', function() {
+			var createRGB = function() {
+				var ds = gdal.open('temp', 'w', 'MEM', 4, 4, 3, gdal.GDT_Byte);
+				ds.bands.forEach(function(band){
+					band.fill(band.id * 10);
+				});
+				return ds;
+			};
+			it('should return pixel-interleaved TypedArray', function() {
+				var ds = createRGB();
+				var data = ds.readBands(0, 0, 4, 4);
+				assert.instanceOf(data, Uint8Array);
+				assert.equal(data.length, 4*4*3);
+				for (var i = 0; i < 4*4; i++) {
+					assert.equal(data[i*3], 10);
+					assert.equal(data[i*3+1], 20);
+					assert.equal(data[i*3+2], 30);
+				}
+			});
+			it('should only read the given bands in the given order', function() {
+				var ds = createRGB();
+				var data = ds.readBands(0, 0, 4, 4, [3, 1]);
+				assert.equal(data.length, 4*4*2);
+				assert.equal(data[0], 30);
+				assert.equal(data[1], 10);
+			});
+			it('should read into an existing array', function() {
+				var ds = createRGB();
+				var data = new Uint8Array(4*4*3);
+				var result = ds.readBands(0, 0, 4, 4, null, data);
+				assert.equal(result, data);
+				assert.equal(data[2], 30);
+			});
+			it('should support planar layout through options', function() {
+				var ds = createRGB();
+				var data = ds.readBands(0, 0, 4, 4, [1, 2], null, {pixel_space: 1, line_space: 4, band_space: 16});
+				assert.equal(data.length, 4*4*2);
+				assert.equal(data[15], 10);
+				assert.equal(data[16], 20);
+			});
+			it('should throw if array is too small', function() {
+				var ds = createRGB();
+				assert.throws(function() {
+					ds.readBands(0, 0, 4, 4, null, new Uint8Array(4*4*3-1));
+				});
+			});
+			it('should throw if invalid band given', function() {
+				var ds = createRGB();
+				assert.throws(function() {
+					ds.readBands(0, 0, 4, 4, [4]);
+				});
+			});
+			it('should throw if an unknown data type is given', function() {
+				var ds = createRGB();
+				assert.throws(function() {
+					ds.readBands(0, 0, 4, 4, null, null, {type: 'NotAType'});
+				}, /data type/);
+			});
+			it('should throw if dataset already closed', function() {
+				var ds = createRGB();
+				ds.close();
+				assert.throws(function() {
+					ds.readBands(0, 0, 4, 4);
+				});
+			});
+		});
 		describe('buildOverviews()', function() {
 			it('should generate overviews for all bands', function() {
 				var ds   = gdal.open(fileUtils.clone(__dirname+"/data/sample.tif"), 'r+');
@@ -523,5 +589,90 @@ describe('gdal.Dataset', function() {
 				});
 			});
 		});
+		describe('buildOverviewsAsync()', function() {
+			it('should generate overviews on the thread pool', function(done) {
+				var ds = gdal.open(fileUtils.clone(__dirname+"/data/sample.tif"), 'r+');
+				var calls = 0;
+				ds.buildOverviewsAsync('NEAREST', [2, 4], null, {
+					progress: function() { calls++; }
+				}, function(err) {
+					if (err) return done(err);
+					assert.isTrue(calls > 0);
+					ds.bands.forEach(function(band) {
+						assert.equal(band.overviews.count(), 2);
+					});
+					ds.close();
+					done();
+				});
+			});
+			it('should build datasets in parallel', function(done) {
+				var a = gdal.open(fileUtils.clone(__dirname+"/data/sample.tif"), 'r+');
+				var b = gdal.open(fileUtils.clone(__dirname+"/data/sample.tif"), 'r+');
+				var pending = 2;
+				var finish = function(err) {
+					if (err) return done(err);
+					if (--pending) return;
+					assert.equal(a.bands.get(1).overviews.count(), 1);
+					assert.equal(b.bands.get(1).overviews.count(), 1);
+					done();
+				};
+				a.buildOverviewsAsync('AVERAGE', [2], finish);
+				b.buildOverviewsAsync('AVERAGE', [2], [1], {compress: 'DEFLATE'}, finish);
+			});
+			it('should throw if invalid band given', function() {
+				var ds = gdal.open(fileUtils.clone(__dirname+"/data/sample.tif"), 'r+');
+				assert.throws(function() {
+					ds.buildOverviewsAsync('NEAREST', [2], [4], function() {});
+				});
+			});
+		});
+		describe('toBuffer()', function() {
+			it('should return a copy of the dataset as a Buffer', function() {
+				var src = gdal.open(__dirname + "/data/sample.tif");
+				var buffer = src.toBuffer('GTiff');
+				assert.instanceOf(buffer, Buffer);
+				assert.equal(buffer.toString('ascii', 0, 2), 'II');
+
+				var ds = gdal.openBuffer(buffer);
+				assert.deepEqual(ds.rasterSize, src.rasterSize);
+				assert.deepEqual(ds.geoTransform, src.geoTransform);
+				var a = src.bands.get(1).pixels.read(0, 0, 20, 20);
+				var b = ds.bands.get(1).pixels.read(0, 0, 20, 20);
+				assert.deepEqual(Array.prototype.slice.call(b), Array.prototype.slice.call(a));
+			});
+			it('should use the dataset\'s own driver by default', function() {
+				var src = gdal.open(__dirname + "/data/park.geo.json");
+				var buffer = src.toBuffer();
+				var json = JSON.parse(buffer.toString('utf8'));
+				assert.equal(json.type, 'FeatureCollection');
+				assert.equal(json.features.length, src.layers.get(0).features.count());
+			});
+			it('should require a driver if the dataset has none', function() {
+				var src = gdal.openBuffer(fs.readFileSync(__dirname + "/data/sample.tif"), {driver: 'GTiff'});
+				assert.throws(function() {
+					src.toBuffer();
+				}, /no driver/);
+				assert.instanceOf(src.toBuffer('GTiff'), Buffer);
+			});
+			it('should pass creation options to the driver', function() {
+				var src = gdal.open(__dirname + "/data/sample.tif");
+				var plain = src.toBuffer('GTiff');
+				var compressed = src.toBuffer('GTiff', ['COMPRESS=DEFLATE']);
+				assert.isTrue(compressed.length < plain.length);
+			});
+			it('should throw if the format writes more than one file', function() {
+				var src = gdal.open(__dirname + "/data/shp/sample.shp");
+				assert.throws(function() {
+					src.toBuffer('ESRI Shapefile');
+				}, /more than one file/);
+			});
+			it('should throw if dataset already closed', function() {
+				var ds = gdal.open(__dirname + "/data/sample.tif");
+				ds.close();
+				assert.throws(function(){
+					ds.toBuffer('GTiff');
+				});
+			});
+		});
 	});
-});
\ No newline at end of file
+});
@@ -2,6 +2,7 @@
 
 var assert = require('chai').assert;
 var gdal = require('../lib/gdal.js');
+var fileUtils = require('./utils/file.js');
 
 describe('gdal.drivers', function() {
 	afterEach(gc);
@@ -123,3 +124,54 @@ describe('gdal.drivers', function() {
 		});
 	});
 });
+
+describe('gdal.Driver', function() {
+	afterEach(gc);
+
+	describe('createCopy()', function() {
+		it('should report progress', function() {
+			var src = gdal.open(__dirname + '/data/sample.tif');
+			var calls = [];
+			var ds = gdal.drivers.get('GTiff').createCopy('/vsimem/create_copy_sync.tif', src, null, {
+				progress: function(complete) { calls.push(complete); }
+			});
+			assert.instanceOf(ds, gdal.Dataset);
+			assert.isTrue(calls.length > 0);
+			assert.equal(calls[calls.length - 1], 1);
+			ds.close();
+			gdal.drivers.get('GTiff').deleteDataset('/vsimem/create_copy_sync.tif');
+		});
+		it('should throw if cancelled', function() {
+			var src = gdal.open(__dirname + '/data/sample.tif');
+			assert.throws(function() {
+				gdal.drivers.get('GTiff').createCopy('/vsimem/create_copy_cancel.tif', src, null, {
+					progress: function() { return false; }
+				});
+			});
+			assert.throws(function() {
+				gdal.open('/vsimem/create_copy_cancel.tif');
+			});
+		});
+	});
+
+	describe('createCopyAsync()', function() {
+		it('should copy a tiled GTiff with internal overviews', function(done) {
+			var src = gdal.open(fileUtils.clone(__dirname + '/data/sample.tif'), 'r+');
+			src.buildOverviews('NEAREST', [2, 4]);
+			var calls = 0;
+			gdal.drivers.get('GTiff').createCopyAsync('/vsimem/create_copy_async.tif', src, ['TILED=YES', 'COPY_SRC_OVERVIEWS=YES'], {
+				progress: function() { calls++; }
+			}, function(err, ds) {
+				if (err) return done(err);
+				assert.instanceOf(ds, gdal.Dataset);
+				assert.isTrue(calls > 0);
+				assert.equal(ds.bands.get(1).overviews.count(), 2);
+				assert.equal(ds.bands.get(1).blockSize.x, 256);
+				ds.close();
+				src.close();
+				gdal.drivers.get('GTiff').deleteDataset('/vsimem/create_copy_async.tif');
+				done();
+			});
+		});
+	});
+});
@@ -35,6 +35,44 @@ describe('gdal.Geometry', function() {
 			assert.equal(point3d.toWKT(), 'POINT (1 2 3)');
 		});
 	});
+	describe('toWKB()', function() {
+		it('should return valid result', function() {
+			var point = new gdal.Point(1,2);
+			var wkb = point.toWKB('LSB');
+			assert.instanceOf(wkb, Buffer);
+			assert.equal(wkb.length, point.wkbSize);
+			assert.equal(wkb[0], 1);
+			assert.equal(wkb.readDoubleLE(5), 1);
+			assert.equal(wkb.readDoubleLE(13), 2);
+			assert.equal(point.toWKB()[0], 0);
+		});
+		it('should throw for an invalid byte order or variant', function() {
+			var point = new gdal.Point(1,2);
+			assert.throws(function() { point.toWKB('XYZ'); }, /byte order/);
+			assert.throws(function() { point.toWKB('LSB', 'XYZ'); }, /variant/);
+		});
+	});
+	describe('toWKBMany()', function() {
+		it('should write all geometries into one buffer', function() {
+			var geoms = [
+				gdal.Geometry.fromWKT('POINT (1 2)'),
+				null,
+				gdal.Geometry.fromWKT('LINESTRING (0 0,1 1,2 2)')
+			];
+			var result = gdal.Geometry.toWKBMany(geoms, 'LSB');
+			assert.instanceOf(result.wkb, Buffer);
+			assert.instanceOf(result.offsets, Uint32Array);
+			assert.deepEqual(Array.prototype.slice.call(result.offsets), [0, 21, 21, 21 + geoms[2].wkbSize]);
+			assert.equal(result.wkb.length, result.offsets[3]);
+			var line = gdal.Geometry.fromWKB(result.wkb.slice(result.offsets[2], result.offsets[3]));
+			assert.isTrue(line.equals(geoms[2]));
+		});
+		it('should throw if an element is not a geometry', function() {
+			assert.throws(function() {
+				gdal.Geometry.toWKBMany([{}]);
+			}, /geometries/);
+		});
+	});
 	describe('toGML()', function() {
 		it('should return valid result', function() {
 			var point2d = new gdal.Point(1,2);
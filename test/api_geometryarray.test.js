@@ -0,0 +1,98 @@
+'use strict';
+
+var assert = require('chai').assert;
+var gdal = require('../lib/gdal.js');
+
+describe('gdal.GeometryArray', function() {
+	afterEach(gc);
+
+	var wkts = ['POINT (1 1)', null, 'POLYGON ((0 0,4 0,4 4,0 4,0 0))', 'LINESTRING (10 10,20 20)'];
+	var createArray = function() {
+		var geoms = wkts.map(function(wkt) {
+			return wkt ? gdal.Geometry.fromWKT(wkt) : null;
+		});
+		var packed = gdal.Geometry.toWKBMany(geoms, 'LSB');
+		return gdal.Geometry.fromWKBMany(packed.wkb, packed.offsets);
+	};
+
+	it('should not be instantiable', function() {
+		assert.throws(function() {
+			new gdal.GeometryArray();
+		});
+	});
+	describe('Geometry.fromWKBMany()', function() {
+		it('should parse packed WKB', function() {
+			var array = createArray();
+			assert.instanceOf(array, gdal.GeometryArray);
+			assert.equal(array.count(), 4);
+			assert.isNull(array.get(1));
+			assert.instanceOf(array.get(2), gdal.Polygon);
+			assert.equal(array.get(3).toWKT(), wkts[3]);
+		});
+		it('should assign the spatial reference', function() {
+			var packed = gdal.Geometry.toWKBMany([gdal.Geometry.fromWKT('POINT (1 1)')]);
+			var array = gdal.Geometry.fromWKBMany(packed.wkb, packed.offsets, gdal.SpatialReference.fromEPSG(4326));
+			assert.isTrue(array.get(0).srs.isSame(gdal.SpatialReference.fromEPSG(4326)));
+		});
+		it('should throw on invalid WKB', function() {
+			assert.throws(function() {
+				gdal.Geometry.fromWKBMany(new Buffer([1, 2, 3]), new Uint32Array([0, 3]));
+			}, /geometry 0/);
+		});
+		it('should throw if the offsets are out of range', function() {
+			assert.throws(function() {
+				gdal.Geometry.fromWKBMany(new Buffer(0), new Uint32Array([0, 21]));
+			}, /range/);
+		});
+	});
+	describe('Geometry.fromWKTMany()', function() {
+		it('should parse WKT', function() {
+			var array = gdal.Geometry.fromWKTMany(wkts);
+			assert.equal(array.count(), 4);
+			assert.isNull(array.get(1));
+			assert.equal(array.get(0).x, 1);
+		});
+	});
+	describe('instance', function() {
+		it('should return envelopes', function() {
+			var envelopes = createArray().getEnvelopes();
+			assert.lengthOf(envelopes, 16);
+			assert.deepEqual(Array.prototype.slice.call(envelopes, 8, 12), [0, 0, 4, 4]);
+			assert.isTrue(isNaN(envelopes[4]));
+		});
+		it('should evaluate predicates', function() {
+			var area = gdal.Geometry.fromWKT('POLYGON ((-1 -1,5 -1,5 5,-1 5,-1 -1))');
+			assert.deepEqual(Array.prototype.slice.call(createArray().within(area)), [1, 0, 1, 0]);
+			assert.deepEqual(Array.prototype.slice.call(createArray().intersects(area)), [1, 0, 1, 0]);
+		});
+		it('should buffer', function() {
+			var buffered = createArray().buffer(1);
+			assert.instanceOf(buffered, gdal.GeometryArray);
+			assert.isNull(buffered.get(1));
+			assert.instanceOf(buffered.get(0), gdal.Polygon);
+		});
+		it('should transform in place', function() {
+			var array = gdal.Geometry.fromWKTMany(['POINT (0 0)'], gdal.SpatialReference.fromEPSG(4326));
+			array.transformTo(gdal.SpatialReference.fromEPSG(3857));
+			assert.closeTo(array.get(0).x, 0, 0.001);
+			assert.isTrue(array.get(0).srs.isSame(gdal.SpatialReference.fromEPSG(3857)));
+		});
+		it('should round-trip through toWKBMany()', function() {
+			var packed = gdal.Geometry.toWKBMany(createArray());
+			assert.equal(packed.offsets[2], packed.offsets[1]);
+			assert.equal(gdal.Geometry.fromWKBMany(packed.wkb, packed.offsets).get(3).toWKT(), wkts[3]);
+		});
+		it('should write features to a layer', function() {
+			var ds = gdal.open('', 'w', 'Memory');
+			var layer = ds.layers.create('geoms', null, gdal.wkbUnknown);
+			var fids = createArray().writeTo(layer);
+			assert.instanceOf(fids, Float64Array);
+			assert.equal(layer.features.count(), 4);
+			assert.isNull(layer.features.get(fids[1]).getGeometry());
+			assert.equal(layer.features.get(fids[3]).getGeometry().toWKT(), wkts[3]);
+		});
+		it('should support toArray()', function() {
+			assert.lengthOf(createArray().toArray(), 4);
+		});
+	});
+});
@@ -0,0 +1,64 @@
+'use strict';
+
+var assert = require('chai').assert;
+var gdal = require('../lib/gdal.js');
+
+describe('gdal.GeometryCollection', function() {
+	afterEach(gc);
+
+	describe('instance', function() {
+		describe('"children" property', function() {
+			describe('toFloat64Array()', function() {
+				it('should return nested offsets for polygons', function() {
+					var multi = gdal.Geometry.fromWKT('MULTIPOLYGON(((0 0,1 0,1 1,0 0)),((5 5,9 5,9 9,5 5),(6 6,7 6,7 7,6 6)))');
+					var result = multi.children.toFloat64Array();
+					assert.lengthOf(result.coordinates, 24);
+					assert.lengthOf(result.offsets, 2);
+					assert.deepEqual(Array.prototype.slice.call(result.offsets[0]), [0, 1, 3]);
+					assert.deepEqual(Array.prototype.slice.call(result.offsets[1]), [0, 4, 8, 12]);
+				});
+				it('should return line offsets for linestrings', function() {
+					var multi = gdal.Geometry.fromWKT('MULTILINESTRING((0 0,1 1),(2 2,3 3,4 4))');
+					var result = multi.children.toFloat64Array({dims: 3});
+					assert.lengthOf(result.coordinates, 15);
+					assert.lengthOf(result.offsets, 1);
+					assert.deepEqual(Array.prototype.slice.call(result.offsets[0]), [0, 2, 5]);
+				});
+				it('should return no offsets for points', function() {
+					var multi = gdal.Geometry.fromWKT('MULTIPOINT(1 2,3 4)');
+					var result = multi.children.toFloat64Array();
+					assert.deepEqual(Array.prototype.slice.call(result.coordinates), [1, 2, 3, 4]);
+					assert.lengthOf(result.offsets, 0);
+				});
+				it('should throw for mixed children', function() {
+					var collection = gdal.Geometry.fromWKT('GEOMETRYCOLLECTION(POINT(1 2),LINESTRING(0 0,1 1))');
+					assert.throws(function() {
+						collection.children.toFloat64Array();
+					}, /Children/);
+				});
+			});
+			describe('setFromArray()', function() {
+				it('should round-trip a multipolygon', function() {
+					var source = gdal.Geometry.fromWKT('MULTIPOLYGON(((0 0,1 0,1 1,0 0)),((5 5,9 5,9 9,5 5),(6 6,7 6,7 7,6 6)))');
+					var result = source.children.toFloat64Array();
+					var multi = new gdal.MultiPolygon();
+					multi.children.setFromArray(result.coordinates, result.offsets);
+					assert.equal(multi.children.count(), 2);
+					assert.isTrue(multi.equals(source));
+				});
+				it('should round-trip 3D collections', function() {
+					var multi = gdal.Geometry.fromWKT('MULTILINESTRING((0 0 1,1 1 2),(2 2 3,3 3 4,4 4 5))');
+					var result = multi.children.toFloat64Array();
+					multi.children.setFromArray(result.coordinates, result.offsets);
+					assert.equal(multi.children.count(), 2);
+					assert.equal(multi.children.get(1).points.get(2).z, 5);
+				});
+				it('should throw if the offset levels do not match the collection type', function() {
+					assert.throws(function() {
+						new gdal.MultiPolygon().children.setFromArray(new Float64Array([0, 0]), []);
+					}, /offset levels/);
+				});
+			});
+		});
+	});
+});
@@ -423,6 +423,86 @@ describe('gdal.Layer', function() {
 					});
 				});
 			});
+			describe('readBatch()', function() {
+				it('should return columns for the next features', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						var count = layer.features.count();
+						var batch = layer.features.readBatch(10, {fields: ['name']});
+						assert.equal(batch.count, 10);
+						assert.instanceOf(batch.fids, Float64Array);
+						assert.equal(batch.fids[0], 0);
+						assert.deepEqual(Object.keys(batch.fields), ['name']);
+						assert.equal(batch.fields.name[0], layer.features.get(0).fields.get('name'));
+
+						var rest = layer.features.readBatch(count);
+						assert.equal(rest.count, count - 10);
+						assert.equal(rest.fids[0], 10);
+					});
+				});
+				it('should accept a count larger than the layer', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						var batch = layer.features.readBatch(0x7fffffff, {fields: []});
+						assert.equal(batch.count, layer.features.count());
+					});
+				});
+				it('should pack geometry as WKB', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						var batch = layer.features.readBatch(2);
+						var offsets = batch.geometry.offsets;
+						assert.instanceOf(batch.geometry.wkb, Buffer);
+						assert.equal(offsets.length, 3);
+						assert.equal(offsets[2], batch.geometry.wkb.length);
+
+						var wkb = batch.geometry.wkb.slice(offsets[1], offsets[2]);
+						var geom = gdal.Geometry.fromWKB(wkb);
+						assert.isTrue(geom.equals(layer.features.get(1).getGeometry()));
+					});
+				});
+				it('should return typed columns and vertex coordinates', function() {
+					var ds = gdal.open('', 'w', 'Memory');
+					var layer = ds.layers.create('points', null, gdal.Point);
+					layer.fields.add(new gdal.FieldDefn('id', gdal.OFTInteger));
+					layer.fields.add(new gdal.FieldDefn('value', gdal.OFTReal));
+					for (var i = 0; i < 3; i++) {
+						var f = new gdal.Feature(layer);
+						f.fields.set('id', i);
+						if (i !== 1) f.fields.set('value', i / 2);
+						f.setGeometry(new gdal.Point(i, i * 10));
+						layer.features.add(f);
+					}
+
+					var batch = layer.features.readBatch(5, {geometry: 'coords'});
+					assert.equal(batch.count, 3);
+					assert.instanceOf(batch.fields.id, Int32Array);
+					assert.instanceOf(batch.fields.value, Float64Array);
+					assert.equal(batch.fields.id[2], 2);
+					assert.equal(batch.fields.value[2], 1);
+					assert.isTrue(isNaN(batch.fields.value[1]));
+					assert.deepEqual(Array.prototype.slice.call(batch.geometry.coords), [0, 0, 1, 10, 2, 20]);
+					assert.deepEqual(Array.prototype.slice.call(batch.geometry.offsets), [0, 1, 2, 3]);
+				});
+				it('should omit geometry if requested', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						var batch = layer.features.readBatch(1, {geometry: 'none'});
+						assert.isUndefined(batch.geometry);
+					});
+				});
+				it('should throw error if field does not exist', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						assert.throws(function() {
+							layer.features.readBatch(1, {fields: ['bogus']});
+						}, /not found/);
+					});
+				});
+				it('should throw error if dataset is destroyed', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						dataset.close();
+						assert.throws(function() {
+							layer.features.readBatch(1);
+						}, /already destroyed/);
+					});
+				});
+			});
 			describe('first()', function() {
 				it('should return a Feature and reset the iterator', function() {
 					prepare_dataset_layer_test('r', function(dataset, layer) {
@@ -487,6 +567,77 @@ describe('gdal.Layer', function() {
 				});
 			});
 
+			describe('insertBatch()', function() {
+				var createLayer = function() {
+					var ds = gdal.open('', 'w', 'Memory');
+					var layer = ds.layers.create('points', null, gdal.Point);
+					layer.fields.add(new gdal.FieldDefn('id', gdal.OFTInteger));
+					layer.fields.add(new gdal.FieldDefn('value', gdal.OFTReal));
+					layer.fields.add(new gdal.FieldDefn('name', gdal.OFTString));
+					return layer;
+				};
+				it('should create a feature per row', function() {
+					var layer = createLayer();
+					var geometries = [new gdal.Point(1, 2).toWKB(), null];
+					var inserted = layer.features.insertBatch({
+						id: new Int32Array([5, 6]),
+						value: new Float64Array([0.5, 1.5]),
+						name: ['a', null]
+					}, geometries);
+
+					assert.equal(inserted, 2);
+					assert.equal(layer.features.count(), 2);
+					var f0 = layer.features.get(0);
+					var f1 = layer.features.get(1);
+					assert.deepEqual(f0.fields.toJSON(), {id: 5, value: 0.5, name: 'a'});
+					assert.deepEqual(f1.fields.toJSON(), {id: 6, value: 1.5, name: null});
+					assert.isTrue(f0.getGeometry().equals(new gdal.Point(1, 2)));
+					assert.isNull(f1.getGeometry());
+				});
+				it('should accept the output of readBatch()', function() {
+					var src = createLayer();
+					src.features.insertBatch({id: new Int32Array([1, 2, 3])}, [
+						new gdal.Point(0, 0).toWKB(),
+						new gdal.Point(1, 1).toWKB(),
+						new gdal.Point(2, 2).toWKB()
+					]);
+					var batch = src.features.readBatch(3);
+
+					var dst = createLayer();
+					var inserted = dst.features.insertBatch(batch.fields, batch.geometry, {transactionSize: 2});
+					assert.equal(inserted, 3);
+					assert.equal(dst.features.get(2).fields.get('id'), 3);
+					assert.isTrue(dst.features.get(2).getGeometry().equals(new gdal.Point(2, 2)));
+				});
+				it('should throw error if field does not exist', function() {
+					var layer = createLayer();
+					assert.throws(function() {
+						layer.features.insertBatch({bogus: [1]});
+					}, /not found/);
+				});
+				it('should throw error if columns differ in length', function() {
+					var layer = createLayer();
+					assert.throws(function() {
+						layer.features.insertBatch({id: [1, 2], value: [1]});
+					}, /same length/);
+				});
+				it('should throw error if layer doesnt support creating features', function() {
+					prepare_dataset_layer_test('r', function(dataset, layer) {
+						assert.throws(function() {
+							layer.features.insertBatch({name: ['a']});
+						});
+					});
+				});
+				it('should throw error if dataset is destroyed', function() {
+					prepare_dataset_layer_test('w', function(dataset, layer) {
+						dataset.close();
+						assert.throws(function() {
+							layer.features.insertBatch({});
+						}, /already destroyed/);
+					});
+				});
+			});
+
 			describe('set()', function() {
 				var f0, f1, f1_new, layer, dataset;
 				beforeEach(function() {
@@ -199,6 +199,57 @@ describe('gdal.LineString', function() {
 					assert.equal(points[2].x, 3);
 				});
 			});
+			describe('toFloat64Array()', function() {
+				it('should return interleaved coordinates', function() {
+					var line = new gdal.LineString();
+					line.points.add(1, 2);
+					line.points.add(3, 4);
+					var coords = line.points.toFloat64Array();
+					assert.instanceOf(coords, Float64Array);
+					assert.deepEqual(Array.prototype.slice.call(coords), [1, 2, 3, 4]);
+				});
+				it('should respect dims', function() {
+					var line = new gdal.LineString();
+					line.points.add(1, 2, 3);
+					line.points.add(4, 5, 6);
+					assert.deepEqual(Array.prototype.slice.call(line.points.toFloat64Array()), [1, 2, 3, 4, 5, 6]);
+					assert.deepEqual(Array.prototype.slice.call(line.points.toFloat64Array({dims: 2})), [1, 2, 4, 5]);
+				});
+				it('should throw if dims is invalid', function() {
+					assert.throws(function() {
+						new gdal.LineString().points.toFloat64Array({dims: 4});
+					}, /dims/);
+				});
+			});
+			describe('setFromArray()', function() {
+				it('should replace the points', function() {
+					var line = new gdal.LineString();
+					line.points.add(9, 9);
+					line.points.setFromArray(new Float64Array([1, 2, 3, 4, 5, 6]));
+					assert.equal(line.points.count(), 3);
+					assert.equal(line.points.get(2).x, 5);
+					assert.equal(line.points.get(2).y, 6);
+				});
+				it('should read z values if dims is 3', function() {
+					var line = new gdal.LineString();
+					line.points.setFromArray(new Float64Array([1, 2, 3, 4, 5, 6]), 3);
+					assert.equal(line.points.count(), 2);
+					assert.equal(line.points.get(1).z, 6);
+				});
+				it('should default to the dimension of the line', function() {
+					var line = gdal.Geometry.fromWKT('LINESTRING(1 2 3,4 5 6)');
+					var coordinates = line.points.toFloat64Array();
+					coordinates[5] = 7;
+					line.points.setFromArray(coordinates);
+					assert.equal(line.points.count(), 2);
+					assert.equal(line.points.get(1).z, 7);
+				});
+				it('should throw if the length is not a multiple of dims', function() {
+					assert.throws(function() {
+						new gdal.LineString().points.setFromArray(new Float64Array([1, 2, 3]));
+					}, /multiple/);
+				});
+			});
 		});
 	});
-});
\ No newline at end of file
+});
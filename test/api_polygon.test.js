@@ -157,6 +157,39 @@ describe('gdal.Polygon', function() {
 					assert.equal(array[0].points.get(3).y, 11);
 				});
 			});
+			describe('toFloat64Array()', function() {
+				it('should return coordinates and ring offsets', function() {
+					var polygon = gdal.Geometry.fromWKT('POLYGON((0 0,10 0,10 10,0 0),(1 1,2 1,2 2,1 1))');
+					var result = polygon.rings.toFloat64Array();
+					assert.instanceOf(result.coordinates, Float64Array);
+					assert.lengthOf(result.coordinates, 16);
+					assert.lengthOf(result.offsets, 1);
+					assert.instanceOf(result.offsets[0], Uint32Array);
+					assert.deepEqual(Array.prototype.slice.call(result.offsets[0]), [0, 4, 8]);
+					assert.equal(result.coordinates[8], 1);
+				});
+			});
+			describe('setFromArray()', function() {
+				it('should round-trip the output of toFloat64Array()', function() {
+					var source = gdal.Geometry.fromWKT('POLYGON((0 0,10 0,10 10,0 0),(1 1,2 1,2 2,1 1))');
+					var result = source.rings.toFloat64Array();
+					var polygon = new gdal.Polygon();
+					polygon.rings.setFromArray(result.coordinates, result.offsets);
+					assert.isTrue(polygon.equals(source));
+				});
+				it('should round-trip 3D polygons', function() {
+					var polygon = gdal.Geometry.fromWKT('POLYGON((0 0 1,10 0 2,10 10 3,0 0 1))');
+					var result = polygon.rings.toFloat64Array();
+					polygon.rings.setFromArray(result.coordinates, result.offsets);
+					assert.equal(polygon.rings.get(0).points.count(), 4);
+					assert.equal(polygon.rings.get(0).points.get(2).z, 3);
+				});
+				it('should throw if the offsets do not match the coordinates', function() {
+					assert.throws(function() {
+						new gdal.Polygon().rings.setFromArray(new Float64Array([0, 0, 1, 1]), [new Uint32Array([0, 3])]);
+					}, /offset/);
+				});
+			});
 		});
 		describe('getArea()', function() {
 			it('should return area', function() {
@@ -0,0 +1,66 @@
+'use strict';
+
+var assert = require('chai').assert;
+var gdal = require('../lib/gdal.js');
+
+describe('gdal.PreparedGeometry', function() {
+	afterEach(gc);
+
+	var square = 'POLYGON ((0 0,10 0,10 10,0 10,0 0))';
+
+	it('should not be instantiable', function() {
+		assert.throws(function() {
+			new gdal.PreparedGeometry();
+		});
+	});
+	it('should be created by geometry.prepare()', function() {
+		assert.instanceOf(gdal.Geometry.fromWKT(square).prepare(), gdal.PreparedGeometry);
+	});
+	describe('instance', function() {
+		it('should evaluate predicates against a geometry', function() {
+			var prepared = gdal.Geometry.fromWKT(square).prepare();
+			var inside = gdal.Geometry.fromWKT('POINT (5 5)');
+			var edge = gdal.Geometry.fromWKT('POINT (0 5)');
+			var outside = gdal.Geometry.fromWKT('POINT (20 20)');
+			assert.isTrue(prepared.intersects(inside));
+			assert.isTrue(prepared.contains(inside));
+			assert.isTrue(prepared.containsProperly(inside));
+			assert.isTrue(prepared.covers(edge));
+			assert.isFalse(prepared.contains(edge));
+			assert.isFalse(prepared.containsProperly(edge));
+			assert.isFalse(prepared.intersects(outside));
+			assert.isTrue(prepared.within(gdal.Geometry.fromWKT('POLYGON ((-1 -1,11 -1,11 11,-1 11,-1 -1))')));
+		});
+		it('should match the unprepared predicates', function() {
+			var polygon = gdal.Geometry.fromWKT(square);
+			var prepared = polygon.prepare();
+			var line = gdal.Geometry.fromWKT('LINESTRING (5 5,15 15)');
+			assert.equal(prepared.intersects(line), polygon.intersects(line));
+			assert.equal(prepared.contains(line), polygon.contains(line));
+		});
+		it('should test points in a Float64Array', function() {
+			var prepared = gdal.Geometry.fromWKT(square).prepare();
+			var points = new Float64Array([5, 5, 0, 5, 20, 20, -1, 5]);
+			var result = prepared.contains(points);
+			assert.instanceOf(result, Uint8Array);
+			assert.deepEqual(Array.prototype.slice.call(result), [1, 0, 0, 0]);
+			assert.deepEqual(Array.prototype.slice.call(prepared.covers(points)), [1, 1, 0, 0]);
+		});
+		it('should respect stride', function() {
+			var prepared = gdal.Geometry.fromWKT(square).prepare();
+			var points = new Float64Array([5, 5, 100, 20, 20, 100]);
+			assert.deepEqual(Array.prototype.slice.call(prepared.intersects(points, 3)), [1, 0]);
+		});
+		it('should test a GeometryArray', function() {
+			var prepared = gdal.Geometry.fromWKT(square).prepare();
+			var geoms = gdal.Geometry.fromWKTMany(['POINT (1 1)', null, 'LINESTRING (20 20,30 30)']);
+			assert.deepEqual(Array.prototype.slice.call(prepared.intersects(geoms)), [1, 0, 0]);
+		});
+		it('should throw if the coordinate array length does not match stride', function() {
+			var prepared = gdal.Geometry.fromWKT(square).prepare();
+			assert.throws(function() {
+				prepared.intersects(new Float64Array([1, 2, 3]));
+			}, /stride/);
+		});
+	});
+});
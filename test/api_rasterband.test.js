@@ -766,6 +766,84 @@ describe('gdal.RasterBand', function() {
 					});
 				});
 			});
+			describe('readAsync()', function() {
+				it('should pass a TypedArray to the callback', function(done) {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var expected = band.pixels.read(190, 290, 20, 30);
+					band.pixels.readAsync(190, 290, 20, 30, function(err, data) {
+						if (err) return done(err);
+						assert.instanceOf(data, Uint8Array);
+						assert.equal(data.length, 20*30);
+						for (var i = 0; i < data.length; i++) {
+							assert.equal(data[i], expected[i]);
+						}
+						done();
+					});
+				});
+				it('should read data into existing array', function(done) {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var data = new Uint8Array(20*30);
+					band.pixels.readAsync(190, 290, 20, 30, data, function(err, result) {
+						if (err) return done(err);
+						assert.equal(result, data);
+						done();
+					});
+				});
+				it('should handle concurrent reads on the same dataset', function(done) {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var remaining = 10;
+					for (var i = 0; i < 10; i++) {
+						band.pixels.readAsync(0, i * 10, 64, 10, function(err, data) {
+							if (err) return done(err);
+							assert.equal(data.length, 64*10);
+							if (--remaining === 0) done();
+						});
+					}
+				});
+				it('should pass an error to the callback if region is out of bounds', function(done) {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					band.pixels.readAsync(2000, 2000, 16, 16, function(err, data) {
+						assert.instanceOf(err, Error);
+						done();
+					});
+				});
+				it('should throw error if dataset already closed', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					ds.close();
+					assert.throws(function(){
+						band.pixels.readAsync(0, 0, 16, 16, function(){});
+					});
+				});
+			});
+			describe('writeAsync()', function() {
+				it('should write data from TypedArray', function(done) {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					var data = new Uint8Array(16*16);
+					for (var i = 0; i < data.length; i++) data[i] = i;
+					band.pixels.writeAsync(0, 0, 16, 16, data, function(err) {
+						if (err) return done(err);
+						var result = band.pixels.read(0, 0, 16, 16);
+						for (var i = 0; i < data.length; i++) {
+							assert.equal(result[i], data[i]);
+						}
+						done();
+					});
+				});
+				it('should throw error if array is too small', function() {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					var data = new Uint8Array(16*15);
+					assert.throws(function(){
+						band.pixels.writeAsync(0, 0, 16, 16, data, function(){});
+					});
+				});
+			});
 			describe('readBlock()', function() {
 				it('should return TypedArray', function() {
 					var ds   = gdal.open(__dirname + '/data/sample.tif');
@@ -878,6 +956,95 @@ describe('gdal.RasterBand', function() {
 					});
 				});
 			});
+			describe('blocks()', function() {
+				var createTiled = function() {
+					var driver = gdal.drivers.get('GTiff');
+					var ds = driver.create('/vsimem/blocks.tif', 20, 20, 1, gdal.GDT_Byte, ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16']);
+					var band = ds.bands.get(1);
+					var data = new Uint8Array(20 * 20);
+					for (var i = 0; i < data.length; i++) data[i] = i % 256;
+					band.pixels.write(0, 0, 20, 20, data);
+					return ds;
+				};
+				it('should visit every block in row-major order', function() {
+					var ds   = createTiled();
+					var band = ds.bands.get(1);
+					var blocks = band.pixels.blocks();
+					assert.equal(blocks.count(), 4);
+
+					var visited = [];
+					blocks.forEach(function(block) {
+						visited.push([block.bx, block.by, block.width, block.height]);
+					});
+					assert.deepEqual(visited, [[0, 0, 16, 16], [1, 0, 4, 16], [0, 1, 16, 4], [1, 1, 4, 4]]);
+					assert.isNull(blocks.next());
+				});
+				it('should pack clipped edge blocks', function() {
+					var ds   = createTiled();
+					var band = ds.bands.get(1);
+					var blocks = band.pixels.blocks();
+					blocks.next();
+					var block = blocks.next();
+					var expected = band.pixels.read(16, 0, 4, 16);
+					for (var i = 0; i < expected.length; i++) {
+						assert.equal(block.data[i], expected[i]);
+					}
+				});
+				it('should cycle through the given pool', function() {
+					var ds   = createTiled();
+					var band = ds.bands.get(1);
+					var pool = [new Uint8Array(256), new Uint8Array(256)];
+					var blocks = band.pixels.blocks(pool);
+					assert.equal(blocks.next().data, pool[0]);
+					assert.equal(blocks.next().data, pool[1]);
+					assert.equal(blocks.next().data, pool[0]);
+				});
+				it('should keep its own copy of the pool', function() {
+					var ds   = createTiled();
+					var band = ds.bands.get(1);
+					var array = new Uint8Array(256);
+					var pool = [array];
+					var blocks = band.pixels.blocks(pool);
+					pool.length = 0;
+					assert.equal(blocks.next().data, array);
+					pool.push('not an array');
+					assert.equal(blocks.next().data, array);
+				});
+				it('should restart after reset()', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var blocks = ds.bands.get(1).pixels.blocks();
+					var first = blocks.next();
+					blocks.next();
+					blocks.reset();
+					var block = blocks.next();
+					assert.equal(block.bx, first.bx);
+					assert.equal(block.by, first.by);
+				});
+				it('should throw error if pool array is not the right type', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var pool = [new Float64Array(band.blockSize.x * band.blockSize.y)];
+					assert.throws(function(){
+						band.pixels.blocks(pool);
+					});
+				});
+				it('should throw error if pool array is not big enough', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var pool = [new Uint8Array(band.blockSize.x * band.blockSize.y - 1)];
+					assert.throws(function(){
+						band.pixels.blocks(pool);
+					});
+				});
+				it('should throw error if dataset already closed', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var blocks = ds.bands.get(1).pixels.blocks();
+					ds.close();
+					assert.throws(function(){
+						blocks.next();
+					});
+				});
+			});
 		});
 		describe('"overviews" property', function() {
 			describe('getter', function() {
@@ -977,5 +1144,148 @@ describe('gdal.RasterBand', function() {
 				});
 			});
 		});
+		describe('computeStatisticsAsync()', function() {
+			it('should match computeStatistics() when reduced across threads', function(done) {
+				var ds = gdal.open(__dirname + '/data/sample.tif');
+				var band = ds.bands.get(1);
+				var expected = band.computeStatistics(false);
+				band.computeStatisticsAsync(false, {threads: 4}, function(err, stats) {
+					if (err) return done(err);
+					assert.equal(stats.min, expected.min);
+					assert.equal(stats.max, expected.max);
+					assert.closeTo(stats.mean, expected.mean, 1e-9);
+					assert.closeTo(stats.std_dev, expected.std_dev, 1e-9);
+					done();
+				});
+			});
+			it('should ignore nodata pixels of in-memory bands', function(done) {
+				var ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Float32);
+				var band = ds.bands.get(1);
+				band.pixels.write(0, 0, 4, 1, new Float32Array([1, 2, 3, -1]));
+				band.noDataValue = -1;
+				band.computeStatisticsAsync(false, function(err, stats) {
+					if (err) return done(err);
+					assert.equal(stats.min, 1);
+					assert.equal(stats.max, 3);
+					assert.equal(stats.mean, 2);
+					done();
+				});
+			});
+			it('should keep the standard deviation of values with a large offset', function(done) {
+				var ds = gdal.open('temp', 'w', 'MEM', 4, 1, 1, gdal.GDT_Float64);
+				var band = ds.bands.get(1);
+				band.pixels.write(0, 0, 4, 1, new Float64Array([1e9, 1e9 + 1, 1e9 + 2, 1e9 + 3]));
+				band.computeStatisticsAsync(false, function(err, stats) {
+					if (err) return done(err);
+					assert.equal(stats.mean, 1e9 + 1.5);
+					assert.closeTo(stats.std_dev, Math.sqrt(1.25), 1e-9);
+					done();
+				});
+			});
+			it('should pass an error to the callback if a VRT source is missing', function(done) {
+				var ds = gdal.open(__dirname + '/data/sample_vrt_missing_source.vrt');
+				ds.bands.get(1).computeStatisticsAsync(false, function(err) {
+					assert.instanceOf(err, Error);
+					done();
+				});
+			});
+		});
+		describe('getHistogram()', function() {
+			var createBand = function(type, values) {
+				var ds = gdal.open('temp', 'w', 'MEM', 4, 2, 1, type);
+				var band = ds.bands.get(1);
+				var data = type === gdal.GDT_Byte ? new Uint8Array(values) : type === gdal.GDT_UInt16 ? new Uint16Array(values) : new Int16Array(values);
+				band.pixels.write(0, 0, 4, 2, data);
+				return band;
+			};
+			it('should count Byte values in 256 buckets by default', function() {
+				var band = createBand(gdal.GDT_Byte, [0, 1, 1, 2, 255, 255, 255, 7]);
+				var histogram = band.getHistogram();
+				assert.lengthOf(histogram, 256);
+				assert.equal(histogram[0], 1);
+				assert.equal(histogram[1], 2);
+				assert.equal(histogram[7], 1);
+				assert.equal(histogram[255], 3);
+			});
+			it('should not count nodata pixels', function() {
+				var band = createBand(gdal.GDT_Byte, [0, 1, 1, 2, 255, 255, 255, 7]);
+				band.noDataValue = 255;
+				assert.equal(band.getHistogram()[255], 0);
+			});
+			it('should match the generic implementation for UInt16 bands', function() {
+				var values = [0, 100, 200, 300, 400, 1000, 1500, 60000];
+				var options = {min: 0, max: 1000, buckets: 10};
+				var fast = createBand(gdal.GDT_UInt16, values).getHistogram(options);
+				var generic = createBand(gdal.GDT_Int16, values.slice(0, 7).concat([2000])).getHistogram(options);
+				assert.deepEqual(fast, generic);
+				assert.deepEqual(fast, [1, 1, 1, 1, 1, 0, 0, 0, 0, 0]);
+			});
+			it('should count out of range values if includeOutOfRange is set', function() {
+				var band = createBand(gdal.GDT_UInt16, [0, 100, 200, 300, 400, 1000, 1500, 60000]);
+				var histogram = band.getHistogram({min: 0, max: 1000, buckets: 10, includeOutOfRange: true});
+				assert.equal(histogram[9], 3);
+			});
+			it('should count every pixel of a constant band', function() {
+				var band = createBand(gdal.GDT_UInt16, [5, 5, 5, 5, 5, 5, 5, 5]);
+				var histogram = band.getHistogram();
+				assert.lengthOf(histogram, 256);
+				assert.equal(histogram.reduce(function(a, b) { return a + b; }, 0), 8);
+			});
+			it('should throw if only min is given', function() {
+				var band = createBand(gdal.GDT_Byte, [0, 0, 0, 0, 0, 0, 0, 0]);
+				assert.throws(function() {
+					band.getHistogram({min: 0});
+				}, /min and max/);
+			});
+			it('should allow the progress callback to access the dataset', function() {
+				var band = createBand(gdal.GDT_Byte, [0, 1, 1, 2, 255, 255, 255, 7]);
+				var values = [];
+				band.getHistogram({progress: function() {
+					values.push(band.pixels.get(1, 0));
+					values.push(band.ds.bands.count());
+				}});
+				assert.isAbove(values.length, 0);
+				assert.equal(values[0], 1);
+				assert.equal(values[1], 1);
+			});
+			it('should not let the progress callback close the dataset', function() {
+				var band = createBand(gdal.GDT_Byte, [0, 1, 1, 2, 255, 255, 255, 7]);
+				var ds = band.ds;
+				assert.throws(function() {
+					band.getHistogram({progress: function() {
+						ds.close();
+					}});
+				}, /in use/);
+				assert.equal(band.pixels.get(1, 0), 1);
+			});
+		});
+		describe('getHistogramAsync()', function() {
+			it('should scan the band on the thread pool', function(done) {
+				var ds = gdal.open(__dirname + '/data/sample.tif');
+				var band = ds.bands.get(1);
+				var expected = band.getHistogram();
+				band.getHistogramAsync(function(err, histogram) {
+					if (err) return done(err);
+					assert.deepEqual(histogram, expected);
+					done();
+				});
+			});
+		});
+		describe('getDefaultHistogram() / setDefaultHistogram()', function() {
+			it('should store and return the default histogram', function() {
+				var ds = gdal.open(fileUtils.clone(__dirname + '/data/sample.tif'));
+				var band = ds.bands.get(1);
+				band.setDefaultHistogram(0, 10, [1, 2, 3]);
+				var result = band.getDefaultHistogram(false);
+				assert.equal(result.min, 0);
+				assert.equal(result.max, 10);
+				assert.deepEqual(result.histogram, [1, 2, 3]);
+			});
+			it('should compute a histogram if forced', function() {
+				var ds = gdal.open(__dirname + '/data/sample.tif');
+				var result = ds.bands.get(1).getDefaultHistogram();
+				assert.lengthOf(result.histogram, 256);
+			});
+		});
 	});
 });
\ No newline at end of file
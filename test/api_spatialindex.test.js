@@ -0,0 +1,190 @@
+'use strict';
+
+var assert = require('chai').assert;
+var gdal = require('../lib/gdal.js');
+
+describe('gdal.SpatialIndex', function() {
+	afterEach(gc);
+
+	var toArray = function(typed) {
+		return Array.prototype.slice.call(typed);
+	};
+
+	//a 10x10 grid of unit boxes, id = y * 10 + x
+	var gridBoxes = function() {
+		var boxes = new Float64Array(400);
+		for (var i = 0; i < 100; i++) {
+			var x = i % 10, y = Math.floor(i / 10);
+			boxes.set([x, y, x + 0.5, y + 0.5], i * 4);
+		}
+		return boxes;
+	};
+
+	it('should be instantiable', function() {
+		assert.instanceOf(new gdal.SpatialIndex(), gdal.SpatialIndex);
+		assert.instanceOf(new gdal.SpatialIndex({nodeSize: 4}), gdal.SpatialIndex);
+	});
+	it('should throw for an invalid node size', function() {
+		assert.throws(function() {
+			new gdal.SpatialIndex({nodeSize: 1});
+		}, /nodeSize/);
+	});
+	describe('instance', function() {
+		describe('insert()', function() {
+			it('should accept envelopes and geometries', function() {
+				var index = new gdal.SpatialIndex();
+				index.insert(7, {minX: 0, minY: 0, maxX: 1, maxY: 1});
+				index.insert(9, gdal.Geometry.fromWKT('POINT (5 5)'));
+				assert.equal(index.count(), 2);
+				assert.deepEqual(toArray(index.query({minX: 4, minY: 4, maxX: 6, maxY: 6})), [9]);
+			});
+			it('should throw for an invalid envelope', function() {
+				var index = new gdal.SpatialIndex();
+				assert.throws(function() {
+					index.insert(1, {minX: 1, minY: 0, maxX: 0, maxY: 1});
+				}, /envelope/);
+				assert.throws(function() {
+					index.insert(1, {minX: 0});
+				}, /envelope/);
+				assert.throws(function() {
+					index.insert(1, {minX: NaN, minY: 0, maxX: 1, maxY: 1});
+				}, /NaN/);
+				assert.throws(function() {
+					index.query({minX: 0, minY: 0, maxX: NaN, maxY: 1});
+				}, /NaN/);
+			});
+		});
+		describe('bulkLoad()', function() {
+			it('should load boxes with default ids', function() {
+				var index = new gdal.SpatialIndex({nodeSize: 4});
+				index.bulkLoad(gridBoxes());
+				assert.equal(index.count(), 100);
+				assert.deepEqual(toArray(index.query({minX: 2.2, minY: 3.2, maxX: 4, maxY: 4})), [33, 34, 43, 44]);
+			});
+			it('should use the given ids and skip NaN boxes', function() {
+				var index = new gdal.SpatialIndex();
+				index.bulkLoad(new Float64Array([0, 0, 1, 1, NaN, NaN, NaN, NaN, 2, 2, 3, 3]), new Int32Array([10, 11, 12]));
+				assert.equal(index.count(), 2);
+				assert.deepEqual(toArray(index.query({minX: 0, minY: 0, maxX: 5, maxY: 5})), [10, 12]);
+			});
+			it('should load a GeometryArray', function() {
+				var index = new gdal.SpatialIndex();
+				index.bulkLoad(gdal.Geometry.fromWKTMany(['POINT (1 1)', null, 'POINT (3 3)']));
+				assert.equal(index.count(), 2);
+				assert.deepEqual(toArray(index.query({minX: 2, minY: 2, maxX: 4, maxY: 4})), [2]);
+			});
+			it('should throw for mismatched ids', function() {
+				assert.throws(function() {
+					new gdal.SpatialIndex().bulkLoad(new Float64Array(8), new Int32Array(3));
+				}, /ids/);
+			});
+		});
+		describe('query()', function() {
+			it('should return an empty array for an empty index', function() {
+				var result = new gdal.SpatialIndex().query({minX: 0, minY: 0, maxX: 1, maxY: 1});
+				assert.instanceOf(result, Int32Array);
+				assert.lengthOf(result, 0);
+			});
+			it('should see items inserted after a query', function() {
+				var index = new gdal.SpatialIndex();
+				index.bulkLoad(gridBoxes());
+				index.query({minX: 0, minY: 0, maxX: 1, maxY: 1});
+				index.insert(1000, {minX: 0.7, minY: 0.7, maxX: 0.8, maxY: 0.8});
+				assert.deepEqual(toArray(index.query({minX: 0.6, minY: 0.6, maxX: 0.9, maxY: 0.9})), [1000]);
+			});
+		});
+		describe('queryGeometry()', function() {
+			it('should refine candidates with the predicate', function() {
+				var index = new gdal.SpatialIndex();
+				index.bulkLoad(gdal.Geometry.fromWKTMany([
+					'POINT (1 1)',
+					'POINT (8 1)',
+					'LINESTRING (5 5,20 20)' //touches the hypotenuse
+				]));
+				var triangle = gdal.Geometry.fromWKT('POLYGON ((0 0,10 0,0 10,0 0))');
+				assert.deepEqual(toArray(index.queryGeometry(triangle)), [0, 1, 2]);
+				assert.deepEqual(toArray(index.queryGeometry(triangle, 'contains')), [0, 1]);
+			});
+			it('should test envelope items as boxes', function() {
+				var index = new gdal.SpatialIndex();
+				index.insert(1, {minX: 8, minY: 8, maxX: 9, maxY: 9});
+				index.insert(2, {minX: 1, minY: 1, maxX: 2, maxY: 2});
+				var triangle = gdal.Geometry.fromWKT('POLYGON ((0 0,10 0,0 10,0 0))');
+				assert.deepEqual(toArray(index.queryGeometry(triangle)), [2]);
+			});
+			it('should throw for an unknown predicate', function() {
+				assert.throws(function() {
+					new gdal.SpatialIndex().queryGeometry(gdal.Geometry.fromWKT('POINT (0 0)'), 'touches');
+				}, /predicate/);
+			});
+		});
+		describe('nearest()', function() {
+			it('should return the k closest items, closest first', function() {
+				var index = new gdal.SpatialIndex({nodeSize: 4});
+				index.bulkLoad(gridBoxes());
+				assert.deepEqual(toArray(index.nearest(4.6, 4.6)), [44]);
+				assert.deepEqual(toArray(index.nearest(0, 0, 3)).sort(), [0, 1, 10].sort());
+				assert.lengthOf(index.nearest(0, 0, 1000), 100);
+			});
+			it('should use the exact distance of geometries', function() {
+				var index = new gdal.SpatialIndex();
+				//the diagonal line's box contains the query point, but the point is closer
+				index.insert(1, gdal.Geometry.fromWKT('LINESTRING (0 0,10 10)'));
+				index.insert(2, gdal.Geometry.fromWKT('POINT (9 2)'));
+				assert.deepEqual(toArray(index.nearest(9, 1)), [2]);
+			});
+		});
+		describe('toBuffer()', function() {
+			it('should round-trip through SpatialIndex.fromBuffer()', function() {
+				var index = new gdal.SpatialIndex({nodeSize: 4});
+				index.bulkLoad(gridBoxes());
+				index.insert(500, gdal.Geometry.fromWKT('LINESTRING (0 0,10 10)'));
+
+				var buffer = index.toBuffer();
+				assert.instanceOf(buffer, Buffer);
+				var restored = gdal.SpatialIndex.fromBuffer(buffer);
+				assert.equal(restored.count(), 101);
+
+				var envelope = {minX: 2.2, minY: 3.2, maxX: 4, maxY: 4};
+				assert.deepEqual(toArray(restored.query(envelope)), toArray(index.query(envelope)));
+				assert.deepEqual(toArray(restored.nearest(9, 1, 5)), toArray(index.nearest(9, 1, 5)));
+
+				restored.insert(501, {minX: 20, minY: 20, maxX: 21, maxY: 21});
+				assert.deepEqual(toArray(restored.query({minX: 19, minY: 19, maxX: 22, maxY: 22})), [501]);
+			});
+			it('should round-trip an empty index', function() {
+				var restored = gdal.SpatialIndex.fromBuffer(new gdal.SpatialIndex().toBuffer());
+				assert.equal(restored.count(), 0);
+			});
+			it('should reject invalid buffers', function() {
+				assert.throws(function() {
+					gdal.SpatialIndex.fromBuffer(new Buffer('not an index'));
+				}, /SpatialIndex/);
+				var buffer = new gdal.SpatialIndex().toBuffer();
+				assert.throws(function() {
+					gdal.SpatialIndex.fromBuffer(buffer.slice(0, buffer.length - 2));
+				}, /truncated/);
+			});
+			it('should reject a corrupt tree', function() {
+				var index = new gdal.SpatialIndex();
+				index.insert(1, {minX: 0, minY: 0, maxX: 1, maxY: 1});
+				index.insert(2, {minX: 2, minY: 2, maxX: 3, maxY: 3});
+				var buffer = index.toBuffer(); //2 leaves + the root
+
+				var no_levels = new Buffer(buffer.length);
+				buffer.copy(no_levels);
+				no_levels.writeUInt32LE(0, 20); //level count
+				assert.throws(function() {
+					gdal.SpatialIndex.fromBuffer(no_levels);
+				}, /Corrupt/);
+
+				var duplicate_leaf = new Buffer(buffer.length);
+				buffer.copy(duplicate_leaf);
+				duplicate_leaf.writeInt32LE(duplicate_leaf.readInt32LE(24 + 3 * 32), 24 + 3 * 32 + 4);
+				assert.throws(function() {
+					gdal.SpatialIndex.fromBuffer(duplicate_leaf);
+				}, /Corrupt/);
+			});
+		});
+	});
+});
@@ -0,0 +1,126 @@
+'use strict';
+
+var gdal = require('../lib/gdal.js');
+var assert = require('chai').assert;
+
+describe('gdal', function() {
+	afterEach(gc);
+
+	var wgs84 = gdal.SpatialReference.fromEPSG(4326);
+
+	var createSource = function() {
+		var ds = gdal.open('temp', 'w', 'MEM', 8, 8, 1, gdal.GDT_Byte);
+		ds.srs = wgs84;
+		ds.geoTransform = [0, 1, 0, 8, 0, -1];
+		ds.bands.get(1).fill(7);
+		return ds;
+	};
+	var createDestination = function() {
+		var ds = gdal.open('temp', 'w', 'MEM', 4, 4, 1, gdal.GDT_Byte);
+		ds.srs = wgs84;
+		ds.geoTransform = [0, 2, 0, 8, 0, -2];
+		return ds;
+	};
+	var readAll = function(ds) {
+		return Array.prototype.slice.call(ds.bands.get(1).pixels.read(0, 0, ds.rasterSize.x, ds.rasterSize.y));
+	};
+
+	describe('reprojectImage()', function() {
+		it('should warp the source into the destination', function() {
+			var src = createSource();
+			var dst = createDestination();
+			gdal.reprojectImage({src: src, dst: dst, resampling: 'average', memoryLimit: 1024 * 1024});
+			readAll(dst).forEach(function(value) {
+				assert.equal(value, 7);
+			});
+		});
+		it('should support multithreading', function() {
+			var src = createSource();
+			var dst = createDestination();
+			gdal.reprojectImage({src: src, dst: dst, multithread: true, threads: 2});
+			readAll(dst).forEach(function(value) {
+				assert.equal(value, 7);
+			});
+		});
+		it('should only write inside the cutline', function() {
+			var src = createSource();
+			var dst = createDestination();
+			var cutline = gdal.Geometry.fromWKT('POLYGON ((0 4,4 4,4 8,0 8,0 4))');
+			gdal.reprojectImage({src: src, dst: dst, cutline: cutline, dstNodata: 0});
+
+			var data = readAll(dst);
+			assert.equal(data[0], 7);
+			assert.equal(data[15], 0);
+		});
+		it('should report progress', function() {
+			var src = createSource();
+			var dst = createDestination();
+			var calls = [];
+			gdal.reprojectImage({src: src, dst: dst, progress: function(complete) {
+				calls.push(complete);
+			}});
+			assert.isAbove(calls.length, 0);
+			assert.equal(calls[calls.length - 1], 1);
+		});
+		it('should report progress when multithreaded', function() {
+			var src = createSource();
+			var dst = createDestination();
+			var calls = [];
+			gdal.reprojectImage({src: src, dst: dst, multithread: true, progress: function(complete) {
+				calls.push(complete);
+			}});
+			assert.isAbove(calls.length, 0);
+			readAll(dst).forEach(function(value) {
+				assert.equal(value, 7);
+			});
+		});
+		it('should cancel if progress returns false', function() {
+			var src = createSource();
+			var dst = createDestination();
+			assert.throws(function() {
+				gdal.reprojectImage({src: src, dst: dst, progress: function() {
+					return false;
+				}});
+			});
+		});
+		it('should throw if band lists do not match', function() {
+			var src = createSource();
+			var dst = createDestination();
+			assert.throws(function() {
+				gdal.reprojectImage({src: src, dst: dst, srcBands: [1], dstBands: [1, 1]});
+			}, /same length/);
+		});
+		it('should throw if resampling is invalid', function() {
+			var src = createSource();
+			var dst = createDestination();
+			assert.throws(function() {
+				gdal.reprojectImage({src: src, dst: dst, resampling: 'bogus'});
+			}, /resampling/);
+		});
+		it('should throw if a dataset is closed', function() {
+			var src = createSource();
+			var dst = createDestination();
+			src.close();
+			assert.throws(function() {
+				gdal.reprojectImage({src: src, dst: dst});
+			}, /already been destroyed/);
+		});
+	});
+	describe('reprojectImageAsync()', function() {
+		it('should warp on the thread pool', function(done) {
+			var src = createSource();
+			var dst = createDestination();
+			var progress = 0;
+			gdal.reprojectImageAsync({src: src, dst: dst, progress: function(complete) {
+				progress = complete;
+			}}, function(err) {
+				if (err) return done(err);
+				readAll(dst).forEach(function(value) {
+					assert.equal(value, 7);
+				});
+				assert.equal(progress, 1);
+				done();
+			});
+		});
+	});
+});